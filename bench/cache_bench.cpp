@@ -0,0 +1,180 @@
+#include <benchmark/benchmark.h>
+#include "lru_cache.h"
+#include "lfu_cache.h"
+#include "bus.h"
+#include "workload.h"
+#include "cache_simulator.h"
+
+using namespace cache_sim;
+
+namespace
+{
+    // 每次迭代执行的访问数
+    const size_t kBatch = 4096;
+
+    // 以每秒访问次数报告吞吐量
+    void setAccessRate(benchmark::State &state, size_t per_iteration)
+    {
+        state.counters["accesses/s"] = benchmark::Counter(static_cast<double>(state.iterations() * per_iteration),
+                                                          benchmark::Counter::kIsRate);
+    }
+
+    // 命中：工作集为缓存容量的一半，预热后每次访问都命中
+    std::vector<uint64_t> hitAddresses(const CacheConfig &config)
+    {
+        std::vector<uint64_t> addresses(kBatch);
+        size_t range = config.cache_size / 2;
+        for (size_t i = 0; i < kBatch; ++i)
+        {
+            addresses[i] = (i * 8 * 37) % range;
+        }
+        return addresses;
+    }
+
+    // 缺失：以块为步长循环扫描 8 倍容量，LRU 下每次访问都缺失
+    std::vector<uint64_t> missAddresses(const CacheConfig &config)
+    {
+        std::vector<uint64_t> addresses(kBatch);
+        size_t blocks = config.cache_size * 8 / config.block_size;
+        for (size_t i = 0; i < kBatch; ++i)
+        {
+            addresses[i] = (i % blocks) * config.block_size;
+        }
+        return addresses;
+    }
+
+    template <bool Write, bool Hit>
+    void BM_CacheAccess(benchmark::State &state)
+    {
+        CacheConfig config;
+        LRUCache cache(config);
+        std::vector<uint64_t> addresses = Hit ? hitAddresses(config) : missAddresses(config);
+        for (uint64_t address : addresses)
+        {
+            cache.read(address);
+        }
+
+        for (auto _ : state)
+        {
+            for (uint64_t address : addresses)
+            {
+                bool hit = Write ? cache.write(address, 1) : cache.read(address);
+                benchmark::DoNotOptimize(hit);
+            }
+        }
+        setAccessRate(state, kBatch);
+    }
+
+    // 替换策略：单组缓存，每次迭代按轮转顺序更新组内每一行的访问信息
+    template <typename CacheType>
+    void BM_UpdateAccessInfo(benchmark::State &state)
+    {
+        size_t assoc = static_cast<size_t>(state.range(0));
+        CacheConfig config(64 * assoc, 64, assoc);
+        CacheType cache(config);
+        std::vector<CacheLine *> lines;
+        for (size_t way = 0; way < assoc; ++way)
+        {
+            cache.read(way * 64);
+            lines.push_back(cache.findLine(way * 64));
+        }
+
+        for (auto _ : state)
+        {
+            for (CacheLine *line : lines)
+            {
+                cache.updateAccessInfo(0, line);
+            }
+            benchmark::ClobberMemory();
+        }
+        setAccessRate(state, assoc);
+    }
+
+    // 替换策略：在装满的单组中选择受害者
+    template <typename CacheType>
+    void BM_SelectVictim(benchmark::State &state)
+    {
+        size_t assoc = static_cast<size_t>(state.range(0));
+        CacheConfig config(64 * assoc, 64, assoc);
+        CacheType cache(config);
+        for (size_t way = 0; way < assoc; ++way)
+        {
+            cache.read(way * 64);
+        }
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(cache.selectVictim(0));
+        }
+        setAccessRate(state, 1);
+    }
+
+    // 总线：核心 0 对其他核心共享的块广播 BusRd，嗅探开销随核心数增长
+    void BM_BusBroadcast(benchmark::State &state)
+    {
+        size_t cores = static_cast<size_t>(state.range(0));
+        CacheConfig config;
+        Bus bus;
+        std::vector<std::unique_ptr<LRUCache>> caches;
+        for (size_t i = 0; i < cores; ++i)
+        {
+            caches.push_back(std::make_unique<LRUCache>(config, static_cast<int>(i), &bus));
+            bus.attach(caches.back().get());
+        }
+        std::vector<uint64_t> addresses = hitAddresses(config);
+        for (auto &cache : caches)
+        {
+            for (uint64_t address : addresses)
+            {
+                cache->read(address);
+            }
+        }
+
+        for (auto _ : state)
+        {
+            for (uint64_t address : addresses)
+            {
+                benchmark::DoNotOptimize(bus.broadcast(0, address, BusEvent::BusRd));
+            }
+        }
+        setAccessRate(state, kBatch);
+    }
+
+    // 访问流：每种访问模式的地址生成速度（4 核中的核心 0）
+    void BM_WorkloadNext(benchmark::State &state)
+    {
+        CoreWorkload workload;
+        workload.pattern = static_cast<AccessPattern>(state.range(0));
+        WorkloadStream stream(workload, 64, 0, 4, 1);
+        state.SetLabel(CacheSimulator::getPatterName(workload.pattern));
+
+        uint64_t address = 0;
+        bool is_write = false;
+        for (auto _ : state)
+        {
+            for (size_t i = 0; i < kBatch; ++i)
+            {
+                stream.next(address, is_write);
+                benchmark::DoNotOptimize(address);
+                benchmark::DoNotOptimize(is_write);
+            }
+        }
+        setAccessRate(state, kBatch);
+    }
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_CacheAccess, false, true)->Name("Cache/ReadHit");
+BENCHMARK_TEMPLATE(BM_CacheAccess, false, false)->Name("Cache/ReadMiss");
+BENCHMARK_TEMPLATE(BM_CacheAccess, true, true)->Name("Cache/WriteHit");
+BENCHMARK_TEMPLATE(BM_CacheAccess, true, false)->Name("Cache/WriteMiss");
+
+BENCHMARK_TEMPLATE(BM_UpdateAccessInfo, LRUCache)->Name("LRU/UpdateAccessInfo")->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_UpdateAccessInfo, LFUCache)->Name("LFU/UpdateAccessInfo")->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_SelectVictim, LRUCache)->Name("LRU/SelectVictim")->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_SelectVictim, LFUCache)->Name("LFU/SelectVictim")->RangeMultiplier(2)->Range(1, 64);
+
+BENCHMARK(BM_BusBroadcast)->Name("Bus/Broadcast")->RangeMultiplier(2)->Range(1, 64);
+
+BENCHMARK(BM_WorkloadNext)->Name("Workload/Next")->DenseRange(static_cast<int>(AccessPattern::Random), static_cast<int>(AccessPattern::Latest));
+
+BENCHMARK_MAIN();
@@ -7,12 +7,76 @@ namespace cache_sim
 {
 
     class Cache;
+    class SharingDetector;
+    class MemoryController;
+    class Interconnect;
 
     // 总线事件类型
     enum class BusEvent
     {
-        BusRd,  // 读请求：请求读取数据块，不打算修改
-        BusRdX, // 独占读请求：请求读取数据块，打算修改
+        BusRd,   // 读请求：请求读取数据块，不打算修改
+        BusRdX,  // 独占读请求：请求读取数据块，打算修改
+        BusUpgr, // 升级请求：已持有共享副本，只需使其他副本失效
+    };
+
+    // 单个缓存对总线请求的嗅探结果
+    struct SnoopResult
+    {
+        bool has_copy;    // 嗅探前持有该数据块
+        bool supplied;    // 由本缓存直接提供数据（缓存间传输）
+        bool flushed;     // 将脏数据写回了主存
+        bool invalidated; // 本地副本被作废
+
+        SnoopResult() : has_copy(false), supplied(false), flushed(false), invalidated(false) {}
+
+        // 合并另一份嗅探结果
+        SnoopResult &operator|=(const SnoopResult &other)
+        {
+            has_copy = has_copy || other.has_copy;
+            supplied = supplied || other.supplied;
+            flushed = flushed || other.flushed;
+            invalidated = invalidated || other.invalidated;
+            return *this;
+        }
+    };
+
+    // 总线请求的响应
+    struct BusResponse
+    {
+        bool shared;   // 有其他缓存持有该数据块
+        bool supplied; // 数据由其他缓存提供（否则来自主存）
+
+        BusResponse() : shared(false), supplied(false) {}
+    };
+
+    // 总线流量统计
+    struct BusStats
+    {
+        uint64_t bus_rd;         // BusRd 请求次数
+        uint64_t bus_rdx;        // BusRdX 请求次数
+        uint64_t bus_upgr;       // BusUpgr 请求次数
+        uint64_t flushes;        // 嗅探时将脏数据写回主存的次数
+        uint64_t cache_to_cache; // 缓存间数据传输次数
+        uint64_t invalidations;  // 被作废的副本数
+        uint64_t memory_reads;   // 由主存提供数据的请求次数
+
+        BusStats() : bus_rd(0), bus_rdx(0), bus_upgr(0), flushes(0), cache_to_cache(0), invalidations(0), memory_reads(0) {}
+
+        // 总线事务总数
+        uint64_t transactions() const { return bus_rd + bus_rdx + bus_upgr; }
+
+        // 累加另一条总线的统计
+        BusStats &operator+=(const BusStats &other)
+        {
+            bus_rd += other.bus_rd;
+            bus_rdx += other.bus_rdx;
+            bus_upgr += other.bus_upgr;
+            flushes += other.flushes;
+            cache_to_cache += other.cache_to_cache;
+            invalidations += other.invalidations;
+            memory_reads += other.memory_reads;
+            return *this;
+        }
     };
 
     // 总线类，负责连接所有缓存并广播请求
@@ -26,11 +90,44 @@ namespace cache_sim
         // sender_id: 发起请求的缓存ID
         // address: 请求的地址
         // event: 请求类型
-        // 返回 true 表示有其他缓存拥有该数据
-        bool broadcast(int sender_id, uint64_t address, BusEvent event);
+        // 返回其他缓存的汇总响应
+        BusResponse broadcast(int sender_id, uint64_t address, BusEvent event);
+
+        // 获取总线流量统计
+        const BusStats &getStats() const { return stats_; }
+
+        // 重置统计信息
+        void resetStats() { stats_ = BusStats(); }
+
+        // 设置共享检测器，写请求作废其他副本时通知检测器
+        void setSharingDetector(SharingDetector *detector) { sharing_detector_ = detector; }
+
+        // 设置内存控制器，由主存提供数据的请求与写往主存的块交给它调度
+        void setMemory(MemoryController *memory) { memory_ = memory; }
+
+        // 将一个块写往主存（写回、直写或写缓冲排空）
+        void writeMemory(uint64_t address);
+
+        // 连接插槽间互连，本总线是第 socket 个插槽的总线
+        void setInterconnect(Interconnect *interconnect, size_t socket)
+        {
+            interconnect_ = interconnect;
+            socket_ = socket;
+        }
+
+        // 由互连转发的其他插槽的请求：嗅探本总线上的全部缓存，不计为本总线的请求
+        BusResponse snoopRemote(int sender_id, uint64_t address, BusEvent event);
 
     private:
         std::vector<Cache *> caches_;
+        BusStats stats_;
+        SharingDetector *sharing_detector_ = nullptr;
+        MemoryController *memory_ = nullptr;
+        Interconnect *interconnect_ = nullptr;
+        size_t socket_ = 0;
+
+        // 嗅探除 sender_id 以外的缓存并合并结果
+        void snoop(int sender_id, uint64_t address, BusEvent event, BusResponse &response);
     };
 
 } // namespace cache_sim
@@ -3,16 +3,61 @@
 
 #include "cache_line.h"
 #include "bus.h"
+#include "set_stats.h"
+#include "victim_cache.h"
+#include "write_buffer.h"
 #include <bits/stdc++.h>
 
 namespace cache_sim
 {
+    // 缓存替换策略
+    enum class ReplacementPolicy
+    {
+        LRU,
+        LFU
+    };
+
+    // 组索引函数
+    enum class IndexFunction
+    {
+        Modulo,      // 块地址对组数取模
+        XorFold,     // 将标签各段异或折叠到索引位（组数需为 2 的幂）
+        PrimeModulo, // 对不超过组数的最大素数取模
+        Skewed       // 斜相联：每一路使用不同的哈希函数（组数需为 2 的幂）
+    };
+
+    // 组采样方式（只模拟部分组以加速大缓存的近似模拟）
+    enum class SetSampling
+    {
+        None,   // 模拟所有组
+        Stride, // 每隔 sampling_ratio 组取一组
+        Hashed  // 按组号散列抽取约 1 / sampling_ratio 的组，避免与地址步长同步
+    };
+
+    // 写命中策略
+    enum class WritePolicy
+    {
+        WriteBack,   // 写回：写入只修改缓存行，驱逐脏行时写回主存
+        WriteThrough // 写直达：每次写入同时写往主存
+    };
+
     // 缓存配置
     struct CacheConfig
     {
         size_t cache_size;    // 缓存总大小（字节）
         size_t block_size;    // 块大小（字节）
         size_t associativity; // 关联度（1=直接映射, N=N路组相联）
+        IndexFunction index_function; // 组索引函数
+        size_t victim_cache_entries = 0; // 受害者缓存条目数（0 表示不启用）
+        VictimCacheMode victim_cache_mode = VictimCacheMode::Victim; // 受害者缓存工作模式
+        WritePolicy write_policy = WritePolicy::WriteBack; // 写命中策略
+        bool write_allocate = true;      // 写缺失时是否分配缓存行
+        size_t write_buffer_entries = 0; // 合并写缓冲条目数（0 表示直接写往主存）
+        CoherenceProtocol coherence_protocol = CoherenceProtocol::MESI; // 缓存一致性协议
+        SetSampling set_sampling = SetSampling::None; // 组采样方式
+        size_t sampling_ratio = 1;       // 组采样比例：约每 sampling_ratio 组模拟一组
+        size_t sector_size = 0;          // 扇区大小（字节，0 表示不分扇区）：每个标签对应 块大小 / 扇区大小 个扇区，
+                                         // 各扇区有独立的有效位与脏位，缺失时只取回所访问的扇区，写回时只写脏扇区
 
         CacheConfig()
             : cache_size(32768) // 默认 32KB
@@ -20,11 +65,13 @@ namespace cache_sim
               block_size(64) // 默认 64 字节
               ,
               associativity(4) // 默认 4 路组相联
+              ,
+              index_function(IndexFunction::Modulo)
         {
         }
 
-        CacheConfig(size_t c_size, size_t b_size, size_t assoc)
-            : cache_size(c_size), block_size(b_size), associativity(assoc)
+        CacheConfig(size_t c_size, size_t b_size, size_t assoc, IndexFunction index = IndexFunction::Modulo)
+            : cache_size(c_size), block_size(b_size), associativity(assoc), index_function(index)
         {
         }
     };
@@ -37,8 +84,25 @@ namespace cache_sim
         uint64_t reads;     // 读操作次数
         uint64_t writes;    // 写操作次数
         uint64_t conflicts; // 冲突次数
+        uint64_t evictions; // 驱逐有效行的次数
+        uint64_t writebacks;       // 写回主存的次数（脏行驱逐或嗅探时刷新）
+        uint64_t bus_transactions; // 本缓存发起的总线事务次数
+        uint64_t victim_hits;      // 缺失后在受害者缓存中命中的次数
+        uint64_t victim_swaps;     // 受害者缓存与 L1 交换缓存行的次数
+        uint64_t victim_absorbed_conflicts; // 受害者缓存吸收的冲突缺失次数
+        uint64_t dirty_evictions;    // 驱逐脏行的次数
+        uint64_t memory_writes;      // 写往主存的事务次数
+        uint64_t memory_write_bytes; // 写往主存的字节数
+        uint64_t write_buffer_coalesced; // 在写缓冲中合并的写入次数
+        uint64_t unsampled;          // 组采样时落在未采样组而被跳过的访问次数（不计入其他各项）
+        uint64_t foreign_evictions;  // 驱逐其他所有者装入的行的次数
+        uint64_t sector_misses;      // 标签命中但扇区无效的缺失（计入 misses）
+        uint64_t bytes_fetched;      // 缺失时取回的字节数
 
-        CacheStats() : hits(0), misses(0), reads(0), writes(0), conflicts(0) {}
+        CacheStats() : hits(0), misses(0), reads(0), writes(0), conflicts(0), evictions(0), writebacks(0), bus_transactions(0),
+                       victim_hits(0), victim_swaps(0), victim_absorbed_conflicts(0),
+                       dirty_evictions(0), memory_writes(0), memory_write_bytes(0), write_buffer_coalesced(0), unsampled(0),
+                       foreign_evictions(0), sector_misses(0), bytes_fetched(0) {}
 
         // 计算命中率
         double hitRate() const
@@ -47,12 +111,82 @@ namespace cache_sim
             return total > 0 ? static_cast<double>(hits) / total : 0.0;
         }
 
+        // 组采样时由样本外推到全部访问的比例（未采样时为 1）
+        double samplingScale() const
+        {
+            uint64_t sampled = reads + writes;
+            return sampled > 0 ? static_cast<double>(sampled + unsampled) / sampled : 1.0;
+        }
+
+        // 扇区缺失率与标签缺失率（两者之和为缺失率）
+        double sectorMissRate() const
+        {
+            uint64_t total = hits + misses;
+            return total > 0 ? static_cast<double>(sector_misses) / total : 0.0;
+        }
+
+        double tagMissRate() const
+        {
+            uint64_t total = hits + misses;
+            return total > 0 ? static_cast<double>(misses - sector_misses) / total : 0.0;
+        }
+
         // 计算冲突率
         double conflictRate() const
         {
             uint64_t total = hits + misses;
             return total > 0 ? static_cast<double>(conflicts) / total : 0.0;
         }
+
+        // 累加另一份统计
+        CacheStats &operator+=(const CacheStats &other)
+        {
+            hits += other.hits;
+            misses += other.misses;
+            reads += other.reads;
+            writes += other.writes;
+            conflicts += other.conflicts;
+            evictions += other.evictions;
+            writebacks += other.writebacks;
+            bus_transactions += other.bus_transactions;
+            victim_hits += other.victim_hits;
+            victim_swaps += other.victim_swaps;
+            victim_absorbed_conflicts += other.victim_absorbed_conflicts;
+            dirty_evictions += other.dirty_evictions;
+            memory_writes += other.memory_writes;
+            memory_write_bytes += other.memory_write_bytes;
+            write_buffer_coalesced += other.write_buffer_coalesced;
+            unsampled += other.unsampled;
+            foreign_evictions += other.foreign_evictions;
+            sector_misses += other.sector_misses;
+            bytes_fetched += other.bytes_fetched;
+            return *this;
+        }
+
+        // 各项除以 n（用于求平均）
+        CacheStats &operator/=(uint64_t n)
+        {
+            hits /= n;
+            misses /= n;
+            reads /= n;
+            writes /= n;
+            conflicts /= n;
+            evictions /= n;
+            writebacks /= n;
+            bus_transactions /= n;
+            victim_hits /= n;
+            victim_swaps /= n;
+            victim_absorbed_conflicts /= n;
+            dirty_evictions /= n;
+            memory_writes /= n;
+            memory_write_bytes /= n;
+            write_buffer_coalesced /= n;
+            unsampled /= n;
+            foreign_evictions /= n;
+            sector_misses /= n;
+            bytes_fetched /= n;
+            return *this;
+        }
     };
 
     // 缓存基类
@@ -69,18 +203,45 @@ namespace cache_sim
         // 获取 ID
         int getId() const { return id_; }
 
-        // 计算组索引
+        // 计算组索引（斜相联时为第 0 路的组索引）
         size_t getSetIndex(uint64_t address) const;
 
+        // 计算指定路的组索引（仅斜相联时各路不同）
+        size_t getSetIndex(uint64_t address, size_t way) const;
+
         // 计算标签
         uint64_t getTag(uint64_t address) const;
 
+        // 由组索引、标签（及所在路）还原块起始地址
+        uint64_t reconstructAddress(size_t set_index, uint64_t tag, size_t way = 0) const;
+
+        // 实际参与索引的组数（素数取模时小于总组数）
+        size_t getNumIndexedSets() const { return index_modulus_; }
+
         // 计算块内偏移
         size_t getBlockOffset(uint64_t address) const;
 
+        // 每块的扇区数（不分扇区时为 1）
+        size_t getSectorsPerBlock() const { return sectors_per_block_; }
+
         // 查找缓存行
         CacheLine *findLine(uint64_t address);
 
+        // 地址所在组是否被采样（未启用组采样时总为 true）
+        bool isSampled(uint64_t address) const
+        {
+            return sample_slot_.empty() || sample_slot_[getSetIndex(address)] != kUnsampled;
+        }
+
+        // 是否启用了组采样
+        bool isSampling() const { return !sample_slot_.empty(); }
+
+        // 各采样组的访问、缺失与驱逐计数（按组号升序，未启用组采样时为空）
+        const std::vector<SetStats> &getSampledSetStats() const { return sample_stats_; }
+
+        // 由采样组的统计估计全缓存的缺失率及其置信区间
+        SamplingEstimate getSamplingEstimate() const;
+
         // 重置统计信息
         void resetStats();
 
@@ -90,9 +251,44 @@ namespace cache_sim
         // 写入数据
         bool write(uint64_t address, uint8_t value);
 
+        // 预取：块不在缓存中时按读缺失装入，不计入命中与缺失统计
+        // 返回是否装入了新块
+        bool prefetch(uint64_t address);
+
+        // 写回包含该地址的脏块并保留为干净块，返回是否发生了写回
+        bool clean(uint64_t address);
+
+        // 作废包含该地址的块（包括受害者缓存中的副本），脏数据先写回主存
+        // 返回该块是否在缓存中
+        bool invalidate(uint64_t address);
+
+        // 将写缓冲中的数据全部排空到主存
+        void flushWriteBuffer();
+
+        // 作废块地址满足 match 的所有块（包括受害者缓存中的块），脏数据先写回主存
+        // 返回作废的块数
+        size_t flush(const std::function<bool(uint64_t)> &match);
+
+        // 设置此后装入的行的所有者
+        void setOwner(uint16_t owner) { current_owner_ = owner; }
+
+        // 路划分（类似 Intel CAT）：此后缺失时只能替换掩码中的路，命中不受限制
+        // 掩码为 0 或覆盖所有路时不限制
+        void setWayMask(uint64_t mask);
+        uint64_t getWayMask() const { return way_mask_; }
+
+        // 各所有者当前占用的有效行数（按所有者编号）
+        std::vector<size_t> occupancyByOwner() const;
+
+        // 各所有者的行被其他所有者驱逐的次数（按被驱逐行的所有者编号）
+        const std::vector<uint64_t> &getForeignEvictionsByOwner() const { return foreign_evicted_; }
+
+        // 设置驱逐记录：此后每次驱逐有效行时追加其块地址（为空时不记录），由调用者取走并清空
+        void setEvictionLog(std::vector<uint64_t> *log) { eviction_log_ = log; }
+
         // 嗅探总线请求
-        // 返回 true 表示本地缓存拥有该数据块
-        bool snoop(uint64_t address, BusEvent event);
+        // 返回本地缓存是否持有该数据块以及是否提供数据、写回或作废
+        SnoopResult snoop(uint64_t address, BusEvent event);
 
         // 选择要替换的缓存行（由子类实现具体策略）
         virtual CacheLine *selectVictim(size_t set_index) = 0;
@@ -103,12 +299,32 @@ namespace cache_sim
         // 重置缓存行信息（当行被驱逐或重新分配时调用，由子类实现）
         virtual void resetLine(size_t set_index, CacheLine *) = 0;
 
+        // 斜相联时在来自不同组的候选行之间比较：a 是否比 b 更适合被替换
+        // 默认按最后访问时间（LRU），子类可覆盖
+        virtual bool preferVictim(const CacheLine &a, const CacheLine &b) const;
+
         // 获取统计信息
         const CacheStats &getStats() const
         {
             return stats_;
         }
 
+        // 以二进制写出缓存状态：各行的标签、一致性状态、数据与替换元数据，以及受害者缓存
+        // 写缓冲与统计信息不保存（调用前应先排空写缓冲）
+        bool saveState(std::ostream &os) const;
+
+        // 恢复 saveState 写出的状态，几何参数不一致或数据不完整时返回 false
+        // 恢复后统计信息清零
+        bool loadState(std::istream &is);
+
+#ifdef CACHE_SIM_SET_STATS
+        // 获取各组的统计信息
+        const std::vector<SetStats> &getSetStats() const
+        {
+            return set_stats_;
+        }
+#endif
+
     protected:
         // 缓存配置
         CacheConfig config_;
@@ -124,6 +340,119 @@ namespace cache_sim
 
         // 缓存组
         std::vector<CacheSet> sets_;
+
+        // 地址划分参数（构造时计算）
+        size_t block_bits_;      // 块内偏移位数
+        size_t set_bits_;        // 组索引位数（组数为 2 的幂时有效）
+        uint64_t set_mask_;      // 组索引掩码
+        size_t index_modulus_;   // 参与索引的组数
+        bool pow2_sets_;         // 参与索引的组数是否为 2 的幂
+        size_t sector_size_;       // 取回数据的粒度（不分扇区时为块大小）
+        size_t sector_bits_;       // 扇区内偏移位数
+        size_t sectors_per_block_; // 每块的扇区数
+        uint64_t all_sectors_;     // 全部扇区的位图
+
+        // 逻辑访问时钟，用于记录缓存行的最后访问时间
+        uint64_t access_clock_ = 0;
+
+        // 当前所有者，以及各所有者的行被其他所有者驱逐的次数
+        uint16_t current_owner_ = 0;
+        std::vector<uint64_t> foreign_evicted_;
+
+        // 驱逐记录（未设置时为空）
+        std::vector<uint64_t> *eviction_log_ = nullptr;
+
+        // 当前可替换的路（全部路时不做限制）
+        uint64_t way_mask_ = 0;
+        bool way_restricted_ = false;
+
+        // 受害者缓存 / 缺失缓存（未启用时为空）
+        std::unique_ptr<VictimCache> victim_cache_;
+
+        // 合并写缓冲（未启用时为空）
+        std::unique_ptr<WriteBuffer> write_buffer_;
+
+        // 组采样：每组在 sample_stats_ 中的位置，未采样的组为 kUnsampled（未启用时为空）
+        static constexpr uint32_t kUnsampled = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> sample_slot_;
+        std::vector<SetStats> sample_stats_;
+
+        // 按配置选出采样组
+        void selectSampledSets();
+
+        // 写出子类额外的替换元数据（各行的访问时间与访问计数已由基类保存）
+        virtual void saveReplacementState(std::ostream &) const {}
+
+        // 读取子类额外的替换元数据，并由各行的访问时间与访问计数重建替换策略的索引结构
+        virtual bool loadReplacementState(std::istream &) { return true; }
+
+        // 查找缓存行，set_index 返回命中行所在组（缺失时为第 0 路的组）
+        CacheLine *lookup(uint64_t address, size_t &set_index);
+
+#ifdef CACHE_SIM_SET_STATS
+        // 各组的访问、缺失与驱逐计数
+        std::vector<SetStats> set_stats_;
+#endif
+
+        // 为缺失的地址分配缓存行：选择替换行、统计驱逐与写回并重置该行
+        // 斜相联时 set_index 更新为被选中行所在的组
+        CacheLine *allocateLine(uint64_t address, size_t &set_index);
+
+        // 斜相联或路划分时逐路比较候选行选择替换行（只考虑路掩码允许的路）
+        CacheLine *selectWayVictim(uint64_t address, size_t &set_index);
+
+        // 将标签按索引位宽异或折叠
+        uint64_t foldTag(uint64_t tag) const;
+
+        // 向总线广播请求并统计总线事务
+        BusResponse broadcast(uint64_t address, BusEvent event);
+
+        // 按一致性协议处理一份副本（缓存行或受害者缓存项）的嗅探
+        // dirty_sectors: 刷新时写回的扇区
+        SnoopResult applySnoop(MESIState &state, bool &dirty, uint64_t block_address, BusEvent event,
+                               uint64_t dirty_sectors = ~uint64_t(0));
+
+        // 读缺失时分配缓存行、广播 BusRd 并按总线响应设置一致性状态
+        CacheLine *fillForRead(uint64_t address, size_t &set_index);
+
+        // 写命中后将数据写入块内偏移处，并按写策略与一致性协议更新缓存行
+        void completeWrite(uint64_t address, CacheLine *line, uint8_t value);
+
+        // 将数据写往主存（经过写缓冲时可能被合并）
+        void writeToMemory(uint64_t address, size_t size);
+
+        // 写缓冲排空的块交给主存
+        void sendToMemory(const std::vector<uint64_t> &blocks);
+
+        // 写回整个块（脏行驱逐或嗅探刷新），分扇区时只写回 dirty_sectors 中的扇区
+        void writeBackBlock(uint64_t block_address, uint64_t dirty_sectors = ~uint64_t(0));
+
+        // 地址所在扇区的位
+        uint64_t sectorBit(uint64_t address) const
+        {
+            return uint64_t(1) << (getBlockOffset(address) >> sector_bits_);
+        }
+
+        // 地址所在扇区是否有效（不分扇区时标签命中即有效）
+        bool sectorPresent(const CacheLine *line, uint64_t address) const
+        {
+            return sectors_per_block_ == 1 || (line->sector_valid & sectorBit(address)) != 0;
+        }
+
+        // 扇区缺失：标签命中但扇区无效，以 event 取回该扇区，一致性状态仍按整行维护
+        void fillSector(uint64_t address, CacheLine *line, BusEvent event);
+
+        // 缺失时探测受害者缓存，命中则将该块装回 L1 并返回对应缓存行
+        CacheLine *refillFromVictimCache(uint64_t address, size_t &set_index);
+
+        // 处理受害者缓存中的嗅探
+        SnoopResult snoopVictimCache(uint64_t address, BusEvent event);
+
+        // 块起始地址
+        uint64_t blockAddress(uint64_t address) const
+        {
+            return address & ~static_cast<uint64_t>(config_.block_size - 1);
+        }
     };
 
 } // namespace cache_sim
@@ -5,13 +5,23 @@
 
 namespace cache_sim
 {
-    // MESI 状态协议
+    // MESI 状态协议（MOESI 与 MESIF 协议额外使用 Owned 与 Forward 状态）
     enum class MESIState
     {
         Modified,  // 已修改，数据与主存不一致
         Exclusive, // 独占，数据与主存一致，仅此缓存有副本
         Shared,    // 共享，数据与主存一致，可能有其他缓存副本
-        Invalid    // 无效，缓存行无效
+        Invalid,   // 无效，缓存行无效
+        Owned,     // 拥有（MOESI），数据已修改且可能有其他共享副本，由本缓存负责提供数据与写回
+        Forward    // 转发（MESIF），干净的共享副本，由本缓存负责响应读请求
+    };
+
+    // 缓存一致性协议
+    enum class CoherenceProtocol
+    {
+        MESI,
+        MOESI, // 脏数据可共享，读共享时无需写回主存
+        MESIF  // 指定一个转发者提供缓存间传输
     };
 
     // 缓存行
@@ -24,9 +34,13 @@ namespace cache_sim
         std::vector<uint8_t> data; // 数据块
         uint64_t last_access_time; // 最后访问时间（用于 LRU）
         uint64_t access_count;     // 访问计数（用于 LFU）
+        uint16_t owner;            // 装入该行的所有者（如进程编号，用于统计进程间干扰）
+        uint64_t sector_valid;     // 分扇区时各扇区的有效位（valid 只表示标签有效）
+        uint64_t sector_dirty;     // 分扇区时各扇区的脏位
 
         CacheLine(size_t block_size = 64)
-            : valid(false), dirty(false), tag(0), state(MESIState::Invalid), data(block_size, 0), last_access_time(0), access_count(0) {}
+            : valid(false), dirty(false), tag(0), state(MESIState::Invalid), data(block_size, 0), last_access_time(0), access_count(0), owner(0),
+              sector_valid(0), sector_dirty(0) {}
     };
 
     // 缓存组
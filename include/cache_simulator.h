@@ -3,23 +3,82 @@
 
 #include "cache.h"
 #include "bus.h"
+#include "reuse_distance.h"
+#include "interval_stats.h"
+#include "sharing_detector.h"
+#include "workload.h"
+#include "trace.h"
+#include "virtual_memory.h"
+#include "page_cache.h"
+#include "partitioning.h"
+#include "dram.h"
+#include "numa.h"
+#include "compression.h"
 #include <bits/stdc++.h>
 
 namespace cache_sim
 {
-    // 访问模式
-    enum class AccessPattern
+    // 单次内存访问
+    struct MemoryAccess
     {
-        Random,     // 随机访问
-        Sequential, // 顺序访问
-        Localized   // 局部性访问
+        size_t core_id;   // 发起访问的核心
+        uint64_t address; // 访问地址
+        bool is_write;    // 是否为写操作
     };
 
-    // 缓存替换策略
-    enum class ReplacementPolicy
+    // 上下文切换时对缓存的处理
+    enum class SwitchFlush
     {
-        LRU,
-        LFU
+        Keep,    // 保留：缓存行带地址空间标签（ASID），各进程的行共存
+        Partial, // 部分刷新：硬件 ASID 数有限，换入没有 ASID 的进程时回收最久未用的 ASID 并作废其原进程的行
+        Full     // 全部刷新：作废整个缓存（如无 ASID 的虚拟索引缓存）
+    };
+
+    // 单个进程的统计
+    struct ProcessStats
+    {
+        uint64_t accesses;          // 访问次数
+        uint64_t misses;            // 缺失次数
+        uint64_t slices;            // 被调度运行的时间片数
+        uint64_t refill_windows;    // 切换回该进程后的重新填充窗口数（不含首次运行）
+        uint64_t refill_accesses;   // 重新填充窗口内的访问次数
+        uint64_t refill_misses;     // 重新填充窗口内的缺失次数
+        uint64_t flushed_blocks;    // 上下文切换时被刷新作废的块数
+        uint64_t foreign_evictions; // 该进程驱逐其他进程的行的次数
+
+        ProcessStats() : accesses(0), misses(0), slices(0), refill_windows(0), refill_accesses(0), refill_misses(0),
+                         flushed_blocks(0), foreign_evictions(0) {}
+
+        // 重新填充窗口之外的稳态缺失率
+        double steadyMissRate() const
+        {
+            uint64_t steady = accesses - refill_accesses;
+            return steady > 0 ? static_cast<double>(misses - refill_misses) / steady : 0.0;
+        }
+
+        // 每次切换回该进程带来的额外缺失：窗口内缺失数减去按稳态缺失率应有的缺失数
+        double refillCost() const
+        {
+            if (refill_windows == 0)
+            {
+                return 0.0;
+            }
+            double extra = static_cast<double>(refill_misses) - static_cast<double>(refill_accesses) * steadyMissRate();
+            return extra / refill_windows;
+        }
+    };
+
+    // 一个核心上一个路划分分区（服务类别，CLOS）的统计
+    struct PartitionStats
+    {
+        size_t core_id;     // 核心
+        size_t clos;        // 服务类别
+        uint64_t way_mask;  // 当前路掩码
+        size_t occupancy;   // 当前占用的有效行数
+        uint64_t accesses;  // 该分区内进程的访问次数
+        uint64_t hits;      // 命中次数
+
+        double hitRate() const { return accesses > 0 ? static_cast<double>(hits) / accesses : 0.0; }
     };
 
     // 模拟器配置
@@ -34,10 +93,73 @@ namespace cache_sim
         size_t working_set_period;            // 工作集切换周期（访问次数）
         size_t working_set_size;              // 工作集大小（字节）
         bool output_json = false;             // 是否输出JSON格式结果
+        bool reuse_distance = false;          // 是否统计复用距离直方图
+        size_t reuse_max_blocks = 1 << 20;    // 复用距离分析最多跟踪的块数
+        size_t stats_interval = 0;            // 区间统计快照间隔（访问次数，0 表示关闭）
+        std::string interval_output;          // 区间统计输出文件
+        IntervalFormat interval_format = IntervalFormat::JsonLines; // 区间统计输出格式
+        std::string set_heatmap_output;       // 按组热力图输出文件（需启用 CACHE_SIM_SET_STATS）
+        bool compare_protocols = false;       // 是否在同一访问流上比较各一致性协议
+        bool sharing_analysis = false;        // 是否检测真共享 / 伪共享缺失
+        size_t sharing_top_blocks = 10;       // 报告一致性缺失最多的块数
+        double write_ratio = 0.25;            // 默认写操作比例
+        size_t sharers = 0;                   // 共享模式的默认共享度（0 表示全部核心）
+        double zipf_theta = 0.99;             // 键值模式的 Zipf 偏斜指数
+        size_t object_size = 0;               // 键值模式的对象大小（字节，0 表示一块）
+        double hot_fraction = 0.2;            // 热点模式中热键的比例
+        double hot_access = 0.8;              // 热点模式中访问热键的比例
+        uint64_t seed = 0;                    // 随机数种子，相同种子产生相同的访问流与结果
+        std::vector<std::string> trace_files; // 按核心顺序读取的 trace 文件（其余核心使用生成的访问流）
+        TraceFormat trace_format = TraceFormat::Auto; // trace 文件格式
+        size_t trace_threads = 2;             // 压缩 trace 的解码线程数
+        bool virtual_memory = false;          // 是否在数据缓存之前模拟 TLB、页表遍历与页面置换
+        VirtualMemoryConfig vm_config;        // 虚拟内存配置
+        bool page_cache = false;              // 是否以文件 I/O 请求驱动页缓存模拟（替代 CPU 缓存模拟）
+        PageCacheConfig page_cache_config;    // 页缓存配置
+        size_t warmup_accesses = 0;           // 预热访问次数，不计入统计（在 num_accesses 之外）
+        std::string checkpoint_input;         // 运行前恢复缓存状态的检查点文件
+        std::string checkpoint_output;        // 运行后保存缓存状态的检查点文件
+        size_t processes_per_core = 1;        // 每个核心上轮转调度的进程数（大于 1 时各进程有独立的地址空间）
+        size_t time_slice = 10000;            // 时间片（该核心的访问次数）
+        SwitchFlush switch_flush = SwitchFlush::Keep; // 上下文切换时对缓存的处理
+        size_t refill_window = 1000;          // 切换后统计重新填充代价的访问次数
+        size_t hardware_asids = 2;            // 部分刷新时每个核心的硬件 ASID 数
+        std::vector<CoreWorkload> process_workloads; // 核内各进程的负载（为空时使用所在核心的负载）
+        std::vector<uint64_t> way_masks;      // 各服务类别（CLOS）的路掩码，为空时不划分
+        std::vector<size_t> process_clos;     // 核内第 i 个进程所属的 CLOS（未指定时按 i 对 CLOS 数取模）
+        size_t ucp_interval = 0;              // UCP 动态划分的间隔（该核心的访问次数，0 表示关闭），每个进程一个分区
+        NumaConfig numa_config;               // 多插槽拓扑（插槽数为 1 时所有核心共享一条总线）
+        bool dram = false;                    // 是否在最后一级缓存之后模拟 DRAM 内存控制器
+        DramConfig dram_config;               // DRAM 配置
+        bool compression = false;             // 是否以带真实数据的压缩缓存对照模拟各核心的缓存
+        CompressionConfig compression_config; // 压缩缓存配置
+        std::vector<CoreWorkload> core_workloads; // 各核心的负载（为空或不足时使用全局参数）
+        StreamInterleave interleave = StreamInterleave::RoundRobin; // 各核心访问流的交织方式
 
         // 获取当前替换策略的名称
         static std::string getPolicyName(ReplacementPolicy policy);
 
+        // 获取组索引函数的名称
+        static std::string getIndexFunctionName(IndexFunction index_function);
+
+        // 获取一致性协议的名称
+        static std::string getProtocolName(CoherenceProtocol protocol);
+
+        // 获取组采样方式的名称
+        static std::string getSamplingName(SetSampling sampling);
+
+        // 获取访问流交织方式的名称
+        static std::string getInterleaveName(StreamInterleave interleave);
+
+        // 获取上下文切换缓存处理方式的名称
+        static std::string getSwitchFlushName(SwitchFlush flush);
+
+        // 由全局访问参数构造的默认核心负载
+        CoreWorkload defaultWorkload() const;
+
+        // 核心 core_id 的负载
+        CoreWorkload workloadFor(size_t core_id) const;
+
         SimulatorConfig(size_t accesses = 10000, size_t range = 1048576, AccessPattern pattern = AccessPattern::Random, ReplacementPolicy policy = ReplacementPolicy::LRU, int cores = 1, size_t ws_period = 10000, size_t ws_size = 65536)
             : num_accesses(accesses), address_range(range), access_pattern(pattern), replacement_policy(policy), num_cores(cores), working_set_period(ws_period), working_set_size(ws_size)
         {
@@ -51,9 +173,19 @@ namespace cache_sim
         explicit CacheSimulator(const SimulatorConfig &config);
         ~CacheSimulator() = default;
 
+        // 所有 trace 文件均已打开；否则 run() 不执行任何访问（不以生成的访问流代替 trace）
+        bool ok() const { return ok_; }
+
         // 运行模拟
         void run();
 
+        // 执行一次外部提供的访问（不经访问流），命中时返回 true，核心编号越界时返回 false。
+        // 与 run() 相同地更新全部统计，结束后调用 finish() 排空写缓冲
+        bool access(size_t core_id, uint64_t address, bool is_write);
+
+        // 运行结束时的收尾工作（由 run() 自动调用）
+        void finish() { finishRun(); }
+
         // 打印结果
         void printResults() const;
 
@@ -63,19 +195,220 @@ namespace cache_sim
         // 平均统计数据
         CacheStats getAverageStats() const;
 
+        // 核心数
+        size_t getNumCores() const { return caches_.size(); }
+
+        // 核心 core_id 的缓存统计
+        const CacheStats &getCoreStats(size_t core_id) const { return caches_[core_id]->getStats(); }
+
+        // 清零全部统计（保留缓存内容）
+        void clearStats() { resetStats(); }
+
+        // 总线流量统计（多插槽时为各插槽总线之和）
+        BusStats getBusStats() const;
+
+        // 插槽间互连（单插槽时为空）
+        const Interconnect *getInterconnect() const { return interconnect_.get(); }
+
+        // 核心所在的插槽
+        size_t socketOf(size_t core_id) const { return core_id / (config_.num_cores / config_.numa_config.sockets); }
+
+        // 将所有缓存的状态保存为检查点（访问流、复用距离与共享检测的状态不保存）
+        bool saveCheckpoint(const std::string &path) const;
+
+        // 从检查点恢复所有缓存的状态，核心数、替换策略或缓存配置不一致时返回 false
+        bool loadCheckpoint(const std::string &path);
+
+        // 虚拟内存层（未启用时为空）
+        const VirtualMemory *getVirtualMemory() const { return vm_.get(); }
+
+        // 各进程的统计（按 核心 * 每核心进程数 + 核内编号 排列，未启用多进程调度时为空）
+        const std::vector<ProcessStats> &getProcessStats() const { return process_stats_; }
+
+        // 进程的行被其他进程驱逐的次数
+        uint64_t getEvictedByOthers(size_t process) const;
+
+        // 上下文切换次数
+        uint64_t getContextSwitches() const { return context_switches_; }
+
+        // 各核心各分区的占用与命中统计（未启用路划分时为空）
+        std::vector<PartitionStats> getPartitionStats() const;
+
+        // UCP 重新划分的次数
+        uint64_t getRepartitions() const { return repartitions_; }
+
+        // 内存控制器（未启用 DRAM 模拟时为空）
+        const MemoryController *getMemoryController() const { return memory_.get(); }
+
+        // 各核心的压缩缓存（未启用压缩时为空）
+        const std::vector<std::unique_ptr<CompressedCache>> &getCompressedCaches() const { return compressed_; }
+
+        // 合并各核心采样组的统计，估计全缓存的缺失率（未启用组采样时没有抽样误差）
+        SamplingEstimate getSamplingEstimate() const;
+
+        // 以相同的访问流驱动 MESI、MOESI 与 MESIF 三个模拟器并输出流量对比，trace 无法打开时返回 false
+        static bool compareProtocols(const SimulatorConfig &config);
+
+        // 以文件 I/O 请求驱动页缓存并输出命中率、预读与回写统计，I/O trace 无法打开时返回 false
+        static bool runPageCache(const SimulatorConfig &config);
+
     private:
         SimulatorConfig config_;
-        std::unique_ptr<Bus> bus_;
+        std::vector<std::unique_ptr<Bus>> buses_; // 各插槽的总线
+        std::unique_ptr<Interconnect> interconnect_;
         std::vector<std::unique_ptr<Cache>> caches_;
 
+        // 复用距离分析器（每个核心一个，另有一个全局分析器）
+        std::vector<std::unique_ptr<ReuseDistanceProfiler>> core_profilers_;
+        std::unique_ptr<ReuseDistanceProfiler> global_profiler_;
+
+        // 真共享 / 伪共享检测器
+        std::unique_ptr<SharingDetector> sharing_detector_;
+
+        // 虚拟内存层：访问先经 TLB 与页表转换为物理地址
+        std::unique_ptr<VirtualMemory> vm_;
+
+        // DRAM 内存控制器：接收总线上由主存提供的读与写回，时间按访问次数推进
+        std::unique_ptr<MemoryController> memory_;
+        uint64_t memory_accesses_ = 0;
+
+        // 压缩缓存：与各核心的缓存几何相同、以同一访问流驱动，块内容与写入值取自内存映像。
+        // 只模拟标签与数据空间的占用，不参与一致性（其他核心的写入不改变本核心已缓存块的压缩大小）
+        std::unique_ptr<MemoryImage> memory_image_;
+        std::vector<std::unique_ptr<CompressedCache>> compressed_;
+
+        // 各进程的访问流（按 核心 * 每核心进程数 + 核内编号 排列）与核心间的交织调度器
+        std::vector<std::unique_ptr<WorkloadStream>> streams_;
+        std::unique_ptr<StreamScheduler> scheduler_;
+
+        // 多进程调度：进程编号作为 ASID 置于地址的高位
+        static const size_t kAsidShift = 48;
+        std::vector<size_t> running_;      // 各核心正在运行的进程（核内编号）
+        std::vector<size_t> slice_used_;   // 各核心当前时间片已执行的访问次数
+        std::vector<size_t> since_switch_; // 各核心自上次切换以来的访问次数
+        std::vector<bool> refilling_;      // 各核心是否处于切换后的重新填充窗口
+        std::vector<bool> has_run_;        // 各进程是否运行过（首次运行的冷启动缺失不计入重新填充代价）
+        std::vector<std::vector<size_t>> asid_holders_; // 部分刷新：各核心持有硬件 ASID 的进程，按最近运行排列
+        std::vector<ProcessStats> process_stats_;
+        uint64_t context_switches_ = 0;
+
+        // 路划分：各核心各 CLOS 的当前路掩码，UCP 的影子标签与距上次重新划分的访问次数
+        std::vector<std::vector<uint64_t>> clos_masks_;
+        std::vector<std::vector<std::unique_ptr<UtilityMonitor>>> monitors_;
+        std::vector<size_t> since_repartition_;
+        uint64_t repartitions_ = 0;
+
+        // 各核心的 trace 读取器（为空的核心使用生成的访问流）与已读完的核心
+        std::vector<std::unique_ptr<TraceReader>> traces_;
+        std::vector<bool> exhausted_;
+        size_t active_sources_ = 0;
+
+        // 实际执行的访问次数（trace 可能先于 num_accesses 结束）
+        size_t executed_accesses_ = 0;
+
+        // 是否所有 trace 文件均已打开
+        bool ok_ = true;
+
         // 创建缓存实例
         void createCaches();
 
-        // 生成访问地址
-        uint64_t generateAddress(size_t index) const;
+        // 创建复用距离分析器
+        void createProfilers();
+
+        // 创建各核心的访问流
+        void createStreams();
+
+        // 生成下一次访问，所有访问源都已结束时返回 false
+        bool nextAccess(MemoryAccess &access);
+
+        // 运行结束时的收尾工作（排空写缓冲等）
+        void finishRun();
+
+        // 预热结束时清零缓存、总线、复用距离与共享检测的统计（保留缓存内容）
+        void resetStats();
+
+#ifdef CACHE_SIM_SET_STATS
+        // 输出按组热力图数据
+        void writeSetHeatmap() const;
+#endif
+
+        // 以 JSON 字段格式输出一份统计（不含外层大括号）
+        void writeStatsJson(std::ostream &os, const CacheStats &stats, const std::string &indent) const;
+
+        // 以文本格式输出一份统计
+        void printStatsText(const CacheStats &stats) const;
+
+        // 以 JSON 对象格式输出组采样的外推结果
+        void writeSamplingJson(std::ostream &os, const SamplingEstimate &estimate, const CacheStats &stats, const std::string &indent) const;
+
+        // 以文本格式输出组采样的外推结果
+        void printSamplingText(const SamplingEstimate &estimate, const CacheStats &stats) const;
+
+        // 以 JSON 对象格式输出总线流量统计
+        void writeBusStatsJson(std::ostream &os, const std::string &indent) const;
+
+        // 以 JSON 对象格式输出共享检测结果
+        void writeSharingJson(std::ostream &os, const std::string &indent) const;
+
+        // 以文本格式输出共享检测结果
+        void printSharingText() const;
+
+        // 以 JSON 对象格式输出虚拟内存统计
+        void writeVirtualMemoryJson(std::ostream &os, const std::string &indent) const;
+
+        // 以文本格式输出虚拟内存统计
+        void printVirtualMemoryText() const;
+
+        // 各核心第 level 级 TLB 的统计之和
+        CacheStats tlbTotalStats(size_t level) const;
+
+        // 以 JSON 对象格式输出多插槽统计
+        void writeNumaJson(std::ostream &os, const std::string &indent) const;
+
+        // 以文本格式输出多插槽统计
+        void printNumaText() const;
+
+        // 以 JSON 对象格式输出 DRAM 统计
+        void writeDramJson(std::ostream &os, const std::string &indent) const;
+
+        // 以文本格式输出 DRAM 统计
+        void printDramText() const;
+
+        // 以 JSON 对象格式输出压缩缓存统计
+        void writeCompressionJson(std::ostream &os, const std::string &indent) const;
+
+        // 以文本格式输出压缩缓存统计
+        void printCompressionText() const;
+
+        // 各核心压缩缓存的统计之和
+        CompressionStats compressionTotalStats() const;
+
+        // 时间片用完时切换到该核心的下一个进程
+        void scheduleProcess(size_t core_id);
+
+        // 核内第 local 个进程所属的 CLOS
+        size_t closOf(size_t local) const;
+
+        // 初始化各核心的路划分
+        void createPartitions();
+
+        // UCP：按影子标签统计的效用重新划分核心的路
+        void repartition(size_t core_id);
+
+        // 以 JSON 对象格式输出路划分统计
+        void writePartitionJson(std::ostream &os, const std::string &indent) const;
+
+        // 以文本格式输出路划分统计
+        void printPartitionText() const;
+
+        // 以 JSON 对象格式输出多进程调度统计
+        void writeProcessJson(std::ostream &os, const std::string &indent) const;
+
+        // 以文本格式输出多进程调度统计
+        void printProcessText() const;
 
-        // 执行单次访问
-        void performAccess(size_t core_id, uint64_t address, bool is_write);
+        // 执行单次访问，命中时返回 true
+        bool performAccess(size_t core_id, uint64_t address, bool is_write);
     };
 
 } // namespace cache_sim
@@ -0,0 +1,179 @@
+#ifndef CACHESIM_H
+#define CACHESIM_H
+
+/*
+ * libcachesim 的 C 接口：供 Python (ctypes)、Rust 等在进程内驱动模拟器。
+ *
+ * - 所有对象都是不透明指针，由 *_create 创建、*_destroy 释放。
+ * - 批量访问直接读取调用者的数组，不复制、不保留指针。
+ * - 结构体只在末尾追加字段，枚举值不重新编号；CACHESIM_ABI_VERSION 在不兼容修改时递增。
+ * - 失败的调用返回 NULL 或负数，cachesim_last_error 返回本线程最近一次错误的说明。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define CACHESIM_ABI_VERSION 1
+
+    /* 替换策略 */
+    enum
+    {
+        CACHESIM_POLICY_LRU = 0,
+        CACHESIM_POLICY_LFU = 1
+    };
+
+    /* 组索引函数 */
+    enum
+    {
+        CACHESIM_INDEX_MODULO = 0,
+        CACHESIM_INDEX_XOR = 1,
+        CACHESIM_INDEX_PRIME = 2,
+        CACHESIM_INDEX_SKEWED = 3
+    };
+
+    /* 一致性协议 */
+    enum
+    {
+        CACHESIM_PROTOCOL_MESI = 0,
+        CACHESIM_PROTOCOL_MOESI = 1,
+        CACHESIM_PROTOCOL_MESIF = 2
+    };
+
+    /* 生成访问流的访问模式（cachesim_simulator_run） */
+    enum
+    {
+        CACHESIM_PATTERN_RANDOM = 0,
+        CACHESIM_PATTERN_SEQUENTIAL = 1,
+        CACHESIM_PATTERN_LOCALIZED = 2,
+        CACHESIM_PATTERN_PRODUCER_CONSUMER = 3,
+        CACHESIM_PATTERN_MIGRATORY = 4,
+        CACHESIM_PATTERN_READ_MOSTLY = 5,
+        CACHESIM_PATTERN_LOCK_CONTENTION = 6,
+        CACHESIM_PATTERN_ZIPFIAN = 7,
+        CACHESIM_PATTERN_SCRAMBLED_ZIPFIAN = 8,
+        CACHESIM_PATTERN_HOTSPOT = 9,
+        CACHESIM_PATTERN_LATEST = 10
+    };
+
+    /* 缓存与模拟器配置，先由 cachesim_config_init 填入默认值 */
+    typedef struct cachesim_config
+    {
+        uint64_t cache_size;     /* 缓存大小（字节） */
+        uint64_t block_size;     /* 块大小（字节，2 的幂） */
+        uint64_t associativity;  /* 关联度 */
+        uint64_t sector_size;    /* 扇区大小（字节，0 表示不分扇区） */
+        uint32_t policy;         /* CACHESIM_POLICY_* */
+        uint32_t index_function; /* CACHESIM_INDEX_* */
+        uint32_t protocol;       /* CACHESIM_PROTOCOL_* */
+        uint32_t write_through;  /* 非 0 时写直达，否则写回 */
+        uint32_t write_allocate; /* 非 0 时写缺失分配缓存行 */
+        uint32_t num_cores;      /* 核心数（仅模拟器） */
+        /* 以下仅用于 cachesim_simulator_run 生成的访问流 */
+        uint32_t pattern;        /* CACHESIM_PATTERN_* */
+        uint32_t reserved;
+        uint64_t num_accesses;
+        uint64_t address_range;
+        double write_ratio;
+        uint64_t seed;
+    } cachesim_config;
+
+    /* 单个缓存的统计 */
+    typedef struct cachesim_stats
+    {
+        uint64_t reads;
+        uint64_t writes;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t conflicts;
+        uint64_t evictions;
+        uint64_t writebacks;
+        uint64_t dirty_evictions;
+        uint64_t bus_transactions;
+        uint64_t memory_writes;
+        uint64_t memory_write_bytes;
+        uint64_t bytes_fetched;
+        uint64_t sector_misses;
+    } cachesim_stats;
+
+    /* 总线统计（各插槽之和） */
+    typedef struct cachesim_bus_stats
+    {
+        uint64_t bus_rd;
+        uint64_t bus_rdx;
+        uint64_t bus_upgr;
+        uint64_t flushes;
+        uint64_t cache_to_cache;
+        uint64_t invalidations;
+        uint64_t memory_reads;
+    } cachesim_bus_stats;
+
+    /* 单个缓存（无总线，不涉及一致性） */
+    typedef struct cachesim_cache cachesim_cache;
+
+    /* 多核模拟器（各核心私有缓存经总线保持一致） */
+    typedef struct cachesim_simulator cachesim_simulator;
+
+    /* 库的 ABI 版本，调用者应与 CACHESIM_ABI_VERSION 比较 */
+    int cachesim_abi_version(void);
+
+    /* 本线程最近一次失败的说明（没有时为空字符串） */
+    const char *cachesim_last_error(void);
+
+    /* 以默认值填充配置：32KB、64 字节块、4 路、LRU、MESI、写回 + 写分配、1 核、随机访问 10000 次 */
+    void cachesim_config_init(cachesim_config *config);
+
+    /* 创建单个缓存，配置无效时返回 NULL（忽略 num_cores 与访问流参数） */
+    cachesim_cache *cachesim_cache_create(const cachesim_config *config);
+    void cachesim_cache_destroy(cachesim_cache *cache);
+
+    /* 一次访问，命中返回 1，缺失返回 0 */
+    int cachesim_cache_access(cachesim_cache *cache, uint64_t address, int is_write);
+
+    /*
+     * 批量访问 addresses[0, count)。is_write 为 NULL 时全部为读，否则非 0 表示写。
+     * hits 不为 NULL 时写入每次访问是否命中。返回命中次数。
+     */
+    size_t cachesim_cache_access_batch(cachesim_cache *cache, const uint64_t *addresses, const uint8_t *is_write,
+                                       size_t count, uint8_t *hits);
+
+    void cachesim_cache_get_stats(const cachesim_cache *cache, cachesim_stats *stats);
+    void cachesim_cache_reset_stats(cachesim_cache *cache);
+
+    /* 创建多核模拟器，配置无效时返回 NULL */
+    cachesim_simulator *cachesim_simulator_create(const cachesim_config *config);
+    void cachesim_simulator_destroy(cachesim_simulator *simulator);
+
+    /* 按配置中的访问模式生成访问，直到已执行的访问（含批量接口执行的）达到 num_accesses */
+    void cachesim_simulator_run(cachesim_simulator *simulator);
+
+    /*
+     * 批量执行调用者提供的访问。cores 为 NULL 时全部由核心 0 发出；is_write 为 NULL 时全部为读。
+     * 核心编号越界时返回 -1 且不执行该批次，否则返回本批次的命中次数。
+     */
+    int64_t cachesim_simulator_access_batch(cachesim_simulator *simulator, const uint64_t *addresses,
+                                            const uint32_t *cores, const uint8_t *is_write, size_t count);
+
+    /* 排空写缓冲（读取写回与主存流量统计之前调用） */
+    void cachesim_simulator_finish(cachesim_simulator *simulator);
+
+    /* 清零缓存与总线统计（保留缓存内容），可用于预热之后 */
+    void cachesim_simulator_reset_stats(cachesim_simulator *simulator);
+
+    /* 核心 core 的统计，越界时返回 -1 */
+    int cachesim_simulator_get_core_stats(const cachesim_simulator *simulator, uint32_t core, cachesim_stats *stats);
+
+    /* 各核心统计之和 */
+    void cachesim_simulator_get_total_stats(const cachesim_simulator *simulator, cachesim_stats *stats);
+
+    void cachesim_simulator_get_bus_stats(const cachesim_simulator *simulator, cachesim_bus_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHESIM_H */
@@ -0,0 +1,208 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include "cache.h"
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 缓存块压缩算法
+    enum class CompressionAlgorithm
+    {
+        BDI, // Base-Delta-Immediate：块内元素表示为一个基址（或零）加窄差值
+        FPC  // Frequent Pattern Compression：每个 32 位字按常见模式编码
+    };
+
+    // BDI 编码（按压缩后大小从小到大排列）
+    enum class BdiEncoding
+    {
+        Zeros,        // 全零
+        Repeated,     // 重复的 8 字节值
+        Base8Delta1,
+        Base4Delta1,
+        Base8Delta2,
+        Base2Delta1,
+        Base4Delta2,
+        Base8Delta4,
+        Uncompressed,
+        Count
+    };
+
+    // 写入数据与块初始内容的取值模型
+    enum class ValueModel
+    {
+        Zero,    // 全零
+        Narrow,  // 小整数（4 字节，取值小于 256）
+        Pointer, // 同一区域内的指针（8 字节，高位相同）
+        Random,  // 随机数（不可压缩）
+        Mixed    // 每个块随机取以上一种（35% 零、30% 小整数、20% 指针、15% 随机）
+    };
+
+    // 单个块的压缩结果
+    struct CompressedSize
+    {
+        size_t bytes;         // 压缩后的字节数（不超过块大小）
+        BdiEncoding encoding; // 使用的 BDI 编码（FPC 时为 Uncompressed）
+    };
+
+    // BDI 压缩：尝试全部编码并返回最小者。块大小须为 8 的倍数。
+    // 差值检查在支持 SSE2 的平台上每次处理 16 字节，其余平台使用等价的标量实现
+    CompressedSize bdiCompress(const uint8_t *block, size_t block_size);
+
+    // BDI 压缩的标量参考实现（结果与 bdiCompress 相同）
+    CompressedSize bdiCompressScalar(const uint8_t *block, size_t block_size);
+
+    // FPC 压缩：每个 32 位字 3 位前缀加模式数据，连续的零字合并为一个零串（最多 8 个字）
+    CompressedSize fpcCompress(const uint8_t *block, size_t block_size);
+
+    // 按算法压缩
+    CompressedSize compressBlock(CompressionAlgorithm algorithm, const uint8_t *block, size_t block_size);
+
+    // 内存内容：按块稀疏存放，首次访问时由内存映像文件或取值模型生成初始内容
+    class MemoryImage
+    {
+    public:
+        // block_size: 块大小（字节，2 的幂且不小于 8）
+        MemoryImage(size_t block_size, ValueModel model, uint64_t seed);
+
+        // 从二进制文件加载初始内容（文件第 i 个字节是地址 i 的内容），失败时返回 false
+        bool loadFile(const std::string &path);
+
+        // 地址所在块的当前内容（指针在下一次访问其他块之前有效）
+        const uint8_t *block(uint64_t address);
+
+        // 写入一个 8 字节值（按 8 字节对齐）
+        void write(uint64_t address, uint64_t value);
+
+        // 按地址所在块的取值类型生成一个新的写入值
+        uint64_t nextValue(uint64_t address);
+
+        size_t getBlockSize() const { return block_size_; }
+
+        static std::string getValueModelName(ValueModel model);
+
+    private:
+        size_t block_size_;
+        size_t block_bits_;
+        ValueModel model_;
+        uint64_t seed_;
+        uint64_t counter_ = 0;                          // 写入值的序号
+        std::vector<uint8_t> file_;                     // 内存映像文件的内容
+        std::vector<uint8_t> pool_;                     // 各块的内容
+        std::unordered_map<uint64_t, size_t> offsets_;  // 块地址 -> 在 pool_ 中的偏移
+
+        // 块的取值类型（Mixed 时按块地址散列选择）
+        ValueModel kindOf(uint64_t block_address) const;
+
+        // 按取值类型生成块内第 index 个 8 字节字
+        uint64_t generate(ValueModel kind, uint64_t block_address, uint64_t index) const;
+
+        // 块的内容，首次访问时生成
+        uint8_t *fetch(uint64_t block_address);
+    };
+
+    // 压缩缓存参数
+    struct CompressionConfig
+    {
+        CompressionAlgorithm algorithm = CompressionAlgorithm::BDI;
+        size_t tag_factor = 2;       // 每组的标签数是路数的倍数（一组最多容纳的块数）
+        size_t segment_size = 8;     // 数据空间的分配粒度（字节）
+        ValueModel value_model = ValueModel::Mixed;
+        std::string memory_image;    // 块初始内容的二进制文件（为空时全部由取值模型生成）
+    };
+
+    // 压缩缓存统计
+    struct CompressionStats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;         // 驱逐的块数
+        uint64_t writebacks;        // 驱逐脏块的次数
+        uint64_t fill_bytes;        // 装入块占用的数据空间之和（按段取整）
+        uint64_t size_changes;      // 写命中后压缩大小改变的次数
+        uint64_t growth_evictions;  // 写命中后块变大、为腾出空间驱逐的块数
+        uint64_t encodings[static_cast<size_t>(BdiEncoding::Count)]; // 装入块的 BDI 编码分布（FPC 时不统计）
+
+        CompressionStats() : hits(0), misses(0), evictions(0), writebacks(0), fill_bytes(0), size_changes(0),
+                             growth_evictions(0), encodings() {}
+
+        double hitRate() const
+        {
+            uint64_t total = hits + misses;
+            return total > 0 ? static_cast<double>(hits) / total : 0.0;
+        }
+
+        // 装入块的平均压缩大小（字节）
+        double avgFillBytes() const
+        {
+            return misses > 0 ? static_cast<double>(fill_bytes) / misses : 0.0;
+        }
+    };
+
+    // 压缩缓存（标签与数据空间分离）
+    // 每组有 路数 * tag_factor 个标签，数据空间仍为 路数 * 块大小，按段分配给压缩后的块，
+    // 因此一组可容纳多于路数的块。缺失时按 LRU 驱逐，直到有空闲标签且剩余空间足以容纳新块；
+    // 写命中后重新压缩，块变大且空间不足时驱逐同组的其他块。块内容取自 MemoryImage。
+    class CompressedCache
+    {
+    public:
+        CompressedCache(const CacheConfig &cache_config, const CompressionConfig &config, MemoryImage *memory);
+
+        // 访问一个地址（写入的数据须已写入 MemoryImage），命中时返回 true
+        bool access(uint64_t address, bool is_write);
+
+        const CompressionStats &getStats() const { return stats_; }
+
+        // 清零统计（保留缓存内容）
+        void resetStats() { stats_ = CompressionStats(); }
+
+        // 当前缓存的块数
+        size_t residentBlocks() const;
+
+        // 压缩率：缓存块的原始字节数 / 占用的数据空间
+        double compressionRatio() const;
+
+        // 数据空间（字节），即未压缩缓存的容量
+        size_t physicalCapacity() const { return num_sets_ * set_bytes_; }
+
+        // 有效容量：缓存块的原始字节数
+        size_t effectiveCapacity() const { return residentBlocks() * block_size_; }
+
+        static std::string getAlgorithmName(CompressionAlgorithm algorithm);
+        static std::string getEncodingName(BdiEncoding encoding);
+
+    private:
+        struct Entry
+        {
+            bool valid = false;
+            bool dirty = false;
+            uint64_t tag = 0;
+            uint32_t size = 0;        // 占用的数据空间（字节，按段取整）
+            uint64_t last_access = 0;
+        };
+
+        struct Set
+        {
+            std::vector<Entry> entries;
+            size_t used = 0; // 已占用的数据空间
+        };
+
+        CompressionConfig config_;
+        MemoryImage *memory_;
+        size_t block_size_;
+        size_t num_sets_;
+        size_t set_bytes_;
+        std::vector<Set> sets_;
+        CompressionStats stats_;
+        uint64_t time_ = 0;
+
+        // 压缩块并按段取整
+        uint32_t compressedSize(uint64_t address, BdiEncoding *encoding);
+
+        // 驱逐 set 中除 keep 之外最久未用的块，没有可驱逐的块时返回 false
+        bool evictLru(Set &set, const Entry *keep);
+    };
+
+} // namespace cache_sim
+
+#endif // COMPRESSION_H
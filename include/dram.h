@@ -0,0 +1,170 @@
+#ifndef DRAM_H
+#define DRAM_H
+
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 行缓冲管理策略
+    enum class PagePolicy
+    {
+        Open,  // 开页：访问后保持行打开，同一行的后续访问只需列访问
+        Closed // 关页：每次访问后自动预充电，访问时间稳定但没有行命中
+    };
+
+    // 物理地址到通道 / bank / 行的映射
+    enum class DramMapping
+    {
+        Row,  // 行 | rank | bank | 通道 | 行内偏移：同一行内的连续块落在同一 bank，适合开页
+        Block // 行 | 行内列 | rank | bank | 通道 | 块内偏移：连续块轮流分布到各通道与 bank，适合关页
+    };
+
+    // DRAM 参数（时间以 DRAM 时钟周期计）
+    struct DramConfig
+    {
+        size_t channels = 1;        // 通道数（各通道有独立的命令队列与数据总线）
+        size_t ranks = 1;           // 每通道的 rank 数
+        size_t banks = 8;           // 每个 rank 的 bank 数
+        size_t row_size = 8192;     // 行缓冲大小（字节）
+        PagePolicy page_policy = PagePolicy::Open;
+        DramMapping mapping = DramMapping::Row;
+        size_t queue_depth = 32;    // 每通道的请求队列深度
+        uint32_t t_rcd = 22;        // 行激活到列访问
+        uint32_t t_rp = 22;         // 预充电
+        uint32_t t_cas = 22;        // 列访问到数据输出
+        uint32_t t_burst = 4;       // 传输一个块占用数据总线的时间
+        double clock_mhz = 1600.0;  // DRAM 时钟频率（换算带宽与纳秒）
+        size_t access_interval = 4; // 每个核心相邻两次访问之间的 DRAM 周期数（模拟器的时间基准）
+    };
+
+    // DRAM 统计
+    struct DramStats
+    {
+        uint64_t reads;               // 读请求数（缓存缺失）
+        uint64_t writes;              // 写请求数（写回与直写）
+        uint64_t row_hits;            // 行缓冲命中
+        uint64_t row_empty;           // bank 无打开的行，需要激活
+        uint64_t row_conflicts;       // 打开的是其他行，需要预充电再激活
+        uint64_t queue_cycles;        // 请求在队列中等待的总周期数（到达至发出第一条命令）
+        uint64_t read_latency_cycles; // 读请求的总延迟（到达至数据传输完成）
+        uint64_t queue_full_stalls;   // 到达时队列已满、处理器需停顿的次数
+        uint64_t stall_cycles;        // 队列满导致的停顿周期数
+        uint64_t bytes;               // 数据总线传输的字节数
+
+        DramStats() : reads(0), writes(0), row_hits(0), row_empty(0), row_conflicts(0), queue_cycles(0),
+                      read_latency_cycles(0), queue_full_stalls(0), stall_cycles(0), bytes(0) {}
+
+        uint64_t requests() const { return reads + writes; }
+
+        double rowHitRate() const
+        {
+            return requests() > 0 ? static_cast<double>(row_hits) / requests() : 0.0;
+        }
+
+        double avgQueueCycles() const
+        {
+            return requests() > 0 ? static_cast<double>(queue_cycles) / requests() : 0.0;
+        }
+
+        double avgReadLatency() const
+        {
+            return reads > 0 ? static_cast<double>(read_latency_cycles) / reads : 0.0;
+        }
+    };
+
+    // 最后一级缓存之后的内存控制器
+    // 地址按 DramMapping 拆分为通道、bank 与行。
+    // 每个通道一个请求队列，按 FR-FCFS 调度：在可发出的请求中优先选择行缓冲命中的最早请求，
+    // 否则选择最早的请求；各 bank 并行工作，同一通道的数据传输在数据总线上串行。
+    // 时间由模拟器通过 advance 推进，请求在当前时间到达，早于当前时间可发出的请求先行调度；
+    // 队列满时当前时间推迟到腾出位置为止，相当于处理器因访存停顿。
+    class MemoryController
+    {
+    public:
+        // block_size: 每个请求传输的字节数（缓存块大小）
+        MemoryController(const DramConfig &config, size_t block_size);
+
+        // 推进当前时间（DRAM 周期）
+        void advance(uint64_t cycles);
+
+        // 当前时间（含队列满时的停顿）
+        uint64_t now() const { return now_; }
+
+        // 缓存缺失读取一个块
+        void read(uint64_t address) { enqueue(address, false); }
+
+        // 写回一个块
+        void write(uint64_t address) { enqueue(address, true); }
+
+        // 发出队列中剩余的全部请求（运行结束时调用）
+        void drain();
+
+        // 清零统计（保留行缓冲与队列状态），带宽从当前时间开始计算
+        void resetStats();
+
+        const DramStats &getStats() const { return stats_; }
+        const DramConfig &getConfig() const { return config_; }
+
+        // 统计区间的长度（DRAM 周期，至最后一个请求完成）
+        uint64_t elapsedCycles() const;
+
+        // 实际带宽与峰值带宽（GB/s）
+        double bandwidth() const;
+        double peakBandwidth() const;
+
+        static std::string getPagePolicyName(PagePolicy policy);
+        static std::string getMappingName(DramMapping mapping);
+
+    private:
+        struct Request
+        {
+            uint64_t arrival; // 到达时间
+            size_t bank;      // 通道内的 bank 编号（rank * banks + bank）
+            uint64_t row;
+            bool is_write;
+        };
+
+        struct Bank
+        {
+            bool open = false;  // 是否有打开的行
+            uint64_t row = 0;   // 打开的行
+            uint64_t ready = 0; // 可以接受下一条命令的时间
+        };
+
+        struct Channel
+        {
+            std::deque<Request> queue;
+            std::vector<Bank> banks;
+            uint64_t next_issue = 0; // 命令总线下一次空闲的时间
+            uint64_t bus_free = 0;   // 数据总线下一次空闲的时间
+            std::vector<uint64_t> pending_hit; // 调度时各 bank 命中打开行的最早请求的到达时间
+        };
+
+        DramConfig config_;
+        size_t block_size_;
+        size_t block_bits_;
+        size_t row_bits_;
+        size_t channel_bits_;
+        size_t bank_bits_;
+        size_t rank_bits_;
+        std::vector<Channel> channels_;
+        DramStats stats_;
+        uint64_t now_ = 0;
+        uint64_t start_time_ = 0; // 统计区间的起点
+        uint64_t last_done_ = 0;  // 最后一个请求完成的时间
+
+        void enqueue(uint64_t address, bool is_write);
+
+        // 访问 row 在列访问之前需要的预充电与激活时间
+        uint32_t rowOverhead(const Bank &bank, uint64_t row) const;
+
+        // 请求最早可以发出的时间（不早于 earliest）
+        uint64_t readyTime(const Channel &channel, const Request &request, uint64_t earliest) const;
+
+        // 发出通道中最早可在 until 之前发出的一个请求，没有则返回 false
+        bool issue(Channel &channel, uint64_t until);
+    };
+
+} // namespace cache_sim
+
+#endif // DRAM_H
@@ -0,0 +1,51 @@
+#ifndef INTERVAL_STATS_H
+#define INTERVAL_STATS_H
+
+#include "cache.h"
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 区间统计输出格式
+    enum class IntervalFormat
+    {
+        JsonLines, // 每个快照一行 JSON
+        Csv        // 每个核心每个快照一行 CSV
+    };
+
+    // 区间统计记录器
+    // 每隔固定访问次数对各核心的 CacheStats 做快照，并以流式方式写出该区间内的增量，
+    // 只保存上一次快照，内存占用与模拟长度无关。
+    class IntervalRecorder
+    {
+    public:
+        // os: 输出流
+        // format: 输出格式
+        // num_cores: 核心数量
+        IntervalRecorder(std::ostream &os, IntervalFormat format, size_t num_cores);
+
+        // 记录一次快照
+        // access_count: 截至目前已执行的访问次数
+        // caches: 各核心的缓存
+        void record(uint64_t access_count, const std::vector<std::unique_ptr<Cache>> &caches);
+
+        // 获取格式名称
+        static std::string getFormatName(IntervalFormat format);
+
+    private:
+        std::ostream &os_;
+        IntervalFormat format_;
+
+        // 上一次快照时各核心的累计统计
+        std::vector<CacheStats> previous_;
+
+        // 上一次快照时的访问次数
+        uint64_t previous_access_count_;
+
+        // 快照序号
+        uint64_t interval_index_;
+    };
+
+} // namespace cache_sim
+
+#endif // INTERVAL_STATS_H
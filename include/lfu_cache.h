@@ -17,6 +17,11 @@ namespace cache_sim
         CacheLine *selectVictim(size_t set_index) override;
         void updateAccessInfo(size_t set_index, CacheLine *line) override;
         void resetLine(size_t set_index, CacheLine *line) override;
+        bool preferVictim(const CacheLine &a, const CacheLine &b) const override;
+
+    protected:
+        void saveReplacementState(std::ostream &os) const override;
+        bool loadReplacementState(std::istream &is) override;
 
     private:
         struct LFUSet
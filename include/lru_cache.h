@@ -18,6 +18,9 @@ namespace cache_sim
         void updateAccessInfo(size_t set_index, CacheLine *line) override;
         void resetLine(size_t set_index, CacheLine *line) override;
 
+    protected:
+        bool loadReplacementState(std::istream &is) override;
+
     private:
         struct LRUSet
         {
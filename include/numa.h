@@ -0,0 +1,92 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include "bus.h"
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 物理内存在各插槽间的分布方式（决定块的主节点）
+    enum class NumaInterleave
+    {
+        Page,      // 按页轮流分布到各插槽
+        Block,     // 按块轮流分布到各插槽
+        FirstTouch // 页的主节点是第一次访问它的插槽
+    };
+
+    // 多插槽拓扑参数（延迟以处理器周期计）
+    struct NumaConfig
+    {
+        size_t sockets = 1;            // 插槽数（各插槽有独立的总线，核心按编号连续分配到插槽）
+        NumaInterleave interleave = NumaInterleave::Page;
+        size_t page_size = 4096;       // 按页分布与首次访问分布的粒度（字节）
+        uint32_t local_cache_latency = 40;   // 由同一插槽内的其他缓存提供数据
+        uint32_t remote_cache_latency = 120; // 经互连由其他插槽的缓存提供数据
+        uint32_t local_memory_latency = 90;  // 访问本插槽的内存
+        uint32_t remote_memory_latency = 150; // 经互连访问其他插槽的内存
+    };
+
+    // 单个插槽的统计（按发起请求的插槽计）
+    struct NumaSocketStats
+    {
+        uint64_t local_transfers;      // 缺失由本插槽的其他缓存提供
+        uint64_t remote_cache_hits;    // 缺失由其他插槽的缓存提供
+        uint64_t local_memory;         // 缺失由本插槽的内存提供
+        uint64_t remote_memory;        // 缺失由其他插槽的内存提供
+        uint64_t remote_invalidations; // 经互连作废其他插槽副本的次数
+        uint64_t remote_writebacks;    // 写往其他插槽内存的块数
+        uint64_t stale_sharers;        // 目录记录的插槽嗅探时已没有副本（副本被静默驱逐）
+
+        NumaSocketStats() : local_transfers(0), remote_cache_hits(0), local_memory(0), remote_memory(0),
+                            remote_invalidations(0), remote_writebacks(0), stale_sharers(0) {}
+
+        // 经互连完成的缺失数
+        uint64_t remoteMisses() const { return remote_cache_hits + remote_memory; }
+    };
+
+    // 插槽间互连与主节点目录
+    // 各插槽的总线只在本插槽内嗅探；本插槽无法满足的读请求与需要作废副本的写请求经互连
+    // 查询块的主节点目录，由目录记录的其他插槽嗅探提供数据或作废副本，都没有时由主节点的内存提供。
+    // 目录按插槽记录共享者，副本被驱逐时不通知目录，多出的共享者在下一次嗅探时清除。
+    class Interconnect
+    {
+    public:
+        // block_size: 缓存块大小（字节）
+        Interconnect(const NumaConfig &config, size_t block_size);
+
+        // 按插槽编号顺序连接各插槽的总线
+        void attach(Bus *bus);
+
+        // 处理 socket 上本地嗅探之后的请求：嗅探其他插槽、更新目录并在 response 中合并结果
+        void request(size_t socket, int sender_id, uint64_t address, BusEvent event, BusResponse &response);
+
+        // 写往主存的块按主节点计入本地或远程写回
+        void writeBack(size_t socket, uint64_t address);
+
+        // 块的主节点（首次访问分布时由 requester 首次访问的页归属 requester）
+        size_t homeOf(uint64_t address, size_t requester);
+
+        const NumaConfig &getConfig() const { return config_; }
+        const std::vector<NumaSocketStats> &getStats() const { return stats_; }
+
+        // 插槽缺失的平均延迟（周期）：按数据来源加权
+        double averageMissLatency(size_t socket) const;
+
+        // 清零统计（保留目录与首次访问的页分布）
+        void resetStats();
+
+        static std::string getInterleaveName(NumaInterleave interleave);
+
+    private:
+        NumaConfig config_;
+        size_t block_bits_;
+        size_t page_bits_;
+        std::vector<Bus *> buses_;
+        std::vector<NumaSocketStats> stats_;
+        std::unordered_map<uint64_t, uint64_t> directory_; // 块地址 -> 持有副本的插槽位图
+        std::unordered_map<uint64_t, size_t> first_touch_; // 页 -> 主节点
+    };
+
+} // namespace cache_sim
+
+#endif // NUMA_H
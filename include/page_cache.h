@@ -0,0 +1,140 @@
+#ifndef PAGE_CACHE_H
+#define PAGE_CACHE_H
+
+#include "cache.h"
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 一次文件 I/O 请求
+    struct IoRequest
+    {
+        uint64_t file_id; // 文件编号
+        uint64_t offset;  // 文件内偏移（字节）
+        uint64_t length;  // 长度（字节）
+        bool is_write;    // 是否为写请求
+    };
+
+    // 页缓存参数（页大小、容量与关联度取自 SimulatorConfig::cache_config）
+    struct PageCacheConfig
+    {
+        size_t max_readahead = 32;    // 最大预读窗口（页，0 表示关闭预读）
+        size_t flush_interval = 5000; // 定期回写的间隔（请求数，0 表示只在驱逐时回写）
+        size_t dirty_expire = 30000;  // 脏页超过该时长（请求数）后由定期回写写出
+        std::string io_trace;         // I/O 请求 trace 文件（为空时由访问模式生成请求）
+        size_t io_size = 0;           // 生成请求的长度（字节，0 表示一页）
+        size_t file_size = 16 << 20;  // 生成请求时每个文件的大小（字节）
+    };
+
+    // 页缓存统计（页的命中与缺失见缓存的 CacheStats）
+    struct PageCacheStats
+    {
+        uint64_t requests;        // 请求数
+        uint64_t read_requests;   // 读请求数
+        uint64_t write_requests;  // 写请求数
+        uint64_t read_bytes;      // 请求读取的字节数
+        uint64_t write_bytes;     // 请求写入的字节数
+        uint64_t disk_reads;      // 从存储读入的页数（按需、读改写与预读）
+        uint64_t partial_writes;  // 写缺失且未覆盖整页、需先读入的页数
+        uint64_t readahead_pages; // 预读装入的页数
+        uint64_t readahead_hits;  // 预读的页在被驱逐前被访问的页数
+        uint64_t readahead_windows; // 发起的预读窗口数
+        uint64_t flushed_pages;   // 定期回写写出的脏页数
+
+        PageCacheStats() : requests(0), read_requests(0), write_requests(0), read_bytes(0), write_bytes(0),
+                           disk_reads(0), partial_writes(0), readahead_pages(0), readahead_hits(0),
+                           readahead_windows(0), flushed_pages(0) {}
+
+        // 预读效率：预读的页中被实际使用的比例
+        double readaheadEfficiency() const
+        {
+            return readahead_pages > 0 ? static_cast<double>(readahead_hits) / readahead_pages : 0.0;
+        }
+    };
+
+    // 文件页缓存（类似 Linux 的 page cache / buffer cache）
+    // 以页为块复用 LRU / LFU 缓存的替换策略；每个文件维护一个按需预读窗口：
+    // 顺序缺页时以请求大小为基础打开初始窗口，访问到窗口中带预读标记的页时异步预读下一窗口，
+    // 窗口按 4 倍、2 倍增长至上限；随机缺页只读入请求的页。
+    // 脏页在驱逐时写回，并由定期回写把超过 dirty_expire 的脏页写出。
+    class PageCache
+    {
+    public:
+        // 文件编号与文件内偏移的上限（页以 文件编号 << kFileShift | 偏移 作为缓存地址）
+        static const size_t kFileShift = 44;
+        static const uint64_t kMaxFileId = uint64_t(1) << (64 - kFileShift);
+
+        PageCache(const CacheConfig &cache_config, ReplacementPolicy policy, const PageCacheConfig &config);
+
+        // 处理一次 I/O 请求，超出地址上限的请求被忽略并返回 false
+        bool access(const IoRequest &request);
+
+        // 清零统计（保留缓存内容与预读状态）
+        void resetStats();
+
+        const PageCacheStats &getStats() const { return stats_; }
+        const CacheStats &getCacheStats() const { return cache_->getStats(); }
+        const CacheConfig &getCacheConfig() const { return cache_->getConfig(); }
+
+        // 当前未写回的脏页数
+        size_t dirtyPages() const;
+
+        // 预读、标记与脏页各记录的条目总数（不超过缓存容量的常数倍）
+        size_t trackedEntries() const
+        {
+            return markers_.size() + readahead_unused_.size() + dirty_since_.size() + dirty_queue_.size();
+        }
+
+    private:
+        // 文件的预读状态
+        struct Readahead
+        {
+            uint64_t start = 0;      // 当前窗口的起始页
+            uint64_t size = 0;       // 窗口大小（页）
+            uint64_t async_size = 0; // 窗口末尾触发下一次异步预读的页数
+            uint64_t prev_page = std::numeric_limits<uint64_t>::max(); // 上一次访问的页
+        };
+
+        PageCacheConfig config_;
+        std::unique_ptr<Cache> cache_;
+        size_t page_bits_;
+        PageCacheStats stats_;
+        uint64_t now_ = 0; // 逻辑时间（请求数）
+
+        std::unordered_map<uint64_t, Readahead> readahead_;
+        std::unordered_set<uint64_t> markers_;          // 带预读标记的页
+        std::unordered_set<uint64_t> readahead_unused_; // 已预读、尚未被访问的页
+
+        // 脏页：页 -> 变脏时间，以及按变脏顺序排列的队列（关闭定期回写时不使用队列）
+        std::unordered_map<uint64_t, uint64_t> dirty_since_;
+        std::deque<std::pair<uint64_t, uint64_t>> dirty_queue_;
+
+        // 缓存驱逐的页，每次访问缓存后清除这些页的预读与脏页记录，使各记录不超过缓存容量
+        std::vector<uint64_t> evicted_;
+
+        uint64_t pageAddress(uint64_t file_id, uint64_t page) const
+        {
+            return (file_id << kFileShift) | (page << page_bits_);
+        }
+
+        void readPage(uint64_t file_id, uint64_t page, uint64_t request_pages);
+        void writePage(uint64_t file_id, uint64_t page, bool full_page);
+
+        // 缺页时的同步预读与命中预读标记时的异步预读
+        void syncReadahead(uint64_t file_id, uint64_t page, uint64_t request_pages);
+        void asyncReadahead(uint64_t file_id);
+        void submitReadahead(uint64_t file_id, const Readahead &ra);
+
+        // 写出超过 dirty_expire 的脏页
+        void flushExpired();
+
+        // 清除被驱逐的页的记录
+        void dropEvicted();
+    };
+
+    // 解析一行 I/O trace：<文件编号> <偏移> <长度> <R|W>，数值可带 0x 前缀
+    bool parseIoRequest(const std::string &line, IoRequest &request);
+
+} // namespace cache_sim
+
+#endif // PAGE_CACHE_H
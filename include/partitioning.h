@@ -0,0 +1,44 @@
+#ifndef PARTITIONING_H
+#define PARTITIONING_H
+
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 效用监视器（UMON）：为一个分区在采样组上维护全关联度的影子标签（LRU 栈），
+    // 按命中时所在的栈位置计数，由此得到该分区分配 1..W 路时的命中数
+    class UtilityMonitor
+    {
+    public:
+        // num_sets / ways: 被监视缓存的组数与关联度；每 sample_stride 组采样一组
+        UtilityMonitor(size_t num_sets, size_t ways, size_t block_size, size_t sample_stride = 32);
+
+        // 记录一次访问（set_index 为该地址在被监视缓存中的组）
+        void access(size_t set_index, uint64_t address);
+
+        // 分配 ways 路时在采样组上的命中数
+        uint64_t hitsWithWays(size_t ways) const;
+
+        // 各计数减半，使划分随程序阶段变化
+        void decay();
+
+    private:
+        size_t ways_;
+        size_t block_bits_;
+        size_t sample_stride_;
+        std::vector<std::vector<uint64_t>> tags_; // 采样组 -> 按最近使用排列的块号
+        std::vector<uint64_t> position_hits_;     // 各 LRU 栈位置的命中数
+    };
+
+    // 前瞻（lookahead）划分算法：每个分区至少一路，余下的路按边际效用（每路增加的命中数）最大者逐次分配
+    std::vector<size_t> lookaheadPartition(const std::vector<const UtilityMonitor *> &monitors, size_t ways);
+
+    // 按分配的路数生成连续、互不重叠的路掩码（分区 0 占最低位）
+    std::vector<uint64_t> contiguousWayMasks(const std::vector<size_t> &allocation);
+
+    // 掩码是否为一段连续的 1（CAT 要求容量位掩码连续）
+    bool isContiguousMask(uint64_t mask);
+
+} // namespace cache_sim
+
+#endif // PARTITIONING_H
@@ -0,0 +1,74 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // xoshiro256** 伪随机数生成器（Blackman & Vigna），由 kLanes 条独立的流交错组成
+    // 状态按“结构数组”存放，每次同时推进所有流，内层循环对各流做相同的移位、异或与乘法，
+    // 可由编译器自动向量化；逐个取数与批量填充产生完全相同的序列。
+    // 满足 UniformRandomBitGenerator 要求，可直接用于标准库分布。
+    class Xoshiro256
+    {
+    public:
+        using result_type = uint64_t;
+
+        // 并行推进的流数
+        static constexpr size_t kLanes = 4;
+
+        // seed: 种子；stream: 流编号，相同种子下不同编号产生互不相关的序列
+        explicit Xoshiro256(uint64_t seed = 0, uint64_t stream = 0);
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        // 下一个 64 位随机数
+        result_type operator()()
+        {
+            if (lane_ == kLanes)
+            {
+                step(buffer_);
+                lane_ = 0;
+            }
+            return buffer_[lane_++];
+        }
+
+        // [0, range) 内的均匀随机整数（Lemire 乘法取高位，无除法）
+        uint64_t bounded(uint64_t range)
+        {
+            return scale((*this)(), range);
+        }
+
+        // [0, 1) 内的均匀随机浮点数（53 位精度）
+        double nextDouble()
+        {
+            return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        // 将 64 位随机数按比例缩放到 [0, range)
+        static uint64_t scale(uint64_t value, uint64_t range)
+        {
+            __extension__ typedef unsigned __int128 uint128;
+            return static_cast<uint64_t>((static_cast<uint128>(value) * range) >> 64);
+        }
+
+        // 批量填充 count 个 64 位随机数
+        void fill(uint64_t *out, size_t count);
+
+        // 批量填充 count 个 [0, range) 内的均匀随机整数
+        void fillBounded(uint64_t *out, size_t count, uint64_t range);
+
+    private:
+        uint64_t s0_[kLanes], s1_[kLanes], s2_[kLanes], s3_[kLanes];
+        uint64_t buffer_[kLanes];
+        size_t lane_;
+
+        // 推进所有流一步，输出写入 out[0, kLanes)
+        void step(uint64_t *out);
+
+    };
+
+} // namespace cache_sim
+
+#endif // RANDOM_H
@@ -0,0 +1,83 @@
+#ifndef REUSE_DISTANCE_H
+#define REUSE_DISTANCE_H
+
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 复用距离直方图（按 2 的幂对数分桶）
+    // bins[0] 为距离 0，bins[k] (k >= 1) 为距离 [2^(k-1), 2^k - 1]
+    struct ReuseHistogram
+    {
+        std::vector<uint64_t> bins; // 各分桶计数
+        uint64_t cold;              // 首次访问或超出跟踪窗口的访问（距离视为无穷大）
+        uint64_t total;             // 总访问次数
+
+        ReuseHistogram() : cold(0), total(0) {}
+
+        // 记录一次有限复用距离
+        void add(uint64_t distance);
+
+        // 记录一次无穷大复用距离
+        void addCold();
+
+        // 分桶下标对应的距离下界与上界
+        static uint64_t binLowerBound(size_t bin);
+        static uint64_t binUpperBound(size_t bin);
+
+        // 以 JSON 对象格式输出，indent 为每行缩进
+        void writeJson(std::ostream &os, const std::string &indent) const;
+    };
+
+    // 复用距离（栈距离）分析器
+    // 以块为粒度统计两次访问同一块之间访问过的不同块数量。
+    // 使用 Fenwick 树按“最后访问时间槽”计数，每次访问 O(log n)；
+    // 时间槽用尽时压缩重编号，跟踪的块数超过上限时丢弃最久未访问的块，
+    // 因此内存占用只与跟踪上限有关，与访问流长度无关。
+    class ReuseDistanceProfiler
+    {
+    public:
+        // 首次访问返回的距离值
+        static constexpr uint64_t kColdDistance = std::numeric_limits<uint64_t>::max();
+
+        // block_size: 块大小（字节）
+        // max_tracked_blocks: 最多跟踪的不同块数量
+        explicit ReuseDistanceProfiler(size_t block_size, size_t max_tracked_blocks = 1 << 20);
+
+        // 记录一次访问，返回该访问的复用距离
+        uint64_t access(uint64_t address);
+
+        // 获取直方图
+        const ReuseHistogram &getHistogram() const { return histogram_; }
+
+        // 清零直方图（保留各块的最后访问时间）
+        void resetHistogram() { histogram_ = ReuseHistogram(); }
+
+        // 当前跟踪的不同块数量
+        size_t trackedBlocks() const { return last_slot_.size(); }
+
+    private:
+        size_t block_bits_;
+        size_t max_tracked_blocks_;
+
+        // 块地址 -> 最后一次访问的时间槽
+        std::unordered_map<uint64_t, uint64_t> last_slot_;
+
+        // Fenwick 树（下标从 1 开始），槽位为 1 表示某块最后一次访问位于该槽
+        std::vector<uint32_t> tree_;
+
+        // 下一个可用时间槽
+        uint64_t next_slot_;
+
+        ReuseHistogram histogram_;
+
+        void treeAdd(uint64_t slot, int delta);
+        uint64_t treePrefix(uint64_t slot) const;
+
+        // 重新编号所有存活的块并重建 Fenwick 树
+        void compact();
+    };
+
+} // namespace cache_sim
+
+#endif // REUSE_DISTANCE_H
@@ -0,0 +1,58 @@
+#ifndef SET_STATS_H
+#define SET_STATS_H
+
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 单个缓存组的统计（需以 CACHE_SIM_SET_STATS 编译才会在缓存中收集）
+    struct SetStats
+    {
+        uint64_t accesses;  // 访问次数
+        uint64_t misses;    // 缺失次数
+        uint64_t evictions; // 驱逐次数
+
+        SetStats() : accesses(0), misses(0), evictions(0) {}
+    };
+
+    // 组间分布偏斜度摘要
+    struct SkewSummary
+    {
+        uint64_t max;          // 最大值
+        double mean;           // 平均值
+        double max_mean_ratio; // 最大值 / 平均值
+        double gini;           // 基尼系数（0 表示完全均匀，趋近 1 表示集中在少数组）
+
+        SkewSummary() : max(0), mean(0.0), max_mean_ratio(0.0), gini(0.0) {}
+    };
+
+    // 组采样的外推结果
+    // 以组为整群抽样单位，缺失率用比率估计量 r = sum(misses) / sum(accesses)，
+    // 其方差按整群抽样公式（含有限总体校正）估计
+    struct SamplingEstimate
+    {
+        size_t sampled_sets;       // 采样组数
+        size_t total_sets;         // 总组数
+        uint64_t sampled_accesses; // 采样组内的访问次数
+        uint64_t total_accesses;   // 全部访问次数
+        double miss_rate;          // 估计缺失率
+        double miss_rate_ci;       // 缺失率 95% 置信区间半宽
+
+        SamplingEstimate() : sampled_sets(0), total_sets(0), sampled_accesses(0), total_accesses(0), miss_rate(0.0), miss_rate_ci(0.0) {}
+    };
+
+    // 由各采样组的统计估计缺失率（sampled 中每项为一个采样组）
+    SamplingEstimate estimateFromSample(const std::vector<SetStats> &sampled, size_t total_sets, uint64_t total_accesses);
+
+    // 计算一组计数的偏斜度摘要
+    SkewSummary computeSkew(const std::vector<uint64_t> &counts);
+
+    // 计算各组指定字段的偏斜度摘要
+    SkewSummary computeSkew(const std::vector<SetStats> &sets, uint64_t SetStats::*field);
+
+    // 以 CSV 格式输出原始热力图数据（每组一行）
+    void writeSetHeatmap(std::ostream &os, int core_id, const std::vector<SetStats> &sets);
+
+} // namespace cache_sim
+
+#endif // SET_STATS_H
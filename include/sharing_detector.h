@@ -0,0 +1,84 @@
+#ifndef SHARING_DETECTOR_H
+#define SHARING_DETECTOR_H
+
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 单个数据块的共享缺失统计
+    struct BlockSharingReport
+    {
+        uint64_t block_address;  // 块起始地址
+        uint64_t true_sharing;   // 真共享缺失次数
+        uint64_t false_sharing;  // 伪共享缺失次数
+        uint64_t invalidations;  // 该块副本被作废的次数
+        size_t cores;            // 访问过该块的核心数
+        size_t written_bytes;    // 被任一核心写过的字节数
+        bool overlapping_writes; // 是否有字节被多个核心写过
+
+        uint64_t coherenceMisses() const { return true_sharing + false_sharing; }
+    };
+
+    // 真共享 / 伪共享检测器
+    // 副本因其他核心写入而被作废后，记录此后其他核心写过的字节；该核心再次访问这一块
+    // （即一致性缺失）时，若访问的字节与这些字节相交则为真共享，否则为伪共享。
+    // 只为发生过作废的“活跃”块保存每核心的字节位图，内存占用与共享块数量成正比。
+    class SharingDetector
+    {
+    public:
+        // block_size: 块大小（字节）
+        // num_cores: 核心数（最多 64 个）
+        SharingDetector(size_t block_size, size_t num_cores);
+
+        // 记录一次访问（应在访问缓存之前调用）
+        // 若该核心的副本此前被作废，将本次访问归类为真共享或伪共享缺失
+        void access(size_t core_id, uint64_t address, size_t size, bool is_write);
+
+        // 记录 writer_id 的写请求（地址含块内偏移）作废了 core_id 的副本
+        void invalidate(size_t core_id, size_t writer_id, uint64_t address, size_t size);
+
+        // 真共享缺失总数
+        uint64_t trueSharingMisses() const { return true_sharing_; }
+
+        // 伪共享缺失总数
+        uint64_t falseSharingMisses() const { return false_sharing_; }
+
+        // 清零缺失与作废计数（保留各块的作废与写入记录）
+        void resetStats();
+
+        // 跟踪的活跃块数量
+        size_t trackedBlocks() const { return blocks_.size(); }
+
+        // 按一致性缺失次数降序返回前 count 个块
+        std::vector<BlockSharingReport> topBlocks(size_t count) const;
+
+    private:
+        // 每个活跃块的状态，位图按核心连续存放，每核心 words_per_mask_ 个 64 位字
+        struct BlockRecord
+        {
+            std::vector<uint64_t> touched; // 各核心访问过的字节
+            std::vector<uint64_t> written; // 各核心写过的字节
+            std::vector<uint64_t> remote;  // 各核心副本作废后被其他核心写过的字节
+            uint64_t pending;              // 副本已被作废、尚未再次访问的核心位图
+            uint64_t true_sharing;
+            uint64_t false_sharing;
+            uint64_t invalidations;
+        };
+
+        size_t block_size_;
+        size_t num_cores_;
+        size_t words_per_mask_;
+        uint64_t true_sharing_;
+        uint64_t false_sharing_;
+        std::unordered_map<uint64_t, BlockRecord> blocks_;
+
+        // 将 [offset, offset + size) 字节在 mask 中置位
+        void setBytes(uint64_t *mask, size_t offset, size_t size) const;
+
+        // 判断 [offset, offset + size) 字节在 mask 中是否有置位
+        bool testBytes(const uint64_t *mask, size_t offset, size_t size) const;
+    };
+
+} // namespace cache_sim
+
+#endif // SHARING_DETECTOR_H
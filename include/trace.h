@@ -0,0 +1,244 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // trace 文件格式
+    enum class TraceFormat
+    {
+        Auto,     // 按扩展名推断
+        Din,      // Dinero III/IV din 文本格式：<标签> <十六进制地址>
+        Lackey,   // Valgrind Lackey（--trace-mem=yes）输出
+        ChampSim, // ChampSim 未压缩二进制指令 trace
+        Native    // 本模拟器的压缩格式：分块、增量 + zigzag 变长整数编码，可随机定位
+    };
+
+    // trace 中的一条数据访问
+    struct TraceRecord
+    {
+        uint64_t address; // 访问地址
+        bool is_write;    // 是否为写操作
+    };
+
+    // 解析格式名称（din, lackey, champsim, native）
+    bool parseTraceFormat(const std::string &name, TraceFormat &format);
+
+    // 按扩展名推断格式，无法推断时返回 Auto
+    TraceFormat guessTraceFormat(const std::string &path);
+
+    // 获取格式名称
+    std::string getTraceFormatName(TraceFormat format);
+
+    // trace 读取器基类，提供带缓冲的逐条读取
+    class TraceReader
+    {
+    public:
+        virtual ~TraceReader() = default;
+
+        // 读取下一条记录，trace 结束时返回 false
+        bool next(TraceRecord &record)
+        {
+            if (pos_ == count_)
+            {
+                count_ = read(buffer_.data(), buffer_.size());
+                pos_ = 0;
+                if (count_ == 0)
+                {
+                    return false;
+                }
+            }
+            record = buffer_[pos_++];
+            return true;
+        }
+
+        // 批量读取至多 max 条记录，返回实际条数，0 表示 trace 结束
+        virtual size_t read(TraceRecord *out, size_t max) = 0;
+
+        // 接管读取器所用输入流的所有权
+        void ownStream(std::unique_ptr<std::istream> stream) { owned_stream_ = std::move(stream); }
+
+    protected:
+        TraceReader() : buffer_(4096), pos_(0), count_(0) {}
+
+    private:
+        std::unique_ptr<std::istream> owned_stream_;
+        std::vector<TraceRecord> buffer_;
+        size_t pos_;
+        size_t count_;
+    };
+
+    // 打开 trace 文件（文本格式可用 "-" 表示标准输入），失败时返回空指针
+    // decode_threads: 压缩格式的解码线程数
+    std::unique_ptr<TraceReader> openTrace(const std::string &path, TraceFormat format, size_t decode_threads);
+
+    // Dinero din 格式读取器：标签 0 为读、1 为写，取指（2）及其他标签被忽略
+    class DinTraceReader : public TraceReader
+    {
+    public:
+        explicit DinTraceReader(std::istream &in) : in_(in) {}
+        size_t read(TraceRecord *out, size_t max) override;
+
+    private:
+        std::istream &in_;
+    };
+
+    // Valgrind Lackey 格式读取器：L 为读、S 为写、M 为读后写，取指（I）与注释行被忽略
+    class LackeyTraceReader : public TraceReader
+    {
+    public:
+        explicit LackeyTraceReader(std::istream &in) : in_(in), pending_write_(false), pending_address_(0) {}
+        size_t read(TraceRecord *out, size_t max) override;
+
+    private:
+        std::istream &in_;
+        bool pending_write_; // M 操作拆成的写尚未输出
+        uint64_t pending_address_;
+    };
+
+    // ChampSim 二进制格式读取器：每条 64 字节的指令记录，源内存操作数为读、目的内存操作数为写
+    // （ChampSim 的 .xz 文件需先解压，例如 xz -dc trace.xz | cache_sim --trace - ...）
+    class ChampSimTraceReader : public TraceReader
+    {
+    public:
+        explicit ChampSimTraceReader(std::istream &in) : in_(in) {}
+        size_t read(TraceRecord *out, size_t max) override;
+
+    private:
+        std::istream &in_;
+        std::deque<TraceRecord> pending_; // 一条指令可产生多次访问
+    };
+
+    // 压缩格式文件布局（小端）：
+    //   文件头 16 字节：魔数 "CSTRACE\0"、版本号 uint32、保留 uint32
+    //   若干数据块：每条记录为变长整数 (zigzag(地址 - 块内上一地址) << 1) | 写标记，
+    //              每块的第一条相对 0 编码，因此各块可独立解码
+    //   块索引：每块 {偏移 uint64, 字节数 uint32, 记录数 uint32}
+    //   文件尾 24 字节：索引偏移 uint64、块数 uint64、魔数 "CSTRIDX\0"
+    class NativeTraceWriter
+    {
+    public:
+        // chunk_records: 每块的记录数
+        explicit NativeTraceWriter(const std::string &path, size_t chunk_records = 1 << 16);
+        ~NativeTraceWriter();
+
+        bool ok() const { return static_cast<bool>(out_); }
+
+        // 追加一条记录，地址超过 2^62 时返回 false
+        bool add(const TraceRecord &record);
+
+        // 写出最后一块与索引
+        bool close();
+
+        uint64_t records() const { return records_; }
+        uint64_t bytesWritten() const { return bytes_written_; }
+
+    private:
+        struct ChunkInfo
+        {
+            uint64_t offset;
+            uint32_t bytes;
+            uint32_t records;
+        };
+
+        std::ofstream out_;
+        size_t chunk_records_;
+        std::vector<uint8_t> chunk_;
+        uint32_t chunk_count_;
+        uint64_t previous_;
+        std::vector<ChunkInfo> index_;
+        uint64_t records_;
+        uint64_t bytes_written_;
+        bool closed_;
+
+        void flushChunk();
+    };
+
+    // 压缩格式读取器
+    // 后台线程按块并行读取与解码，最多领先消费者 2 * 线程数 个块，
+    // 块按顺序交付，磁盘 I/O 与解码因此与模拟重叠进行。
+    class NativeTraceReader : public TraceReader
+    {
+    public:
+        // threads: 解码线程数（至少 1）
+        // start_chunk: 从第几块开始读取
+        NativeTraceReader(const std::string &path, size_t threads, size_t start_chunk = 0);
+        ~NativeTraceReader() override;
+
+        bool ok() const { return ok_; }
+
+        size_t numChunks() const { return index_.size(); }
+        uint64_t totalRecords() const { return total_records_; }
+
+        size_t read(TraceRecord *out, size_t max) override;
+
+    private:
+        struct ChunkInfo
+        {
+            uint64_t offset;
+            uint32_t bytes;
+            uint32_t records;
+        };
+
+        std::string path_;
+        std::vector<ChunkInfo> index_;
+        uint64_t total_records_;
+        bool ok_;
+
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::map<size_t, std::vector<TraceRecord>> ready_; // 已解码、待交付的块
+        size_t next_to_decode_;
+        size_t next_to_consume_;
+        size_t window_;
+        bool stop_;
+
+        std::vector<TraceRecord> current_;
+        size_t current_pos_;
+
+        bool readIndex();
+        void workerLoop();
+    };
+
+    // 变长整数与 zigzag 编码
+    inline uint64_t zigzagEncode(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t zigzagDecode(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    inline void putVarint(std::vector<uint8_t> &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // 从 [pos, end) 解码一个变长整数，数据不完整时返回 false
+    inline bool getVarint(const uint8_t *&pos, const uint8_t *end, uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < end; shift += 7)
+        {
+            uint8_t byte = *pos++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace cache_sim
+
+#endif // TRACE_H
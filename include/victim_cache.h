@@ -0,0 +1,65 @@
+#ifndef VICTIM_CACHE_H
+#define VICTIM_CACHE_H
+
+#include "cache_line.h"
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 附加小缓存的工作模式
+    enum class VictimCacheMode
+    {
+        Victim, // 受害者缓存：保存从 L1 驱逐的行，命中时与 L1 交换
+        Miss    // 缺失缓存：保存每次缺失填充的行副本，命中时复制回 L1
+    };
+
+    // 受害者缓存中的一项
+    struct VictimEntry
+    {
+        bool valid;                // 有效位
+        bool dirty;                // 脏位
+        bool from_conflict;        // 是否因 L1 冲突驱逐而进入（或在缺失缓存中被 L1 驱逐过）
+        uint64_t block_address;    // 块起始地址
+        MESIState state;           // MESI 状态
+        uint64_t last_access_time; // 最后访问时间（用于 LRU）
+
+        VictimEntry()
+            : valid(false), dirty(false), from_conflict(false), block_address(0), state(MESIState::Invalid), last_access_time(0) {}
+    };
+
+    // 全相联的受害者缓存 / 缺失缓存（Jouppi），条目数很少，使用 LRU 替换
+    class VictimCache
+    {
+    public:
+        explicit VictimCache(size_t num_entries);
+
+        // 查找块地址对应的项
+        VictimEntry *find(uint64_t block_address);
+
+        // 插入一项，返回被挤出的项（没有挤出时 valid 为 false）
+        VictimEntry insert(const VictimEntry &entry);
+
+        // 移除一项
+        void remove(VictimEntry *entry);
+
+        // 更新一项的访问时间
+        void touch(VictimEntry *entry);
+
+        // 条目数
+        size_t size() const { return entries_.size(); }
+
+        // 第 i 个条目（可能无效）
+        VictimEntry &at(size_t i) { return entries_[i]; }
+
+        // 以二进制保存与恢复全部条目（恢复时条目数必须相同）
+        void save(std::ostream &os) const;
+        bool load(std::istream &is);
+
+    private:
+        std::vector<VictimEntry> entries_;
+        uint64_t access_clock_;
+    };
+
+} // namespace cache_sim
+
+#endif // VICTIM_CACHE_H
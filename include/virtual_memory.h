@@ -0,0 +1,144 @@
+#ifndef VIRTUAL_MEMORY_H
+#define VIRTUAL_MEMORY_H
+
+#include "cache.h"
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 页面置换算法
+    enum class PageReplacement
+    {
+        Clock,   // 时钟（二次机会）算法
+        WSClock, // 工作集时钟：未引用且超出工作集窗口的页才被置换，脏页先写回
+        LRU      // 精确 LRU
+    };
+
+    // 一级 TLB 的配置
+    struct TlbLevelConfig
+    {
+        size_t entries;       // 条目数
+        size_t associativity; // 关联度
+    };
+
+    // 虚拟内存配置
+    struct VirtualMemoryConfig
+    {
+        size_t page_size = 4096;                                     // 页大小（字节，2 的幂）
+        std::vector<TlbLevelConfig> tlb_levels = {{64, 4}, {1536, 12}}; // 各级 TLB，从 L1 开始
+        size_t page_table_levels = 4;                                // 页表级数
+        size_t physical_frames = 0;                                  // 物理页框数（0 表示不限，不发生置换）
+        PageReplacement page_replacement = PageReplacement::Clock;   // 页面置换算法
+        size_t wsclock_window = 10000;                               // WSClock 工作集窗口（访问次数）
+    };
+
+    // 虚拟内存统计
+    struct VirtualMemoryStats
+    {
+        uint64_t translations;   // 地址转换次数
+        uint64_t page_walks;     // 页表遍历次数（TLB 全部缺失）
+        uint64_t pte_accesses;   // 经数据缓存读取页表项的次数
+        uint64_t pte_cache_hits; // 页表项读取在数据缓存中命中的次数
+        uint64_t page_faults;    // 缺页次数
+        uint64_t major_faults;   // 需要从交换区换入的缺页次数（页曾被置换出去）
+        uint64_t page_evictions; // 页面置换次数
+        uint64_t swap_outs;      // 脏页写回交换区的次数
+        uint64_t tlb_shootdowns; // 置换页面时作废的 TLB 条目数
+
+        VirtualMemoryStats() : translations(0), page_walks(0), pte_accesses(0), pte_cache_hits(0), page_faults(0),
+                               major_faults(0), page_evictions(0), swap_outs(0), tlb_shootdowns(0) {}
+    };
+
+    // 虚拟内存层：位于数据缓存之前，把各核心的虚拟地址转换为物理地址
+    // - 每个核心有多级 TLB，每级都是以虚拟页号为地址、块大小为 1 的组相联 LRUCache；
+    // - TLB 全部缺失时按基数树页表逐级读取页表项，页表项的物理地址经该核心的数据缓存访问；
+    // - 页不在内存时缺页，分配空闲页框或按置换算法选出牺牲页，牺牲页的 TLB 条目与缓存块被作废。
+    // 所有核心共享同一地址空间与页表，页表页常驻内存，不参与置换。
+    class VirtualMemory
+    {
+    public:
+        // data_caches: 各核心的数据缓存（页表项读取与置换时的作废经过这些缓存）
+        VirtualMemory(const VirtualMemoryConfig &config, const std::vector<std::unique_ptr<Cache>> &data_caches);
+
+        // 转换一次访问的地址，返回物理地址
+        uint64_t translate(size_t core_id, uint64_t address, bool is_write);
+
+        // 清零统计（保留 TLB、页表与页框内容）
+        void resetStats();
+
+        const VirtualMemoryConfig &getConfig() const { return config_; }
+        const VirtualMemoryStats &getStats() const { return stats_; }
+
+        // 核心 core_id 第 level 级 TLB 的统计
+        const CacheStats &getTlbStats(size_t core_id, size_t level) const { return tlbs_[core_id][level]->getStats(); }
+
+        // 驻留页数与页表占用的页数
+        size_t residentPages() const { return resident_pages_; }
+        size_t pageTablePages() const { return page_table_nodes_.size(); }
+
+        // 获取页面置换算法的名称
+        static std::string getReplacementName(PageReplacement replacement);
+
+    private:
+        // 页表项
+        struct PageTableEntry
+        {
+            uint64_t frame = 0;    // 页框号
+            bool present = false;  // 是否在内存中
+            bool swapped = false;  // 是否曾被置换到交换区
+        };
+
+        // 物理页框
+        struct Frame
+        {
+            uint64_t vpn = 0;          // 所装入页的虚拟页号
+            bool used = false;         // 是否已分配
+            bool referenced = false;   // 引用位
+            bool dirty = false;        // 脏位
+            uint64_t last_use = 0;     // 最后使用时间（访问序号）
+        };
+
+        // 页表项在页表页中的大小（字节）
+        static const uint64_t kPteSize = 8;
+
+        // 页表页所在的物理地址区间起点，与数据页框不重叠
+        static const uint64_t kPageTableBase = uint64_t(1) << 56;
+
+        VirtualMemoryConfig config_;
+        const std::vector<std::unique_ptr<Cache>> &data_caches_;
+        std::vector<std::vector<std::unique_ptr<Cache>>> tlbs_; // [核心][级]
+        VirtualMemoryStats stats_;
+
+        size_t page_bits_;
+        size_t index_bits_; // 每级页表的索引位数（一页页表可容纳的页表项数的对数）
+
+        std::unordered_map<uint64_t, PageTableEntry> page_table_;
+        std::unordered_map<uint64_t, uint64_t> page_table_nodes_; // (级, 前缀) -> 页表页编号
+
+        std::vector<Frame> frames_;
+        size_t resident_pages_ = 0;
+        size_t clock_hand_ = 0;
+        uint64_t now_ = 0;
+
+        // LRU 置换：链表头部为最近使用的页框
+        std::list<size_t> lru_list_;
+        std::vector<std::list<size_t>::iterator> lru_position_;
+
+        // 遍历页表，逐级经数据缓存读取页表项
+        void walk(size_t core_id, uint64_t vpn);
+
+        // 缺页处理：为 vpn 分配页框
+        void pageFault(uint64_t vpn, PageTableEntry &pte);
+
+        // 选择牺牲页框
+        size_t selectVictimFrame();
+        size_t selectClockVictim();
+        size_t selectWSClockVictim();
+
+        // 将页框中的页置换出去
+        void evictFrame(size_t frame);
+    };
+
+} // namespace cache_sim
+
+#endif // VIRTUAL_MEMORY_H
@@ -0,0 +1,185 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "random.h"
+#include "zipf.h"
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 访问模式
+    enum class AccessPattern
+    {
+        Random,           // 随机访问
+        Sequential,       // 顺序访问
+        Localized,        // 局部性访问
+        ProducerConsumer, // 生产者/消费者队列：组内 0 号核心顺序写入，其余核心滞后一块读取
+        Migratory,        // 迁移对象：每个对象依次被组内各核心读-改-写
+        ReadMostly,       // 读多写少的共享表：组内核心随机读，按写比例偶尔写入（未指定写比例时为 2%）
+        LockContention,   // 自旋锁竞争：组内核心反复测试、获取、释放同一锁块并访问临界区数据
+        Zipfian,          // 键值访问：键的热度服从 Zipf 分布，热键集中在低地址
+        ScrambledZipfian, // 键值访问：Zipf 热度经散列打乱，热键分散在整个键空间
+        Hotspot,          // 键值访问：hot_access 比例的访问落在前 hot_fraction 的键上
+        Latest            // 键值访问：写入追加新键，读取偏向最近写入的键
+    };
+
+    // 多个核心访问流的交织方式
+    enum class StreamInterleave
+    {
+        RoundRobin, // 轮流发出访问
+        Weighted    // 按权重平滑加权轮转
+    };
+
+    // 单个核心的负载参数
+    struct CoreWorkload
+    {
+        AccessPattern pattern;     // 访问模式
+        uint64_t address_base;     // 地址区间起始
+        size_t address_range;      // 地址区间大小（字节）；共享模式下为每个共享组的数据量
+        size_t working_set_period; // 工作集切换周期（本核心访问次数）
+        size_t working_set_size;   // 工作集大小（字节）
+        double write_ratio;        // 写操作比例 [0, 1]（生产者/消费者、迁移与锁竞争模式由模式本身决定读写）
+        unsigned weight;           // 加权交织时的权重
+        size_t sharers;            // 共享度：每组共享同一份数据的核心数（0 表示全部核心）
+        double zipf_theta;         // 键值模式的 Zipf 偏斜指数
+        size_t object_size;        // 键值模式中每个键对应对象的大小（字节，0 表示一块），可跨多块
+        double hot_fraction;       // 热点模式中热键占全部键的比例
+        double hot_access;         // 热点模式中访问热键的比例
+
+        CoreWorkload()
+            : pattern(AccessPattern::Random), address_base(0), address_range(1048576), working_set_period(10000),
+              working_set_size(65536), write_ratio(0.25), weight(1), sharers(0), zipf_theta(0.99), object_size(0),
+              hot_fraction(0.2), hot_access(0.8) {}
+    };
+
+    // 判断访问模式是否为多核共享模式
+    bool isSharingPattern(AccessPattern pattern);
+
+    // 判断访问模式是否为键值模式
+    bool isKeyValuePattern(AccessPattern pattern);
+
+    // 未指定写比例时访问模式的默认写比例
+    double defaultWriteRatio(AccessPattern pattern);
+
+    // 单个核心的访问流
+    // 每个核心拥有独立的访问计数与随机数引擎；读写按写比例以类 Bresenham 方式确定性地分布，
+    // 例如写比例 0.25 时恰好每 4 次访问中第 1 次为写。
+    // 访问以 kBatchSize 为单位批量生成：每批只分派一次模式，共享模式的内层循环只含整数运算，
+    // 可由编译器向量化。
+    class WorkloadStream
+    {
+    public:
+        // 每批生成的访问数
+        static constexpr size_t kBatchSize = 256;
+
+        // block_size: 块大小（字节），顺序访问以块为步长
+        // core_id / num_cores: 本核心编号与核心总数，用于共享模式划分共享组与角色
+        // seed: 随机数种子，各核心以 core_id 作为流编号，相同种子产生相同的访问流
+        WorkloadStream(const CoreWorkload &workload, size_t block_size, size_t core_id, size_t num_cores, uint64_t seed);
+
+        // 生成下一次访问
+        void next(uint64_t &address, bool &is_write)
+        {
+            if (cursor_ == kBatchSize)
+            {
+                refill();
+            }
+            address = addresses_[cursor_];
+            is_write = writes_[cursor_] != 0;
+            ++cursor_;
+        }
+
+        // 批量生成 count 次访问
+        void fill(uint64_t *addresses, uint8_t *writes, size_t count);
+
+        // 获取负载参数
+        const CoreWorkload &getWorkload() const { return workload_; }
+
+    private:
+        // 写比例的定点表示（分母为 2^32）
+        static constexpr uint64_t kWriteScale = uint64_t(1) << 32;
+
+        // 共享数据的访问粒度（字节）
+        static constexpr size_t kWordSize = 8;
+
+        CoreWorkload workload_;
+        size_t block_size_;
+        size_t index_;         // 本核心已发出的访问数
+        uint64_t write_step_;  // 每次访问累加的写额度
+        uint64_t write_error_; // 累积的写额度，达到 kWriteScale 时发出一次写
+        Xoshiro256 rng_;
+
+        // 共享模式参数
+        uint64_t group_base_; // 本核心所在共享组的数据起始地址
+        size_t rank_;         // 本核心在组内的序号
+        size_t group_size_;   // 组内核心数
+        size_t words_;        // 组内数据的字数
+
+        // 键值模式状态：每个键对应一个对象，选中一个键后依次访问对象的每一块
+        ZipfSampler zipf_;
+        uint64_t num_keys_;
+        size_t object_size_;
+        size_t object_blocks_;   // 每个对象跨越的块数
+        size_t object_block_;    // 当前对象中下一个要访问的块
+        uint64_t object_base_;   // 当前对象的起始偏移
+        bool object_write_;      // 当前对象是读还是写
+        uint64_t latest_key_;    // Latest 模式中最近写入的键
+
+        // 批量缓冲
+        std::vector<uint64_t> addresses_;
+        std::vector<uint8_t> writes_;
+        std::vector<uint64_t> scratch_; // 批量生成的随机数
+        size_t cursor_;
+
+        void refill();
+
+        // 按写比例决定下一次访问是否为写
+        bool nextWrite()
+        {
+            write_error_ += write_step_;
+            bool is_write = write_error_ >= kWriteScale;
+            write_error_ -= is_write ? kWriteScale : 0;
+            return is_write;
+        }
+
+        // 按写比例生成读写标记
+        void fillWriteRatio(uint8_t *writes, size_t count);
+
+        // 按键值模式选出下一个键
+        uint64_t nextKey(bool is_write);
+
+        // 各模式的批量地址生成，返回相对地址区间（或共享组）的偏移
+        void fillRandom(uint64_t *addresses, size_t count);
+        void fillSequential(uint64_t *addresses, size_t count);
+        void fillLocalized(uint64_t *addresses, size_t count);
+        void fillProducerConsumer(uint64_t *addresses, uint8_t *writes, size_t count);
+        void fillMigratory(uint64_t *addresses, uint8_t *writes, size_t count);
+        void fillLockContention(uint64_t *addresses, uint8_t *writes, size_t count);
+        void fillKeyValue(uint64_t *addresses, uint8_t *writes, size_t count);
+    };
+
+    // 按交织方式选择下一个发出访问的核心
+    class StreamScheduler
+    {
+    public:
+        StreamScheduler(const std::vector<unsigned> &weights, StreamInterleave mode);
+
+        // 返回下一个核心编号（不返回已退出的核心，全部退出时返回 0）
+        size_t next();
+
+        // 核心的访问源已结束：此后不再选中该核心，其权重从总权重中扣除
+        void retire(size_t core);
+
+    private:
+        StreamInterleave mode_;
+        std::vector<int64_t> weights_;
+        std::vector<int64_t> current_; // 平滑加权轮转的当前权重
+        std::vector<bool> retired_;    // 已退出的核心
+        size_t active_;                // 未退出的核心数
+        int64_t total_weight_;
+        size_t next_core_;
+    };
+
+} // namespace cache_sim
+
+#endif // WORKLOAD_H
@@ -0,0 +1,56 @@
+#ifndef WRITE_BUFFER_H
+#define WRITE_BUFFER_H
+
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // 写缓冲排空到主存的结果
+    struct WriteBufferDrain
+    {
+        uint64_t writes; // 写入主存的事务数
+        uint64_t bytes;  // 写入主存的字节数
+        std::vector<uint64_t> blocks; // 写入主存的块地址
+
+        WriteBufferDrain() : writes(0), bytes(0) {}
+    };
+
+    // 合并写缓冲
+    // 以块为单位暂存写往主存的数据，同一块的多次写入合并为一次主存写事务，
+    // 满时按 FIFO 顺序排空最早的一项。
+    class WriteBuffer
+    {
+    public:
+        // num_entries: 条目数
+        // block_size: 块大小（字节）
+        WriteBuffer(size_t num_entries, size_t block_size);
+
+        // 写入 [offset, offset + size) 字节
+        // coalesced 返回是否与已有条目合并
+        // 返回因缓冲已满而排空到主存的数据
+        WriteBufferDrain add(uint64_t block_address, size_t offset, size_t size, bool &coalesced);
+
+        // 排空全部条目
+        WriteBufferDrain flush();
+
+        // 当前占用的条目数
+        size_t occupancy() const { return entries_.size(); }
+
+    private:
+        struct Entry
+        {
+            uint64_t block_address;
+            std::vector<uint64_t> byte_mask; // 每个字节一位
+        };
+
+        size_t num_entries_;
+        size_t block_size_;
+        std::deque<Entry> entries_;
+
+        // 排空最早的一项
+        WriteBufferDrain drainOldest();
+    };
+
+} // namespace cache_sim
+
+#endif // WRITE_BUFFER_H
@@ -0,0 +1,69 @@
+#ifndef ZIPF_H
+#define ZIPF_H
+
+#include "random.h"
+#include <bits/stdc++.h>
+
+namespace cache_sim
+{
+    // Zipf 分布采样器（Hörmann & Derflinger 拒绝-反演法）
+    // 返回 [1, n] 内的秩，P(k) 正比于 1 / k^theta。每次采样期望 O(1)，
+    // 与 n 无关，不需要预先计算 CDF，因此 n 可以达到 1e9 量级。
+    class ZipfSampler
+    {
+    public:
+        // n: 元素数量（>= 1）
+        // theta: 偏斜指数（>= 0，0 为均匀分布）
+        explicit ZipfSampler(uint64_t n = 1, double theta = 0.99);
+
+        // 采样一个秩
+        uint64_t sample(Xoshiro256 &rng) const
+        {
+            while (true)
+            {
+                double u = h_integral_n_ + rng.nextDouble() * (h_integral_x1_ - h_integral_n_);
+                double x = hIntegralInverse(u);
+                double k = std::floor(x + 0.5);
+                if (k < 1.0)
+                {
+                    k = 1.0;
+                }
+                else if (k > static_cast<double>(n_))
+                {
+                    k = static_cast<double>(n_);
+                }
+
+                // 大多数情况下第一个条件即可接受，无需计算 h 的积分
+                if (k - x <= s_ || u >= hIntegral(k + 0.5) - h(k))
+                {
+                    return static_cast<uint64_t>(k);
+                }
+            }
+        }
+
+        uint64_t size() const { return n_; }
+        double theta() const { return theta_; }
+
+    private:
+        uint64_t n_;
+        double theta_;
+        double h_integral_x1_;
+        double h_integral_n_;
+        double s_;
+
+        // h(x) = x^-theta 及其积分与积分的反函数
+        double h(double x) const;
+        double hIntegral(double x) const;
+        double hIntegralInverse(double x) const;
+
+        // log1p(x) / x 与 expm1(x) / x，在 x 接近 0 时使用泰勒展开保持精度
+        static double helper1(double x);
+        static double helper2(double x);
+    };
+
+    // FNV-1a 64 位散列，用于打乱 Zipf 秩与键的对应关系
+    uint64_t fnvHash64(uint64_t value);
+
+} // namespace cache_sim
+
+#endif // ZIPF_H
@@ -0,0 +1,96 @@
+import subprocess
+import pandas as pd
+import os
+from matplotlib import pyplot as plt
+import seaborn as sns
+
+# 确保输出目录存在
+os.makedirs("outputs", exist_ok=True)
+
+# 配置参数
+num_accesses = 200000
+cache_size = 64 * 1024
+access_pattern = "localized"
+associativity = 4
+ws_period = 20000
+interval = 1000
+
+executable_path = "./build/cache_sim"
+working_dir = ".."
+
+base_filename = f"outputs/cache_hit_rate_timeline_n{num_accesses}_s{cache_size}_p{access_pattern}_a{associativity}_w{ws_period}"
+
+results = {}
+
+# 只需运行一次模拟，通过区间统计得到命中率随时间变化的曲线
+for policy in ["lru", "lfu"]:
+    interval_path = os.path.abspath(f"{base_filename}_{policy}_intervals.csv")
+    cmd = [
+        executable_path,
+        "-n", str(num_accesses),
+        "-s", str(cache_size),
+        "-t", access_pattern,
+        "-a", str(associativity),
+        "-w", str(ws_period),
+        "-p", policy,
+        "--interval", str(interval),
+        "--interval-format", "csv",
+        "--interval-out", interval_path,
+        "-j"
+    ]
+
+    try:
+        subprocess.run(cmd, capture_output=True, text=True, check=True, cwd=working_dir)
+    except subprocess.CalledProcessError as e:
+        print(f"运行模拟出错 policy={policy}: {e}")
+        continue
+
+    df = pd.read_csv(interval_path)
+    # 按区间汇总所有核心
+    grouped = df.groupby("access_end")[["hits", "misses"]].sum().reset_index()
+    grouped["hit_rate"] = grouped["hits"] / (grouped["hits"] + grouped["misses"]) * 100
+    results[policy] = grouped
+    print(f"区间数据已保存至: {interval_path}")
+
+# 绘图
+plt.rcParams["font.sans-serif"] = ["LXGW ZhenKai GB", "SimHei", "DejaVu Sans"]
+
+fig, ax1 = plt.subplots(1, 1, figsize=(8, 6))
+
+for i, (policy, grouped) in enumerate(results.items()):
+    ax1.plot(
+        grouped["access_end"],
+        grouped["hit_rate"],
+        linewidth=1.5,
+        label=policy.upper(),
+        color=sns.color_palette("pastel")[i],
+    )
+
+# 标出工作集切换点
+for ws_boundary in range(ws_period, num_accesses, ws_period):
+    ax1.axvline(x=ws_boundary, color="gray", linestyle=":", alpha=0.5, linewidth=1)
+
+ax1.set_xlabel("访问次数 Number of Accesses")
+ax1.set_ylabel("区间命中率 Interval Hit Rate (%)")
+ax1.set_title("命中率随时间变化 Hit Rate Timeline")
+ax1.legend()
+ax1.grid(True, alpha=0.3)
+
+# 添加测试参数说明
+param_text = (
+    f"缓存大小: {cache_size // 1024} KB\n"
+    f"相联度: {associativity} 路组相联\n"
+    f"访问模式: {access_pattern}\n"
+    f"工作集周期: {ws_period}\n"
+    f"统计区间: {interval}"
+)
+props = dict(boxstyle='round', facecolor='white', alpha=0.5)
+ax1.text(0.97, 0.05, param_text, transform=ax1.transAxes, fontsize=12,
+        verticalalignment='bottom', horizontalalignment='right',
+        multialignment='left', bbox=props)
+
+plt.tight_layout()
+output_img_path = f"{base_filename}.png"
+plt.savefig(output_img_path, dpi=300, bbox_inches="tight")
+print(f"图表已保存至: {output_img_path}")
+# plt.show()
@@ -1,5 +1,8 @@
 #include "bus.h"
 #include "cache.h"
+#include "sharing_detector.h"
+#include "dram.h"
+#include "numa.h"
 
 namespace cache_sim
 {
@@ -9,9 +12,58 @@ namespace cache_sim
         caches_.push_back(cache);
     }
 
-    bool Bus::broadcast(int sender_id, uint64_t address, BusEvent event)
+    BusResponse Bus::broadcast(int sender_id, uint64_t address, BusEvent event)
+    {
+        switch (event)
+        {
+        case BusEvent::BusRd:
+            stats_.bus_rd++;
+            break;
+        case BusEvent::BusRdX:
+            stats_.bus_rdx++;
+            break;
+        case BusEvent::BusUpgr:
+            stats_.bus_upgr++;
+            break;
+        }
+
+        BusResponse response;
+        snoop(sender_id, address, event, response);
+
+        // 多插槽：本插槽之外的副本与主节点内存经互连处理
+        if (interconnect_)
+        {
+            interconnect_->request(socket_, sender_id, address, event, response);
+        }
+
+        // 升级请求不需要数据
+        if (event != BusEvent::BusUpgr)
+        {
+            if (response.supplied)
+            {
+                stats_.cache_to_cache++;
+            }
+            else
+            {
+                stats_.memory_reads++;
+                if (memory_)
+                {
+                    memory_->read(address);
+                }
+            }
+        }
+        return response;
+    }
+
+    BusResponse Bus::snoopRemote(int sender_id, uint64_t address, BusEvent event)
+    {
+        BusResponse response;
+        snoop(sender_id, address, event, response);
+        return response;
+    }
+
+    void Bus::snoop(int sender_id, uint64_t address, BusEvent event, BusResponse &response)
     {
-        bool is_shared = false;
         for (auto *cache : caches_)
         {
             // 跳过发送请求的缓存
@@ -21,12 +73,41 @@ namespace cache_sim
             }
 
             // 调用其他缓存的嗅探函数
-            if (cache->snoop(address, event))
+            SnoopResult result = cache->snoop(address, event);
+            if (result.has_copy)
+            {
+                response.shared = true;
+            }
+            if (result.supplied)
+            {
+                response.supplied = true;
+            }
+            if (result.flushed)
+            {
+                stats_.flushes++;
+            }
+            if (result.invalidated)
             {
-                is_shared = true;
+                stats_.invalidations++;
+                if (sharing_detector_)
+                {
+                    // 写操作粒度为 1 字节
+                    sharing_detector_->invalidate(cache->getId(), sender_id, address, 1);
+                }
             }
         }
-        return is_shared;
+    }
+
+    void Bus::writeMemory(uint64_t address)
+    {
+        if (interconnect_)
+        {
+            interconnect_->writeBack(socket_, address);
+        }
+        if (memory_)
+        {
+            memory_->write(address);
+        }
     }
 
 } // namespace cache_sim
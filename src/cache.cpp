@@ -3,6 +3,74 @@
 
 namespace cache_sim
 {
+    namespace
+    {
+        bool isPrime(size_t n)
+        {
+            if (n < 2)
+            {
+                return false;
+            }
+            for (size_t d = 2; d * d <= n; ++d)
+            {
+                if (n % d == 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // 各路斜相联哈希使用的乘数（奇数，保证不同路的映射互不相同）
+        uint64_t skewMultiplier(size_t way)
+        {
+            return 0x9E3779B97F4A7C15ULL * (2 * way + 1);
+        }
+
+        // 检查点中每个缓存行的定长记录，整组数组一次读写
+        struct LineState
+        {
+            uint64_t tag;
+            uint64_t last_access_time;
+            uint64_t access_count;
+            uint8_t valid;
+            uint8_t dirty;
+            uint8_t state;
+            uint8_t reserved;
+            uint16_t owner;
+            uint8_t padding[2];
+        };
+        static_assert(sizeof(LineState) == 32, "LineState 应无填充");
+
+        const char kStateMagic[8] = {'C', 'S', 'C', 'A', 'C', 'H', 'E', '\0'};
+        const uint64_t kStateVersion = 1;
+
+        // 检查点头部：魔数之后的几何参数，恢复时逐项比较
+        struct StateHeader
+        {
+            uint64_t version;
+            uint64_t line_state_size;
+            uint64_t num_sets;
+            uint64_t associativity;
+            uint64_t block_size;
+            uint64_t index_function;
+            uint64_t index_modulus;
+            uint64_t victim_entries;
+            uint64_t access_clock;
+        };
+
+        // 组号散列（SplitMix64 终结函数），使采样组与地址步长、组 0 等特殊位置无关
+        uint64_t mixSetIndex(uint64_t set)
+        {
+            uint64_t z = set + 0x9E3779B97F4A7C15ULL;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+    } // namespace
+
+    constexpr uint32_t Cache::kUnsampled;
+
     // 缓存构造函数
     Cache::Cache(const CacheConfig &config, int id, Bus *bus)
         : config_(config), id_(id), bus_(bus)
@@ -19,22 +87,260 @@ namespace cache_sim
         {
             sets_.emplace_back(config_.associativity, config_.block_size);
         }
+
+#ifdef CACHE_SIM_SET_STATS
+        set_stats_.resize(num_sets);
+#endif
+
+        // 计算地址划分参数
+        block_bits_ = static_cast<size_t>(std::log2(config_.block_size));
+        index_modulus_ = std::max<size_t>(num_sets, 1);
+
+        bool sets_pow2 = (index_modulus_ & (index_modulus_ - 1)) == 0;
+        if ((config_.index_function == IndexFunction::XorFold || config_.index_function == IndexFunction::Skewed) && !sets_pow2)
+        {
+            std::cerr << "[Warning] 异或折叠与斜相联索引要求组数为 2 的幂，使用默认的取模索引。" << std::endl;
+            config_.index_function = IndexFunction::Modulo;
+        }
+        if (config_.index_function == IndexFunction::PrimeModulo)
+        {
+            // 取不超过组数的最大素数，多出的组不再使用
+            while (index_modulus_ > 2 && !isPrime(index_modulus_))
+            {
+                index_modulus_--;
+            }
+        }
+
+        pow2_sets_ = (index_modulus_ & (index_modulus_ - 1)) == 0;
+        set_bits_ = pow2_sets_ ? static_cast<size_t>(__builtin_ctzll(index_modulus_)) : 0;
+        set_mask_ = index_modulus_ - 1;
+
+        // 扇区：不分扇区时整块为一个扇区
+        sector_size_ = config_.sector_size > 0 && config_.sector_size < config_.block_size ? config_.sector_size : config_.block_size;
+        sector_bits_ = static_cast<size_t>(std::log2(sector_size_));
+        sectors_per_block_ = config_.block_size / sector_size_;
+        all_sectors_ = sectors_per_block_ >= 64 ? ~uint64_t(0) : (uint64_t(1) << sectors_per_block_) - 1;
+
+        if (config_.victim_cache_entries > 0)
+        {
+            victim_cache_ = std::make_unique<VictimCache>(config_.victim_cache_entries);
+        }
+        if (config_.write_buffer_entries > 0)
+        {
+            write_buffer_ = std::make_unique<WriteBuffer>(config_.write_buffer_entries, config_.block_size);
+        }
+
+        selectSampledSets();
+    }
+
+    // 按配置选出采样组
+    void Cache::selectSampledSets()
+    {
+        if (config_.set_sampling == SetSampling::None || config_.sampling_ratio <= 1)
+        {
+            return;
+        }
+        if (config_.index_function == IndexFunction::Skewed)
+        {
+            // 斜相联的各路位于不同的组，无法按组划分访问
+            std::cerr << "[Warning] 斜相联索引不支持组采样，模拟所有组。" << std::endl;
+            config_.set_sampling = SetSampling::None;
+            return;
+        }
+        if (victim_cache_ && id_ == 0)
+        {
+            std::cerr << "[Warning] 组采样时受害者缓存只服务采样组，其相对容量被放大，相关统计不宜外推。" << std::endl;
+        }
+
+        sample_slot_.assign(sets_.size(), kUnsampled);
+        uint32_t slots = 0;
+        for (size_t set = 0; set < index_modulus_; ++set)
+        {
+            bool sampled = config_.set_sampling == SetSampling::Stride
+                               ? set % config_.sampling_ratio == 0
+                               : mixSetIndex(set) % config_.sampling_ratio == 0;
+            if (sampled)
+            {
+                sample_slot_[set] = slots++;
+            }
+        }
+        if (slots == 0)
+        {
+            sample_slot_[0] = slots++;
+        }
+        sample_stats_.resize(slots);
+    }
+
+    // 保存缓存状态
+    bool Cache::saveState(std::ostream &os) const
+    {
+        size_t num_lines = sets_.size() * config_.associativity;
+        StateHeader header = {kStateVersion, sizeof(LineState), sets_.size(), config_.associativity, config_.block_size,
+                              static_cast<uint64_t>(config_.index_function), index_modulus_,
+                              victim_cache_ ? victim_cache_->size() : 0, access_clock_};
+        os.write(kStateMagic, sizeof(kStateMagic));
+        os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        // 行元数据与数据块分别打包成连续数组
+        std::vector<LineState> lines(num_lines);
+        std::vector<uint8_t> data(num_lines * config_.block_size);
+        size_t i = 0;
+        for (const auto &set : sets_)
+        {
+            for (const auto &line : set.lines)
+            {
+                LineState &state = lines[i];
+                state.tag = line.tag;
+                state.last_access_time = line.last_access_time;
+                state.access_count = line.access_count;
+                state.valid = line.valid;
+                state.dirty = line.dirty;
+                state.state = static_cast<uint8_t>(line.state);
+                state.owner = line.owner;
+                std::copy(line.data.begin(), line.data.end(), data.begin() + i * config_.block_size);
+                ++i;
+            }
+        }
+        os.write(reinterpret_cast<const char *>(lines.data()), lines.size() * sizeof(LineState));
+        os.write(reinterpret_cast<const char *>(data.data()), data.size());
+
+        if (victim_cache_)
+        {
+            victim_cache_->save(os);
+        }
+        saveReplacementState(os);
+        return static_cast<bool>(os);
+    }
+
+    // 恢复缓存状态
+    bool Cache::loadState(std::istream &is)
+    {
+        char magic[sizeof(kStateMagic)];
+        StateHeader header;
+        if (!is.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kStateMagic) ||
+            !is.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        {
+            std::cerr << "[Warning] 检查点数据损坏" << std::endl;
+            return false;
+        }
+        if (header.version != kStateVersion || header.line_state_size != sizeof(LineState) ||
+            header.num_sets != sets_.size() || header.associativity != config_.associativity ||
+            header.block_size != config_.block_size || header.index_function != static_cast<uint64_t>(config_.index_function) ||
+            header.index_modulus != index_modulus_ || header.victim_entries != (victim_cache_ ? victim_cache_->size() : 0))
+        {
+            std::cerr << "[Warning] 检查点的缓存配置与当前配置不一致" << std::endl;
+            return false;
+        }
+
+        size_t num_lines = sets_.size() * config_.associativity;
+        std::vector<LineState> lines(num_lines);
+        std::vector<uint8_t> data(num_lines * config_.block_size);
+        if (!is.read(reinterpret_cast<char *>(lines.data()), lines.size() * sizeof(LineState)) ||
+            !is.read(reinterpret_cast<char *>(data.data()), data.size()))
+        {
+            std::cerr << "[Warning] 检查点数据不完整" << std::endl;
+            return false;
+        }
+
+        size_t i = 0;
+        for (auto &set : sets_)
+        {
+            for (auto &line : set.lines)
+            {
+                const LineState &state = lines[i];
+                line.tag = state.tag;
+                line.last_access_time = state.last_access_time;
+                line.access_count = state.access_count;
+                line.valid = state.valid != 0;
+                line.dirty = state.dirty != 0;
+                line.state = static_cast<MESIState>(state.state);
+                line.owner = state.owner;
+                line.sector_valid = line.valid ? all_sectors_ : 0;
+                line.sector_dirty = line.dirty ? all_sectors_ : 0;
+                std::copy(data.begin() + i * config_.block_size, data.begin() + (i + 1) * config_.block_size, line.data.begin());
+                ++i;
+            }
+        }
+        access_clock_ = header.access_clock;
+
+        if ((victim_cache_ && !victim_cache_->load(is)) || !loadReplacementState(is))
+        {
+            std::cerr << "[Warning] 检查点数据不完整" << std::endl;
+            return false;
+        }
+        resetStats();
+        return true;
+    }
+
+    // 由采样组的统计估计全缓存的缺失率
+    SamplingEstimate Cache::getSamplingEstimate() const
+    {
+        return estimateFromSample(sample_stats_, index_modulus_, stats_.reads + stats_.writes + stats_.unsampled);
+    }
+
+    // 将标签按索引位宽异或折叠
+    uint64_t Cache::foldTag(uint64_t tag) const
+    {
+        if (set_bits_ == 0)
+        {
+            return 0;
+        }
+        uint64_t folded = 0;
+        while (tag != 0)
+        {
+            folded ^= tag & set_mask_;
+            tag >>= set_bits_;
+        }
+        return folded;
     }
 
     // 从地址计算组索引（Set Index）
     size_t Cache::getSetIndex(uint64_t address) const
     {
-        size_t num_sets = sets_.size();
-        size_t block_bits = static_cast<size_t>(std::log2(config_.block_size));
-        return (address >> block_bits) % num_sets;
+        return getSetIndex(address, 0);
+    }
+
+    // 从地址计算指定路的组索引
+    size_t Cache::getSetIndex(uint64_t address, size_t way) const
+    {
+        uint64_t block = address >> block_bits_;
+        switch (config_.index_function)
+        {
+        case IndexFunction::XorFold:
+            return (block ^ foldTag(block >> set_bits_)) & set_mask_;
+        case IndexFunction::Skewed:
+            return (block ^ foldTag((block >> set_bits_) * skewMultiplier(way))) & set_mask_;
+        case IndexFunction::Modulo:
+        case IndexFunction::PrimeModulo:
+        default:
+            return pow2_sets_ ? (block & set_mask_) : (block % index_modulus_);
+        }
     }
 
     // 从地址计算标签（Tag）
     uint64_t Cache::getTag(uint64_t address) const
     {
-        size_t block_bits = static_cast<size_t>(std::log2(config_.block_size));
-        size_t set_bits = static_cast<size_t>(std::log2(sets_.size()));
-        return address >> (block_bits + set_bits);
+        uint64_t block = address >> block_bits_;
+        return pow2_sets_ ? (block >> set_bits_) : (block / index_modulus_);
+    }
+
+    // 由组索引与标签还原块起始地址
+    uint64_t Cache::reconstructAddress(size_t set_index, uint64_t tag, size_t way) const
+    {
+        uint64_t low = set_index;
+        switch (config_.index_function)
+        {
+        case IndexFunction::XorFold:
+            low = (set_index ^ foldTag(tag)) & set_mask_;
+            break;
+        case IndexFunction::Skewed:
+            low = (set_index ^ foldTag(tag * skewMultiplier(way))) & set_mask_;
+            break;
+        default:
+            break;
+        }
+        uint64_t block = pow2_sets_ ? ((tag << set_bits_) | low) : (tag * index_modulus_ + low);
+        return block << block_bits_;
     }
 
     // 从地址计算块内偏移（Block Offset）
@@ -46,9 +352,33 @@ namespace cache_sim
     // 查找缓存行
     CacheLine *Cache::findLine(uint64_t address)
     {
-        size_t set_index = getSetIndex(address);
+        size_t set_index;
+        return lookup(address, set_index);
+    }
+
+    CacheLine *Cache::lookup(uint64_t address, size_t &set_index)
+    {
         uint64_t tag = getTag(address);
 
+        if (config_.index_function == IndexFunction::Skewed)
+        {
+            // 斜相联：第 w 路位于各自哈希得到的组中
+            for (size_t way = 0; way < config_.associativity; ++way)
+            {
+                size_t index = getSetIndex(address, way);
+                CacheLine &line = sets_[index].lines[way];
+                if (line.valid && line.tag == tag)
+                {
+                    set_index = index;
+                    return &line;
+                }
+            }
+            set_index = getSetIndex(address, 0);
+            return nullptr;
+        }
+
+        set_index = getSetIndex(address);
+
         // 在对应的组中，遍历查找指定 Tag 的缓存行
         for (auto &line : sets_[set_index].lines)
         {
@@ -60,53 +390,422 @@ namespace cache_sim
         return nullptr;
     }
 
+    // 比较两个候选替换行（默认 LRU）
+    bool Cache::preferVictim(const CacheLine &a, const CacheLine &b) const
+    {
+        return a.last_access_time < b.last_access_time;
+    }
+
+    // 斜相联或路划分时逐路选择替换行
+    CacheLine *Cache::selectWayVictim(uint64_t address, size_t &set_index)
+    {
+        CacheLine *victim = nullptr;
+        for (size_t way = 0; way < config_.associativity; ++way)
+        {
+            if (way_restricted_ && ((way_mask_ >> way) & 1) == 0)
+            {
+                continue;
+            }
+            size_t index = getSetIndex(address, way);
+            CacheLine &line = sets_[index].lines[way];
+
+            // 优先使用无效行
+            if (!line.valid)
+            {
+                set_index = index;
+                return &line;
+            }
+            if (victim == nullptr || preferVictim(line, *victim))
+            {
+                victim = &line;
+                set_index = index;
+            }
+        }
+
+        stats_.conflicts++;
+        return victim;
+    }
+
+    void Cache::setWayMask(uint64_t mask)
+    {
+        uint64_t all = config_.associativity >= 64 ? ~uint64_t(0) : (uint64_t(1) << config_.associativity) - 1;
+        way_mask_ = mask & all;
+        way_restricted_ = way_mask_ != 0 && way_mask_ != all;
+    }
+
+    std::vector<size_t> Cache::occupancyByOwner() const
+    {
+        std::vector<size_t> occupancy;
+        for (const auto &set : sets_)
+        {
+            for (const auto &line : set.lines)
+            {
+                if (line.valid)
+                {
+                    if (line.owner >= occupancy.size())
+                    {
+                        occupancy.resize(line.owner + 1, 0);
+                    }
+                    occupancy[line.owner]++;
+                }
+            }
+        }
+        return occupancy;
+    }
+
     // 重置统计信息
     void Cache::resetStats()
     {
         stats_ = CacheStats();
+        foreign_evicted_.clear();
+        std::fill(sample_stats_.begin(), sample_stats_.end(), SetStats());
+#ifdef CACHE_SIM_SET_STATS
+        std::fill(set_stats_.begin(), set_stats_.end(), SetStats());
+#endif
+    }
+
+    // 为缺失的地址分配缓存行
+    CacheLine *Cache::allocateLine(uint64_t address, size_t &set_index)
+    {
+        CacheLine *victim = config_.index_function == IndexFunction::Skewed || way_restricted_
+                                ? selectWayVictim(address, set_index)
+                                : selectVictim(set_index);
+
+        if (victim->valid)
+        {
+            stats_.evictions++;
+            if (!sample_slot_.empty())
+            {
+                sample_stats_[sample_slot_[set_index]].evictions++;
+            }
+#ifdef CACHE_SIM_SET_STATS
+            set_stats_[set_index].evictions++;
+#endif
+            if (victim->dirty)
+            {
+                stats_.dirty_evictions++;
+            }
+            if (victim->owner != current_owner_)
+            {
+                stats_.foreign_evictions++;
+                if (victim->owner >= foreign_evicted_.size())
+                {
+                    foreign_evicted_.resize(victim->owner + 1, 0);
+                }
+                foreign_evicted_[victim->owner]++;
+            }
+
+            uint64_t victim_address = reconstructAddress(set_index, victim->tag,
+                                                          static_cast<size_t>(victim - sets_[set_index].lines.data()));
+            if (eviction_log_ != nullptr)
+            {
+                eviction_log_->push_back(victim_address);
+            }
+            if (victim_cache_ && config_.victim_cache_mode == VictimCacheMode::Victim)
+            {
+                // 被驱逐的行进入受害者缓存，脏数据在离开受害者缓存时才写回
+                VictimEntry entry;
+                entry.dirty = victim->dirty;
+                entry.from_conflict = true;
+                entry.block_address = victim_address;
+                entry.state = victim->state;
+                VictimEntry evicted = victim_cache_->insert(entry);
+                if (evicted.valid && evicted.dirty)
+                {
+                    writeBackBlock(evicted.block_address);
+                }
+            }
+            else
+            {
+                if (victim->dirty)
+                {
+                    // 脏行被驱逐时需要写回主存
+                    writeBackBlock(victim_address, victim->sector_dirty);
+                }
+
+                // 缺失缓存中的副本此后与主存一致
+                VictimEntry *copy = victim_cache_ ? victim_cache_->find(victim_address) : nullptr;
+                if (copy != nullptr)
+                {
+                    copy->from_conflict = true;
+                    if (victim->state == MESIState::Modified)
+                    {
+                        copy->state = MESIState::Exclusive;
+                    }
+                    else if (victim->state == MESIState::Owned || victim->state == MESIState::Forward)
+                    {
+                        copy->state = MESIState::Shared;
+                    }
+                    else
+                    {
+                        copy->state = victim->state;
+                    }
+                }
+            }
+        }
+
+        // 重置被驱逐的行
+        resetLine(set_index, victim);
+        victim->owner = current_owner_;
+        victim->sector_valid = 0;
+        victim->sector_dirty = 0;
+        return victim;
+    }
+
+    // 广播总线请求
+    BusResponse Cache::broadcast(uint64_t address, BusEvent event)
+    {
+        if (bus_ == nullptr)
+        {
+            return BusResponse();
+        }
+        stats_.bus_transactions++;
+        return bus_->broadcast(id_, address, event);
+    }
+
+    // 写命中后按写策略更新缓存行
+    void Cache::completeWrite(uint64_t address, CacheLine *line, uint8_t value)
+    {
+        line->data[getBlockOffset(address)] = value;
+        line->sector_dirty |= sectorBit(address);
+
+        // 如果可能有其他共享副本（S/O/F），需要先使其他缓存的副本失效
+        if (line->state == MESIState::Shared || line->state == MESIState::Owned || line->state == MESIState::Forward)
+        {
+            // 广播 BusUpgr 使其他缓存失效，数据已在本地无需传输
+            broadcast(address, BusEvent::BusUpgr);
+        }
+
+        if (config_.write_policy == WritePolicy::WriteThrough)
+        {
+            // 写直达：数据同时写往主存，缓存行保持干净
+            writeToMemory(address, 1);
+            line->state = MESIState::Exclusive;
+            line->dirty = false;
+            line->sector_dirty = 0;
+        }
+        else
+        {
+            // S/E/O/F -> M，如果已经是 Modified，状态不变
+            line->state = MESIState::Modified;
+            line->dirty = true;
+        }
+    }
+
+    // 将数据写往主存
+    void Cache::writeToMemory(uint64_t address, size_t size)
+    {
+        if (write_buffer_)
+        {
+            bool coalesced = false;
+            WriteBufferDrain drained = write_buffer_->add(blockAddress(address), getBlockOffset(address), size, coalesced);
+            if (coalesced)
+            {
+                stats_.write_buffer_coalesced++;
+            }
+            stats_.memory_writes += drained.writes;
+            stats_.memory_write_bytes += drained.bytes;
+            sendToMemory(drained.blocks);
+            return;
+        }
+
+        stats_.memory_writes++;
+        stats_.memory_write_bytes += size;
+        if (bus_ != nullptr)
+        {
+            bus_->writeMemory(blockAddress(address));
+        }
+    }
+
+    // 写缓冲排空的块交给主存
+    void Cache::sendToMemory(const std::vector<uint64_t> &blocks)
+    {
+        if (bus_ == nullptr)
+        {
+            return;
+        }
+        for (uint64_t block_address : blocks)
+        {
+            bus_->writeMemory(block_address);
+        }
     }
 
-    // 读取数据 (实现 MESI 协议)
+    // 写回整个块
+    void Cache::writeBackBlock(uint64_t block_address, uint64_t dirty_sectors)
+    {
+        stats_.writebacks++;
+        dirty_sectors &= all_sectors_;
+        if (dirty_sectors == all_sectors_)
+        {
+            writeToMemory(block_address, config_.block_size);
+            return;
+        }
+        // 分扇区时每个脏扇区一次写事务
+        while (dirty_sectors != 0)
+        {
+            writeToMemory(block_address + __builtin_ctzll(dirty_sectors) * sector_size_, sector_size_);
+            dirty_sectors &= dirty_sectors - 1;
+        }
+    }
+
+    // 取回标签命中但无效的扇区
+    void Cache::fillSector(uint64_t address, CacheLine *line, BusEvent event)
+    {
+        broadcast(address, event);
+        line->sector_valid |= sectorBit(address);
+        stats_.bytes_fetched += sector_size_;
+    }
+
+    // 排空写缓冲
+    void Cache::flushWriteBuffer()
+    {
+        if (write_buffer_)
+        {
+            WriteBufferDrain drained = write_buffer_->flush();
+            stats_.memory_writes += drained.writes;
+            stats_.memory_write_bytes += drained.bytes;
+            sendToMemory(drained.blocks);
+        }
+    }
+
+    // 缺失时探测受害者缓存
+    CacheLine *Cache::refillFromVictimCache(uint64_t address, size_t &set_index)
+    {
+        VictimEntry *entry = victim_cache_->find(blockAddress(address));
+        if (entry == nullptr)
+        {
+            return nullptr;
+        }
+
+        stats_.victim_hits++;
+        if (entry->from_conflict)
+        {
+            stats_.victim_absorbed_conflicts++;
+        }
+
+        VictimEntry hit = *entry;
+        if (config_.victim_cache_mode == VictimCacheMode::Victim)
+        {
+            // 受害者缓存：取出该项，L1 被驱逐的行换入其位置
+            victim_cache_->remove(entry);
+        }
+        else
+        {
+            // 缺失缓存：保留副本
+            victim_cache_->touch(entry);
+        }
+
+        uint64_t evictions = stats_.evictions;
+        CacheLine *line = allocateLine(address, set_index);
+        if (config_.victim_cache_mode == VictimCacheMode::Victim && stats_.evictions != evictions)
+        {
+            stats_.victim_swaps++;
+        }
+
+        line->valid = true;
+        line->tag = getTag(address);
+        line->dirty = hit.dirty;
+        line->state = hit.state;
+        line->sector_valid = all_sectors_;
+        line->sector_dirty = hit.dirty ? all_sectors_ : 0;
+        return line;
+    }
+
+    // 读取数据 (实现 MESI/MOESI/MESIF 协议)
     bool Cache::read(uint64_t address)
     {
+        // 组采样：未采样组的访问在计算组索引后直接丢弃，不做查找
+        SetStats *sample = nullptr;
+        if (!sample_slot_.empty())
+        {
+            uint32_t slot = sample_slot_[getSetIndex(address)];
+            if (slot == kUnsampled)
+            {
+                stats_.unsampled++;
+                return false;
+            }
+            sample = &sample_stats_[slot];
+            sample->accesses++;
+        }
+
         stats_.reads++;
 
-        CacheLine *line = findLine(address);
-        if (line != nullptr)
+        size_t set_index;
+        CacheLine *line = lookup(address, set_index);
+#ifdef CACHE_SIM_SET_STATS
+        set_stats_[set_index].accesses++;
+#endif
+
+        if (line != nullptr && sectorPresent(line, address))
         {
             // 缓存命中
             stats_.hits++;
-            updateAccessInfo(getSetIndex(address), line);
+            updateAccessInfo(set_index, line);
             // 状态保持不变 (M, E, S 都可以读)
             return true;
         }
 
         // 缓存缺失
         stats_.misses++;
+        if (sample != nullptr)
+        {
+            sample->misses++;
+        }
+#ifdef CACHE_SIM_SET_STATS
+        set_stats_[set_index].misses++;
+#endif
 
-        // 选择要替换的缓存行
-        size_t set_index = getSetIndex(address);
-        CacheLine *victim = selectVictim(set_index);
+        if (line != nullptr)
+        {
+            // 扇区缺失：只取回该扇区，状态保持不变
+            stats_.sector_misses++;
+            updateAccessInfo(set_index, line);
+            fillSector(address, line, BusEvent::BusRd);
+            return false;
+        }
 
-        // 重置被驱逐的行
-        resetLine(set_index, victim);
+        // 先探测受害者缓存，命中则无需访问总线
+        CacheLine *victim = victim_cache_ ? refillFromVictimCache(address, set_index) : nullptr;
+        if (victim != nullptr)
+        {
+            updateAccessInfo(set_index, victim);
+            return false;
+        }
 
-        // 广播读请求 (BusRd)
-        bool is_shared = false;
-        if (bus_)
+        victim = fillForRead(address, set_index);
+
+        // 缺失缓存保存填充行的副本
+        if (victim_cache_ && config_.victim_cache_mode == VictimCacheMode::Miss)
         {
-            is_shared = bus_->broadcast(id_, address, BusEvent::BusRd);
+            VictimEntry entry;
+            entry.block_address = blockAddress(address);
+            entry.state = victim->state;
+            victim_cache_->insert(entry);
         }
 
+        return false;
+    }
+
+    // 读缺失时装入数据块
+    CacheLine *Cache::fillForRead(uint64_t address, size_t &set_index)
+    {
+        // 选择要替换的缓存行
+        CacheLine *victim = allocateLine(address, set_index);
+
+        // 广播读请求 (BusRd)
+        BusResponse response = broadcast(address, BusEvent::BusRd);
+
         // 模拟加载数据到缓存行
         victim->valid = true;
         victim->tag = getTag(address);
         victim->dirty = false;
+        victim->sector_valid = sectorBit(address);
+        stats_.bytes_fetched += sector_size_;
 
-        // 根据总线响应设置状态
-        if (is_shared)
+        // 根据总线响应设置状态（MESIF 中最新的请求者成为转发者）
+        if (response.shared)
         {
-            victim->state = MESIState::Shared;
+            victim->state = config_.coherence_protocol == CoherenceProtocol::MESIF ? MESIState::Forward : MESIState::Shared;
         }
         else
         {
@@ -114,106 +813,361 @@ namespace cache_sim
         }
 
         updateAccessInfo(set_index, victim);
-
-        return false;
+        return victim;
     }
 
-    // 写入数据 (实现 MESI 协议)
-    bool Cache::write(uint64_t address, uint8_t /*value*/)
+    // 预取数据块
+    bool Cache::prefetch(uint64_t address)
     {
-        stats_.writes++;
-
-        CacheLine *line = findLine(address);
+        if (!isSampled(address))
+        {
+            return false;
+        }
+        size_t set_index;
+        CacheLine *line = lookup(address, set_index);
         if (line != nullptr)
         {
-            // 缓存命中
-            stats_.hits++;
-            updateAccessInfo(getSetIndex(address), line);
-
-            // 如果是 Shared 状态，需要升级为 Modified
-            if (line->state == MESIState::Shared)
+            if (sectorPresent(line, address))
             {
-                // 广播 BusRdX 使其他缓存失效
-                if (bus_)
-                {
-                    bus_->broadcast(id_, address, BusEvent::BusRdX);
-                }
-                line->state = MESIState::Modified;
+                return false;
             }
-            else if (line->state == MESIState::Exclusive)
+            fillSector(address, line, BusEvent::BusRd);
+            return true;
+        }
+        fillForRead(address, set_index);
+        return true;
+    }
+
+    // 写回脏块并保留为干净块
+    bool Cache::clean(uint64_t address)
+    {
+        CacheLine *line = findLine(address);
+        if (line == nullptr || !line->dirty)
+        {
+            return false;
+        }
+
+        writeBackBlock(blockAddress(address), line->sector_dirty);
+        line->dirty = false;
+        line->sector_dirty = 0;
+        if (line->state == MESIState::Modified)
+        {
+            line->state = MESIState::Exclusive;
+        }
+        else if (line->state == MESIState::Owned)
+        {
+            line->state = MESIState::Shared;
+        }
+        return true;
+    }
+
+    // 写入数据 (实现 MESI/MOESI/MESIF 协议)
+    bool Cache::write(uint64_t address, uint8_t value)
+    {
+        // 组采样：未采样组的访问在计算组索引后直接丢弃，不做查找
+        SetStats *sample = nullptr;
+        if (!sample_slot_.empty())
+        {
+            uint32_t slot = sample_slot_[getSetIndex(address)];
+            if (slot == kUnsampled)
             {
-                // E -> M
-                line->state = MESIState::Modified;
+                stats_.unsampled++;
+                return false;
             }
-            // 如果已经是 Modified，状态不变
+            sample = &sample_stats_[slot];
+            sample->accesses++;
+        }
 
-            line->dirty = true;
+        stats_.writes++;
+
+        size_t set_index;
+        CacheLine *line = lookup(address, set_index);
+#ifdef CACHE_SIM_SET_STATS
+        set_stats_[set_index].accesses++;
+#endif
+
+        if (line != nullptr && sectorPresent(line, address))
+        {
+            // 缓存命中
+            stats_.hits++;
+            updateAccessInfo(set_index, line);
+            completeWrite(address, line, value);
             return true;
         }
 
         // 缓存缺失
         stats_.misses++;
+        if (sample != nullptr)
+        {
+            sample->misses++;
+        }
+#ifdef CACHE_SIM_SET_STATS
+        set_stats_[set_index].misses++;
+#endif
 
-        // 选择要替换的缓存行
-        size_t set_index = getSetIndex(address);
-        CacheLine *victim = selectVictim(set_index);
+        if (line != nullptr)
+        {
+            // 扇区缺失：独占时其他缓存没有副本，只需读取该扇区；否则以 BusRdX 同时作废其他副本
+            stats_.sector_misses++;
+            updateAccessInfo(set_index, line);
+            bool exclusive = line->state == MESIState::Modified || line->state == MESIState::Exclusive;
+            fillSector(address, line, exclusive ? BusEvent::BusRd : BusEvent::BusRdX);
+            if (!exclusive)
+            {
+                line->state = MESIState::Exclusive;
+            }
+            completeWrite(address, line, value);
+            return false;
+        }
 
-        // 重置被驱逐的行
-        resetLine(set_index, victim);
+        // 先探测受害者缓存，命中则装回后按写命中处理
+        CacheLine *victim = victim_cache_ ? refillFromVictimCache(address, set_index) : nullptr;
+        if (victim != nullptr)
+        {
+            updateAccessInfo(set_index, victim);
+            completeWrite(address, victim, value);
+            return false;
+        }
 
-        // 广播写请求 (BusRdX)
-        if (bus_)
+        if (!config_.write_allocate)
         {
-            bus_->broadcast(id_, address, BusEvent::BusRdX);
+            // 写不分配：使其他缓存的副本失效后直接写往主存
+            broadcast(address, BusEvent::BusRdX);
+            writeToMemory(address, 1);
+            return false;
         }
 
+        // 选择要替换的缓存行
+        victim = allocateLine(address, set_index);
+
+        // 广播写请求 (BusRdX)
+        broadcast(address, BusEvent::BusRdX);
+
         // 写入数据到缓存行
         victim->valid = true;
         victim->tag = getTag(address);
-        victim->dirty = true;
-        victim->state = MESIState::Modified;
+        victim->state = MESIState::Exclusive;
+        victim->sector_valid = sectorBit(address);
+        stats_.bytes_fetched += sector_size_;
+        completeWrite(address, victim, value);
         updateAccessInfo(set_index, victim);
 
+        // 缺失缓存保存填充时（写入前）的干净副本
+        if (victim_cache_ && config_.victim_cache_mode == VictimCacheMode::Miss)
+        {
+            VictimEntry entry;
+            entry.block_address = blockAddress(address);
+            entry.state = MESIState::Exclusive;
+            victim_cache_->insert(entry);
+        }
+
         return false;
     }
 
+    // 作废包含该地址的块
+    bool Cache::invalidate(uint64_t address)
+    {
+        bool present = false;
+        if (victim_cache_)
+        {
+            VictimEntry *entry = victim_cache_->find(blockAddress(address));
+            if (entry != nullptr)
+            {
+                if (entry->dirty)
+                {
+                    writeBackBlock(entry->block_address);
+                }
+                victim_cache_->remove(entry);
+                present = true;
+            }
+        }
+
+        CacheLine *line = findLine(address);
+        if (line != nullptr)
+        {
+            if (line->dirty)
+            {
+                writeBackBlock(blockAddress(address), line->sector_dirty);
+            }
+            line->valid = false;
+            line->dirty = false;
+            line->state = MESIState::Invalid;
+            present = true;
+        }
+        return present;
+    }
+
+    size_t Cache::flush(const std::function<bool(uint64_t)> &match)
+    {
+        size_t flushed = 0;
+        for (size_t set_index = 0; set_index < sets_.size(); ++set_index)
+        {
+            std::vector<CacheLine> &lines = sets_[set_index].lines;
+            for (size_t way = 0; way < lines.size(); ++way)
+            {
+                CacheLine &line = lines[way];
+                if (!line.valid)
+                {
+                    continue;
+                }
+                uint64_t block_address = reconstructAddress(set_index, line.tag, way);
+                if (!match(block_address))
+                {
+                    continue;
+                }
+                if (line.dirty)
+                {
+                    writeBackBlock(block_address, line.sector_dirty);
+                }
+                line.valid = false;
+                line.dirty = false;
+                line.state = MESIState::Invalid;
+                ++flushed;
+            }
+        }
+
+        for (size_t i = 0; victim_cache_ && i < victim_cache_->size(); ++i)
+        {
+            VictimEntry &entry = victim_cache_->at(i);
+            if (entry.valid && match(entry.block_address))
+            {
+                if (entry.dirty)
+                {
+                    writeBackBlock(entry.block_address);
+                }
+                victim_cache_->remove(&entry);
+                ++flushed;
+            }
+        }
+        return flushed;
+    }
+
     // 嗅探总线请求
-    bool Cache::snoop(uint64_t address, BusEvent event)
+    SnoopResult Cache::snoop(uint64_t address, BusEvent event)
     {
+        SnoopResult result;
+        if (victim_cache_)
+        {
+            result = snoopVictimCache(address, event);
+        }
+
         CacheLine *line = findLine(address);
         if (line == nullptr)
         {
-            return false;
+            return result;
         }
 
-        // 命中，根据 MESI 协议更新状态
+        result |= applySnoop(line->state, line->dirty, blockAddress(address), event, line->sector_dirty);
+        if (!line->dirty)
+        {
+            line->sector_dirty = 0;
+        }
+        if (line->state == MESIState::Invalid)
+        {
+            line->valid = false;
+        }
+        return result;
+    }
+
+    // 按一致性协议处理一份副本的嗅探
+    SnoopResult Cache::applySnoop(MESIState &state, bool &dirty, uint64_t block_address, BusEvent event, uint64_t dirty_sectors)
+    {
+        SnoopResult result;
+        result.has_copy = true; // 用于告知请求者是否 Shared
+
+        CoherenceProtocol protocol = config_.coherence_protocol;
         switch (event)
         {
         case BusEvent::BusRd:
             // 远程读请求
-            if (line->state == MESIState::Modified)
-            {
-                // M -> S，需要写回内存（Flush）
-                line->dirty = false;
-                line->state = MESIState::Shared;
-            }
-            else if (line->state == MESIState::Exclusive)
+            switch (state)
             {
-                // E -> S
-                line->state = MESIState::Shared;
+            case MESIState::Modified:
+                result.supplied = true;
+                if (protocol == CoherenceProtocol::MOESI)
+                {
+                    // M -> O，脏数据直接共享，无需写回
+                    state = MESIState::Owned;
+                }
+                else
+                {
+                    // M -> S，需要写回内存（Flush）
+                    writeBackBlock(block_address, dirty_sectors);
+                    result.flushed = true;
+                    dirty = false;
+                    state = MESIState::Shared;
+                }
+                break;
+            case MESIState::Owned:
+                // O -> O，继续负责提供数据
+                result.supplied = true;
+                break;
+            case MESIState::Exclusive:
+                // E -> S（MESIF 中由独占者转发数据）
+                result.supplied = protocol == CoherenceProtocol::MESIF;
+                state = MESIState::Shared;
+                break;
+            case MESIState::Forward:
+                // F -> S，转发数据后转发者身份交给请求者
+                result.supplied = true;
+                state = MESIState::Shared;
+                break;
+            default:
+                // S -> S, I -> I (不变)
+                break;
             }
-            // S -> S, I -> I (不变)
             break;
 
         case BusEvent::BusRdX:
             // 远程写请求（独占读）
-            // 本地副本失效
-            line->valid = false;
-            line->state = MESIState::Invalid;
+            // 已修改的数据提供给请求者，然后本地副本失效。MESI / MESIF 需先写回（Flush）；
+            // MOESI 中请求者以 M 接管整块脏数据，无需写回。写不分配时请求者不装入该块，
+            // 分扇区时请求者只取回一个扇区，这两种情况仍需写回，否则脏数据会丢失
+            if (state == MESIState::Modified || state == MESIState::Owned)
+            {
+                bool transfer = protocol == CoherenceProtocol::MOESI && config_.write_allocate && sectors_per_block_ == 1;
+                if (!transfer)
+                {
+                    writeBackBlock(block_address, dirty_sectors);
+                    result.flushed = true;
+                }
+                result.supplied = true;
+            }
+            else if (protocol == CoherenceProtocol::MESIF && (state == MESIState::Exclusive || state == MESIState::Forward))
+            {
+                result.supplied = true;
+            }
+            dirty = false;
+            state = MESIState::Invalid;
+            result.invalidated = true;
+            break;
+
+        case BusEvent::BusUpgr:
+            // 请求者已持有相同数据（O 的脏数据随请求者升级为 M 一并保留），本地副本直接失效
+            dirty = false;
+            state = MESIState::Invalid;
+            result.invalidated = true;
             break;
         }
 
-        return true; // 返回 true 表示我们有这个数据（用于告知请求者是否 Shared）
+        return result;
+    }
+
+    // 处理受害者缓存中的嗅探
+    SnoopResult Cache::snoopVictimCache(uint64_t address, BusEvent event)
+    {
+        VictimEntry *entry = victim_cache_->find(blockAddress(address));
+        if (entry == nullptr)
+        {
+            return SnoopResult();
+        }
+
+        SnoopResult result = applySnoop(entry->state, entry->dirty, entry->block_address, event);
+        if (entry->state == MESIState::Invalid)
+        {
+            victim_cache_->remove(entry);
+        }
+        return result;
     }
 
 } // namespace cache_sim
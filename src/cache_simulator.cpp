@@ -5,92 +5,1476 @@
 
 namespace cache_sim
 {
+#ifdef CACHE_SIM_SET_STATS
+    namespace
+    {
+        // 以 JSON 对象格式输出偏斜度摘要
+        void writeSkewJson(std::ostream &os, const SkewSummary &summary)
+        {
+            os << "{\"max\": " << summary.max
+               << ", \"mean\": " << std::fixed << std::setprecision(2) << summary.mean
+               << ", \"max_mean_ratio\": " << std::setprecision(4) << summary.max_mean_ratio
+               << ", \"gini\": " << summary.gini << "}";
+        }
+    } // namespace
+#endif
+
+    const size_t CacheSimulator::kAsidShift;
+
+    CacheSimulator::CacheSimulator(const SimulatorConfig &config)
+        : config_(config)
+    {
+        createCaches();
+        createProfilers();
+        createStreams();
+    }
+
+    void CacheSimulator::createCaches()
+    {
+        // 每个插槽一条总线，核心按编号连续分配到各插槽
+        size_t sockets = config_.numa_config.sockets;
+        for (size_t socket = 0; socket < sockets; ++socket)
+        {
+            buses_.push_back(std::make_unique<Bus>());
+        }
+        if (sockets > 1)
+        {
+            interconnect_ = std::make_unique<Interconnect>(config_.numa_config, config_.cache_config.block_size);
+            for (auto &bus : buses_)
+            {
+                interconnect_->attach(bus.get());
+            }
+        }
+        caches_.reserve(config_.num_cores);
+
+        for (int i = 0; i < config_.num_cores; ++i)
+        {
+            Bus *bus = buses_[socketOf(i)].get();
+            std::unique_ptr<Cache> cache;
+            switch (config_.replacement_policy)
+            {
+            case ReplacementPolicy::LRU:
+                cache = std::make_unique<LRUCache>(config_.cache_config, i, bus);
+                break;
+            case ReplacementPolicy::LFU:
+                cache = std::make_unique<LFUCache>(config_.cache_config, i, bus);
+                break;
+
+            default:
+                std::cerr << "[Warning] 未知的替换策略，使用默认的 LRU 策略。" << std::endl;
+                cache = std::make_unique<LRUCache>(config_.cache_config, i, bus);
+                break;
+            }
+
+            bus->attach(cache.get());
+            caches_.push_back(std::move(cache));
+        }
+
+        if (config_.sharing_analysis)
+        {
+            sharing_detector_ = std::make_unique<SharingDetector>(config_.cache_config.block_size, config_.num_cores);
+            for (auto &bus : buses_)
+            {
+                bus->setSharingDetector(sharing_detector_.get());
+            }
+        }
+
+        if (config_.dram)
+        {
+            // 分扇区时每个请求传输一个扇区
+            size_t transfer = caches_[0]->getConfig().block_size / caches_[0]->getSectorsPerBlock();
+            memory_ = std::make_unique<MemoryController>(config_.dram_config, transfer);
+            buses_[0]->setMemory(memory_.get());
+        }
+
+        if (config_.compression)
+        {
+            const CompressionConfig &compression = config_.compression_config;
+            memory_image_ = std::make_unique<MemoryImage>(config_.cache_config.block_size, compression.value_model, config_.seed);
+            if (!compression.memory_image.empty() && !memory_image_->loadFile(compression.memory_image))
+            {
+                std::cerr << "[Warning] 无法打开内存映像文件 '" << compression.memory_image << "'，块内容全部由取值模型生成。" << std::endl;
+            }
+            for (int i = 0; i < config_.num_cores; ++i)
+            {
+                compressed_.push_back(std::make_unique<CompressedCache>(config_.cache_config, compression, memory_image_.get()));
+            }
+        }
+
+        if (config_.virtual_memory)
+        {
+            vm_ = std::make_unique<VirtualMemory>(config_.vm_config, caches_);
+        }
+    }
+
+    void CacheSimulator::createProfilers()
+    {
+        if (!config_.reuse_distance)
+        {
+            return;
+        }
+
+        size_t block_size = config_.cache_config.block_size;
+        core_profilers_.reserve(config_.num_cores);
+        for (int i = 0; i < config_.num_cores; ++i)
+        {
+            core_profilers_.push_back(std::make_unique<ReuseDistanceProfiler>(block_size, config_.reuse_max_blocks));
+        }
+        global_profiler_ = std::make_unique<ReuseDistanceProfiler>(block_size, config_.reuse_max_blocks);
+    }
+
+    void CacheSimulator::createStreams()
+    {
+        std::vector<unsigned> weights;
+        size_t processes = config_.processes_per_core;
+        for (int i = 0; i < config_.num_cores; ++i)
+        {
+            // 未单独指定进程负载时，同一核心上的进程执行该核心的负载，但各自使用不同的随机数序列
+            CoreWorkload workload = config_.workloadFor(i);
+            for (size_t p = 0; p < processes; ++p)
+            {
+                const CoreWorkload &process_workload = config_.process_workloads.empty() ? workload : config_.process_workloads[p];
+                uint64_t seed = config_.seed + p * 0x9E3779B97F4A7C15ULL;
+                streams_.push_back(std::make_unique<WorkloadStream>(process_workload, config_.cache_config.block_size, i, config_.num_cores, seed));
+            }
+            weights.push_back(workload.weight);
+        }
+        scheduler_ = std::make_unique<StreamScheduler>(weights, config_.interleave);
+
+        // 多进程调度：各核心从核内第 0 个进程开始运行
+        if (processes > 1)
+        {
+            running_.assign(config_.num_cores, 0);
+            slice_used_.assign(config_.num_cores, 0);
+            since_switch_.assign(config_.num_cores, 0);
+            refilling_.assign(config_.num_cores, false);
+            has_run_.assign(config_.num_cores * processes, false);
+            asid_holders_.assign(config_.num_cores, std::vector<size_t>());
+            process_stats_.assign(config_.num_cores * processes, ProcessStats());
+            for (int i = 0; i < config_.num_cores; ++i)
+            {
+                size_t first = i * processes;
+                has_run_[first] = true;
+                asid_holders_[i].push_back(first);
+                process_stats_[first].slices = 1;
+                caches_[i]->setOwner(static_cast<uint16_t>(first));
+            }
+            createPartitions();
+        }
+
+        // 第 i 个 trace 文件驱动第 i 个核心
+        traces_.resize(config_.num_cores);
+        exhausted_.assign(config_.num_cores, false);
+        active_sources_ = config_.num_cores;
+        for (size_t i = 0; i < config_.trace_files.size() && i < traces_.size(); ++i)
+        {
+            // 无法打开时不改用生成的访问流：未指定访问次数时运行长度取决于 trace，生成的访问流不会结束
+            traces_[i] = openTrace(config_.trace_files[i], config_.trace_format, config_.trace_threads);
+            if (!traces_[i])
+            {
+                std::cerr << "错误: 无法读取核心 " << i << " 的 trace 文件 '" << config_.trace_files[i] << "'" << std::endl;
+                ok_ = false;
+            }
+        }
+    }
+
+    bool CacheSimulator::nextAccess(MemoryAccess &access)
+    {
+        while (active_sources_ > 0)
+        {
+            access.core_id = scheduler_->next();
+            if (exhausted_[access.core_id])
+            {
+                continue;
+            }
+
+            TraceReader *trace = traces_[access.core_id].get();
+            if (trace == nullptr)
+            {
+                if (!process_stats_.empty())
+                {
+                    // 访问来自核心上正在运行的进程，地址高位带上该进程的 ASID
+                    scheduleProcess(access.core_id);
+                    size_t process = access.core_id * config_.processes_per_core + running_[access.core_id];
+                    streams_[process]->next(access.address, access.is_write);
+                    access.address |= static_cast<uint64_t>(process) << kAsidShift;
+                    return true;
+                }
+                streams_[access.core_id]->next(access.address, access.is_write);
+                return true;
+            }
+
+            TraceRecord record;
+            if (trace->next(record))
+            {
+                access.address = record.address;
+                access.is_write = record.is_write;
+                return true;
+            }
+
+            // trace 读完后该核心不再发出访问，也不再被调度
+            exhausted_[access.core_id] = true;
+            scheduler_->retire(access.core_id);
+            --active_sources_;
+        }
+        return false;
+    }
+
+    void CacheSimulator::scheduleProcess(size_t core_id)
+    {
+        if (++slice_used_[core_id] <= config_.time_slice)
+        {
+            return;
+        }
+
+        size_t processes = config_.processes_per_core;
+        size_t outgoing = core_id * processes + running_[core_id];
+        running_[core_id] = (running_[core_id] + 1) % processes;
+        size_t incoming = core_id * processes + running_[core_id];
+        slice_used_[core_id] = 1;
+        context_switches_++;
+
+        Cache &cache = *caches_[core_id];
+        if (config_.switch_flush == SwitchFlush::Partial)
+        {
+            // 换入的进程仍持有硬件 ASID 时其行可直接复用，否则回收最久未运行进程的 ASID
+            std::vector<size_t> &holders = asid_holders_[core_id];
+            auto holder = std::find(holders.begin(), holders.end(), incoming);
+            if (holder != holders.end())
+            {
+                holders.erase(holder);
+            }
+            else if (holders.size() >= config_.hardware_asids)
+            {
+                size_t victim = holders.back();
+                holders.pop_back();
+                process_stats_[victim].flushed_blocks += cache.flush([victim](uint64_t address) {
+                    return (address >> kAsidShift) == victim;
+                });
+            }
+            holders.insert(holders.begin(), incoming);
+        }
+        else if (config_.switch_flush == SwitchFlush::Full)
+        {
+            process_stats_[outgoing].flushed_blocks += cache.flush([](uint64_t) { return true; });
+        }
+        cache.setOwner(static_cast<uint16_t>(incoming));
+        if (!clos_masks_.empty())
+        {
+            // 切换时装入换入进程的 CLOS（如 resctrl 在切换时写 IA32_PQR_ASSOC）
+            cache.setWayMask(clos_masks_[core_id][closOf(running_[core_id])]);
+        }
+
+        // 首次运行的缺失是冷启动缺失，只有再次换入时才统计重新填充代价
+        process_stats_[incoming].slices++;
+        refilling_[core_id] = has_run_[incoming] && config_.refill_window > 0;
+        has_run_[incoming] = true;
+        since_switch_[core_id] = 0;
+        if (refilling_[core_id])
+        {
+            process_stats_[incoming].refill_windows++;
+        }
+    }
+
+    size_t CacheSimulator::closOf(size_t local) const
+    {
+        if (config_.ucp_interval > 0)
+        {
+            return local;
+        }
+        if (local < config_.process_clos.size())
+        {
+            return config_.process_clos[local];
+        }
+        return local % config_.way_masks.size();
+    }
+
+    void CacheSimulator::createPartitions()
+    {
+        if (config_.ucp_interval == 0 && config_.way_masks.empty())
+        {
+            return;
+        }
+
+        size_t ways = config_.cache_config.associativity;
+        size_t processes = config_.processes_per_core;
+        for (int i = 0; i < config_.num_cores; ++i)
+        {
+            if (config_.ucp_interval > 0)
+            {
+                // UCP 从均分开始，每个进程一个分区
+                std::vector<size_t> allocation(processes, ways / processes);
+                for (size_t p = 0; p < ways % processes; ++p)
+                {
+                    allocation[p]++;
+                }
+                clos_masks_.push_back(contiguousWayMasks(allocation));
+
+                std::vector<std::unique_ptr<UtilityMonitor>> monitors;
+                size_t num_sets = config_.cache_config.cache_size / (config_.cache_config.block_size * ways);
+                for (size_t p = 0; p < processes; ++p)
+                {
+                    monitors.push_back(std::make_unique<UtilityMonitor>(num_sets, ways, config_.cache_config.block_size));
+                }
+                monitors_.push_back(std::move(monitors));
+            }
+            else
+            {
+                clos_masks_.push_back(config_.way_masks);
+            }
+            caches_[i]->setWayMask(clos_masks_[i][closOf(running_[i])]);
+        }
+        since_repartition_.assign(config_.num_cores, 0);
+    }
+
+    void CacheSimulator::repartition(size_t core_id)
+    {
+        std::vector<const UtilityMonitor *> monitors;
+        for (const auto &monitor : monitors_[core_id])
+        {
+            monitors.push_back(monitor.get());
+        }
+        clos_masks_[core_id] = contiguousWayMasks(lookaheadPartition(monitors, config_.cache_config.associativity));
+        for (auto &monitor : monitors_[core_id])
+        {
+            monitor->decay();
+        }
+        caches_[core_id]->setWayMask(clos_masks_[core_id][closOf(running_[core_id])]);
+        since_repartition_[core_id] = 0;
+        repartitions_++;
+    }
+
+    std::vector<PartitionStats> CacheSimulator::getPartitionStats() const
+    {
+        std::vector<PartitionStats> partitions;
+        size_t processes = config_.processes_per_core;
+        for (size_t core = 0; core < clos_masks_.size(); ++core)
+        {
+            std::vector<size_t> occupancy = caches_[core]->occupancyByOwner();
+            for (size_t clos = 0; clos < clos_masks_[core].size(); ++clos)
+            {
+                PartitionStats partition = {core, clos, clos_masks_[core][clos], 0, 0, 0};
+                for (size_t local = 0; local < processes; ++local)
+                {
+                    if (closOf(local) != clos)
+                    {
+                        continue;
+                    }
+                    size_t process = core * processes + local;
+                    const ProcessStats &stats = process_stats_[process];
+                    partition.accesses += stats.accesses;
+                    partition.hits += stats.accesses - stats.misses;
+                    partition.occupancy += process < occupancy.size() ? occupancy[process] : 0;
+                }
+                partitions.push_back(partition);
+            }
+        }
+        return partitions;
+    }
+
+    uint64_t CacheSimulator::getEvictedByOthers(size_t process) const
+    {
+        // 进程的行只由其所在核心的缓存装入
+        const std::vector<uint64_t> &evicted = caches_[process / config_.processes_per_core]->getForeignEvictionsByOwner();
+        return process < evicted.size() ? evicted[process] : 0;
+    }
+
+    BusStats CacheSimulator::getBusStats() const
+    {
+        BusStats total;
+        for (const auto &bus : buses_)
+        {
+            total += bus->getStats();
+        }
+        return total;
+    }
+
+    void CacheSimulator::finishRun()
+    {
+        // 运行结束时排空写缓冲
+        for (auto &cache : caches_)
+        {
+            cache->flushWriteBuffer();
+        }
+        // 写缓冲排空后发出内存控制器中剩余的请求
+        if (memory_)
+        {
+            memory_->drain();
+        }
+    }
+
+    void CacheSimulator::resetStats()
+    {
+        for (auto &cache : caches_)
+        {
+            cache->resetStats();
+        }
+        for (auto &bus : buses_)
+        {
+            bus->resetStats();
+        }
+        if (interconnect_)
+        {
+            interconnect_->resetStats();
+        }
+        if (memory_)
+        {
+            memory_->resetStats();
+        }
+        for (auto &compressed : compressed_)
+        {
+            compressed->resetStats();
+        }
+        for (auto &profiler : core_profilers_)
+        {
+            profiler->resetHistogram();
+        }
+        if (global_profiler_)
+        {
+            global_profiler_->resetHistogram();
+        }
+        if (sharing_detector_)
+        {
+            sharing_detector_->resetStats();
+        }
+        if (vm_)
+        {
+            vm_->resetStats();
+        }
+        std::fill(process_stats_.begin(), process_stats_.end(), ProcessStats());
+        context_switches_ = 0;
+        repartitions_ = 0;
+    }
+
+    bool CacheSimulator::saveCheckpoint(const std::string &path) const
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "[Warning] 无法创建检查点文件 '" << path << "'" << std::endl;
+            return false;
+        }
+
+        const char magic[8] = {'C', 'S', 'C', 'K', 'P', 'T', '\0', '\0'};
+        uint32_t header[3] = {static_cast<uint32_t>(config_.num_cores),
+                              static_cast<uint32_t>(config_.replacement_policy),
+                              static_cast<uint32_t>(config_.cache_config.coherence_protocol)};
+        file.write(magic, sizeof(magic));
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        for (const auto &cache : caches_)
+        {
+            if (!cache->saveState(file))
+            {
+                break;
+            }
+        }
+        if (!file)
+        {
+            std::cerr << "[Warning] 写入检查点文件 '" << path << "' 失败" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool CacheSimulator::loadCheckpoint(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "[Warning] 无法打开检查点文件 '" << path << "'" << std::endl;
+            return false;
+        }
+
+        const char expected[8] = {'C', 'S', 'C', 'K', 'P', 'T', '\0', '\0'};
+        char magic[8];
+        uint32_t header[3];
+        if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), expected) ||
+            !file.read(reinterpret_cast<char *>(header), sizeof(header)))
+        {
+            std::cerr << "[Warning] '" << path << "' 不是检查点文件" << std::endl;
+            return false;
+        }
+        // 一致性状态的含义依赖协议，协议不同时状态不可复用
+        if (header[0] != static_cast<uint32_t>(config_.num_cores) ||
+            header[1] != static_cast<uint32_t>(config_.replacement_policy) ||
+            header[2] != static_cast<uint32_t>(config_.cache_config.coherence_protocol))
+        {
+            std::cerr << "[Warning] 检查点的核心数、替换策略或一致性协议与当前配置不一致" << std::endl;
+            return false;
+        }
+        for (auto &cache : caches_)
+        {
+            if (!cache->loadState(file))
+            {
+                return false;
+            }
+        }
+        resetStats();
+        return true;
+    }
+
+    void CacheSimulator::run()
+    {
+        if (!ok_)
+        {
+            return;
+        }
+
+        // 区间统计：边运行边写出快照
+        std::ofstream interval_file;
+        std::unique_ptr<IntervalRecorder> recorder;
+        if (config_.stats_interval > 0)
+        {
+            interval_file.open(config_.interval_output);
+            if (interval_file)
+            {
+                recorder = std::make_unique<IntervalRecorder>(interval_file, config_.interval_format, caches_.size());
+            }
+            else
+            {
+                std::cerr << "[Warning] 无法打开区间统计输出文件 '" << config_.interval_output << "'，已关闭区间统计。" << std::endl;
+            }
+        }
+
+        MemoryAccess access;
+
+        // 预热：只填充缓存，结束后清零统计
+        size_t warmed = 0;
+        while (warmed < config_.warmup_accesses && nextAccess(access))
+        {
+            performAccess(access.core_id, access.address, access.is_write);
+            ++warmed;
+        }
+        if (warmed > 0)
+        {
+            resetStats();
+        }
+
+        while (executed_accesses_ < config_.num_accesses && nextAccess(access))
+        {
+            performAccess(access.core_id, access.address, access.is_write);
+            ++executed_accesses_;
+
+            if (recorder && executed_accesses_ % config_.stats_interval == 0)
+            {
+                recorder->record(executed_accesses_, caches_);
+            }
+        }
+
+        finishRun();
+
+        // 记录最后一个不完整的区间
+        if (recorder && executed_accesses_ % config_.stats_interval != 0)
+        {
+            recorder->record(executed_accesses_, caches_);
+        }
+
+#ifdef CACHE_SIM_SET_STATS
+        if (!config_.set_heatmap_output.empty())
+        {
+            writeSetHeatmap();
+        }
+#endif
+    }
+
+    bool CacheSimulator::compareProtocols(const SimulatorConfig &config)
+    {
+        const CoherenceProtocol protocols[] = {CoherenceProtocol::MESI, CoherenceProtocol::MOESI, CoherenceProtocol::MESIF};
+
+        std::vector<std::unique_ptr<CacheSimulator>> simulators;
+        for (CoherenceProtocol protocol : protocols)
+        {
+            SimulatorConfig protocol_config = config;
+            protocol_config.cache_config.coherence_protocol = protocol;
+            if (!simulators.empty())
+            {
+                // 访问流只由第一个模拟器读取
+                protocol_config.trace_files.clear();
+            }
+            simulators.push_back(std::make_unique<CacheSimulator>(protocol_config));
+        }
+        if (!simulators[0]->ok())
+        {
+            return false;
+        }
+
+        // 由第一个模拟器生成访问流，逐条同时送入所有模拟器，无需缓存整个访问流
+        MemoryAccess access;
+        for (size_t i = 0; i < config.warmup_accesses && simulators[0]->nextAccess(access); ++i)
+        {
+            for (auto &simulator : simulators)
+            {
+                simulator->performAccess(access.core_id, access.address, access.is_write);
+            }
+        }
+        for (auto &simulator : simulators)
+        {
+            simulator->resetStats();
+        }
+
+        for (size_t i = 0; i < config.num_accesses && simulators[0]->nextAccess(access); ++i)
+        {
+            for (auto &simulator : simulators)
+            {
+                simulator->performAccess(access.core_id, access.address, access.is_write);
+            }
+        }
+        for (auto &simulator : simulators)
+        {
+            simulator->finishRun();
+        }
+
+        if (config.output_json)
+        {
+            std::ostringstream oss;
+            oss << "{\n  \"protocols\": [\n";
+            for (size_t p = 0; p < simulators.size(); ++p)
+            {
+                const CacheSimulator &simulator = *simulators[p];
+                oss << "    {\n"
+                    << "      \"protocol\": \"" << SimulatorConfig::getProtocolName(protocols[p]) << "\",\n";
+                simulator.writeStatsJson(oss, simulator.getAverageStats(), "      ");
+                oss << ",\n      \"bus\": ";
+                simulator.writeBusStatsJson(oss, "      ");
+                oss << "\n    }" << (p + 1 == simulators.size() ? "\n" : ",\n");
+            }
+            oss << "  ]\n}\n";
+            std::cout << oss.str();
+        }
+        else
+        {
+            std::cout << "========== 一致性协议流量对比 ==========" << std::endl;
+            std::cout << std::left << std::setw(8) << "协议"
+                      << std::right << std::setw(10) << "命中率"
+                      << std::setw(10) << "BusRd" << std::setw(10) << "BusRdX" << std::setw(10) << "BusUpgr"
+                      << std::setw(10) << "Flush" << std::setw(10) << "C2C" << std::setw(10) << "Inval"
+                      << std::setw(12) << "MemRead" << std::setw(12) << "MemWrite" << std::endl;
+            for (size_t p = 0; p < simulators.size(); ++p)
+            {
+                const BusStats &bus = simulators[p]->getBusStats();
+                CacheStats total;
+                for (const auto &cache : simulators[p]->caches_)
+                {
+                    total += cache->getStats();
+                }
+                std::cout << std::left << std::setw(8) << SimulatorConfig::getProtocolName(protocols[p])
+                          << std::right << std::setw(9) << std::fixed << std::setprecision(2) << total.hitRate() * 100 << "%"
+                          << std::setw(10) << bus.bus_rd << std::setw(10) << bus.bus_rdx << std::setw(10) << bus.bus_upgr
+                          << std::setw(10) << bus.flushes << std::setw(10) << bus.cache_to_cache << std::setw(10) << bus.invalidations
+                          << std::setw(12) << bus.memory_reads << std::setw(12) << total.memory_writes << std::endl;
+            }
+            std::cout << "========================================" << std::endl;
+        }
+        return true;
+    }
+
+    bool CacheSimulator::runPageCache(const SimulatorConfig &config)
+    {
+        const PageCacheConfig &pc_config = config.page_cache_config;
+        PageCache page_cache(config.cache_config, config.replacement_policy, pc_config);
+        size_t page_size = config.cache_config.block_size;
+
+        // 请求来自 I/O trace，或把访问模式生成的地址按文件大小切分为 (文件, 偏移)
+        std::ifstream trace;
+        std::unique_ptr<WorkloadStream> stream;
+        if (!pc_config.io_trace.empty())
+        {
+            trace.open(pc_config.io_trace);
+            if (!trace)
+            {
+                std::cerr << "[Warning] 无法打开 I/O trace 文件 '" << pc_config.io_trace << "'" << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            stream = std::make_unique<WorkloadStream>(config.defaultWorkload(), page_size, 0, 1, config.seed);
+        }
+
+        uint64_t skipped = 0;
+        uint64_t malformed = 0;
+        std::string line;
+        auto next_request = [&](IoRequest &request) -> bool {
+            if (stream)
+            {
+                uint64_t address;
+                stream->next(address, request.is_write);
+                request.file_id = address / pc_config.file_size;
+                request.offset = address % pc_config.file_size;
+                request.length = pc_config.io_size > 0 ? pc_config.io_size : page_size;
+                return true;
+            }
+            while (std::getline(trace, line))
+            {
+                if (line.empty() || line[0] == '#')
+                {
+                    continue;
+                }
+                if (parseIoRequest(line, request))
+                {
+                    return true;
+                }
+                ++malformed;
+            }
+            return false;
+        };
+
+        IoRequest request;
+        for (size_t i = 0; i < config.warmup_accesses && next_request(request); ++i)
+        {
+            page_cache.access(request);
+        }
+        page_cache.resetStats();
+        for (size_t i = 0; i < config.num_accesses && next_request(request); ++i)
+        {
+            if (!page_cache.access(request))
+            {
+                ++skipped;
+            }
+        }
+        if (malformed > 0)
+        {
+            std::cerr << "[Warning] 忽略了 " << malformed << " 行无法解析的 I/O 请求" << std::endl;
+        }
+
+        const PageCacheStats &stats = page_cache.getStats();
+        const CacheStats &cache_stats = page_cache.getCacheStats();
+        const CacheConfig &cache_config = page_cache.getCacheConfig();
+        uint64_t page_accesses = cache_stats.hits + cache_stats.misses;
+        uint64_t eviction_writebacks = cache_stats.writebacks > stats.flushed_pages ? cache_stats.writebacks - stats.flushed_pages : 0;
+        size_t dirty_pages = page_cache.dirtyPages();
+
+        if (config.output_json)
+        {
+            std::ostringstream oss;
+            oss << "{\n  \"seed\": " << config.seed << ",\n"
+                << "  \"warmup_requests\": " << config.warmup_accesses << ",\n"
+                << "  \"page_cache\": {\n"
+                << "    \"cache_size\": " << cache_config.cache_size << ",\n"
+                << "    \"page_size\": " << cache_config.block_size << ",\n"
+                << "    \"associativity\": " << cache_config.associativity << ",\n"
+                << "    \"policy\": \"" << SimulatorConfig::getPolicyName(config.replacement_policy) << "\",\n"
+                << "    \"max_readahead\": " << pc_config.max_readahead << ",\n"
+                << "    \"flush_interval\": " << pc_config.flush_interval << ",\n"
+                << "    \"dirty_expire\": " << pc_config.dirty_expire << "\n"
+                << "  },\n"
+                << "  \"requests\": " << stats.requests << ",\n"
+                << "  \"read_requests\": " << stats.read_requests << ",\n"
+                << "  \"write_requests\": " << stats.write_requests << ",\n"
+                << "  \"skipped_requests\": " << skipped << ",\n"
+                << "  \"read_bytes\": " << stats.read_bytes << ",\n"
+                << "  \"write_bytes\": " << stats.write_bytes << ",\n"
+                << "  \"page_accesses\": " << page_accesses << ",\n"
+                << "  \"page_hits\": " << cache_stats.hits << ",\n"
+                << "  \"page_misses\": " << cache_stats.misses << ",\n"
+                << "  \"hit_rate\": " << cache_stats.hitRate() << ",\n"
+                << "  \"disk_reads\": " << stats.disk_reads << ",\n"
+                << "  \"disk_read_bytes\": " << stats.disk_reads * page_size << ",\n"
+                << "  \"partial_writes\": " << stats.partial_writes << ",\n"
+                << "  \"readahead\": {\n"
+                << "    \"windows\": " << stats.readahead_windows << ",\n"
+                << "    \"pages\": " << stats.readahead_pages << ",\n"
+                << "    \"hits\": " << stats.readahead_hits << ",\n"
+                << "    \"efficiency\": " << stats.readaheadEfficiency() << "\n"
+                << "  },\n"
+                << "  \"writeback\": {\n"
+                << "    \"pages\": " << cache_stats.writebacks << ",\n"
+                << "    \"bytes\": " << cache_stats.memory_write_bytes << ",\n"
+                << "    \"periodic_flush_pages\": " << stats.flushed_pages << ",\n"
+                << "    \"eviction_pages\": " << eviction_writebacks << ",\n"
+                << "    \"dirty_pages\": " << dirty_pages << "\n"
+                << "  }\n"
+                << "}\n";
+            std::cout << oss.str();
+            return true;
+        }
+
+        std::cout << "========== 页缓存模拟结果 ==========" << std::endl;
+        std::cout << "--- 配置 ---" << std::endl;
+        std::cout << "页缓存大小: " << cache_config.cache_size << " 字节 ("
+                  << cache_config.cache_size / (1024 * 1024) << " MB)" << std::endl;
+        std::cout << "页大小: " << cache_config.block_size << " 字节" << std::endl;
+        std::cout << "关联度: " << cache_config.associativity << " 路组相联" << std::endl;
+        std::cout << "替换策略: " << SimulatorConfig::getPolicyName(config.replacement_policy) << std::endl;
+        if (pc_config.max_readahead > 0)
+        {
+            std::cout << "最大预读窗口: " << pc_config.max_readahead << " 页" << std::endl;
+        }
+        else
+        {
+            std::cout << "预读: 关闭" << std::endl;
+        }
+        if (pc_config.flush_interval > 0)
+        {
+            std::cout << "定期回写: 每 " << pc_config.flush_interval << " 个请求写出变脏超过 "
+                      << pc_config.dirty_expire << " 个请求的页" << std::endl;
+        }
+        else
+        {
+            std::cout << "定期回写: 关闭（脏页只在驱逐时写回）" << std::endl;
+        }
+        if (!pc_config.io_trace.empty())
+        {
+            std::cout << "I/O trace: " << pc_config.io_trace << std::endl;
+        }
+        else
+        {
+            std::cout << "访问模式: " << getPatterName(config.access_pattern)
+                      << "（文件大小 " << pc_config.file_size << " 字节，请求长度 "
+                      << (pc_config.io_size > 0 ? pc_config.io_size : page_size) << " 字节）" << std::endl;
+            std::cout << "随机数种子: " << config.seed << std::endl;
+        }
+        if (config.warmup_accesses > 0)
+        {
+            std::cout << "预热请求: " << config.warmup_accesses << "（不计入统计）" << std::endl;
+        }
+        std::cout << std::endl;
+
+        std::cout << "--- 统计 ---" << std::endl;
+        std::cout << "请求数: " << stats.requests << "（读 " << stats.read_requests << "，写 " << stats.write_requests << "）" << std::endl;
+        if (skipped > 0)
+        {
+            std::cout << "超出地址上限而忽略的请求: " << skipped << std::endl;
+        }
+        std::cout << "请求字节: 读 " << stats.read_bytes << "，写 " << stats.write_bytes << std::endl;
+        std::cout << "页访问: " << page_accesses << "（命中 " << cache_stats.hits << "，缺失 " << cache_stats.misses << "）" << std::endl;
+        std::cout << "命中率: " << std::fixed << std::setprecision(2) << cache_stats.hitRate() * 100 << "%" << std::endl;
+        std::cout << "磁盘读入: " << stats.disk_reads << " 页（" << stats.disk_reads * page_size << " 字节，其中预读 "
+                  << stats.readahead_pages << " 页，读改写 " << stats.partial_writes << " 页）" << std::endl;
+        std::cout << "预读窗口: " << stats.readahead_windows << std::endl;
+        std::cout << "预读命中: " << stats.readahead_hits << " / " << stats.readahead_pages << " 页" << std::endl;
+        std::cout << "预读效率: " << std::fixed << std::setprecision(2) << stats.readaheadEfficiency() * 100 << "%" << std::endl;
+        std::cout << "回写: " << cache_stats.writebacks << " 页（" << cache_stats.memory_write_bytes << " 字节，定期回写 "
+                  << stats.flushed_pages << " 页，驱逐回写 " << eviction_writebacks << " 页）" << std::endl;
+        std::cout << "剩余脏页: " << dirty_pages << std::endl;
+        std::cout << "====================================" << std::endl;
+        return true;
+    }
+
+    void CacheSimulator::writeBusStatsJson(std::ostream &os, const std::string &indent) const
+    {
+        BusStats bus = getBusStats();
+        os << "{\n"
+           << indent << "  \"transactions\": " << bus.transactions() << ",\n"
+           << indent << "  \"bus_rd\": " << bus.bus_rd << ",\n"
+           << indent << "  \"bus_rdx\": " << bus.bus_rdx << ",\n"
+           << indent << "  \"bus_upgr\": " << bus.bus_upgr << ",\n"
+           << indent << "  \"flushes\": " << bus.flushes << ",\n"
+           << indent << "  \"cache_to_cache\": " << bus.cache_to_cache << ",\n"
+           << indent << "  \"invalidations\": " << bus.invalidations << ",\n"
+           << indent << "  \"memory_reads\": " << bus.memory_reads << "\n"
+           << indent << "}";
+    }
+
+    void CacheSimulator::writeSharingJson(std::ostream &os, const std::string &indent) const
+    {
+        os << "{\n"
+           << indent << "  \"true_sharing_misses\": " << sharing_detector_->trueSharingMisses() << ",\n"
+           << indent << "  \"false_sharing_misses\": " << sharing_detector_->falseSharingMisses() << ",\n"
+           << indent << "  \"tracked_blocks\": " << sharing_detector_->trackedBlocks() << ",\n"
+           << indent << "  \"top_blocks\": [";
+
+        std::vector<BlockSharingReport> blocks = sharing_detector_->topBlocks(config_.sharing_top_blocks);
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            const BlockSharingReport &block = blocks[i];
+            os << (i == 0 ? "\n" : ",\n")
+               << indent << "    {\"address\": \"0x" << std::hex << block.block_address << std::dec << "\""
+               << ", \"true_sharing\": " << block.true_sharing
+               << ", \"false_sharing\": " << block.false_sharing
+               << ", \"invalidations\": " << block.invalidations
+               << ", \"cores\": " << block.cores
+               << ", \"written_bytes\": " << block.written_bytes
+               << ", \"overlapping_writes\": " << (block.overlapping_writes ? "true" : "false") << "}";
+        }
+        os << (blocks.empty() ? "]\n" : "\n" + indent + "  ]\n") << indent << "}";
+    }
+
+    void CacheSimulator::printSharingText() const
+    {
+        uint64_t true_sharing = sharing_detector_->trueSharingMisses();
+        uint64_t false_sharing = sharing_detector_->falseSharingMisses();
+        uint64_t coherence_misses = true_sharing + false_sharing;
+
+        std::cout << std::endl;
+        std::cout << "--- 共享缺失分析 ---" << std::endl;
+        std::cout << "一致性缺失: " << coherence_misses << std::endl;
+        std::cout << "真共享缺失: " << true_sharing << std::endl;
+        std::cout << "伪共享缺失: " << false_sharing;
+        if (coherence_misses > 0)
+        {
+            std::cout << " (" << std::fixed << std::setprecision(2)
+                      << static_cast<double>(false_sharing) * 100.0 / coherence_misses << "%)";
+        }
+        std::cout << std::endl;
+
+        std::vector<BlockSharingReport> blocks = sharing_detector_->topBlocks(config_.sharing_top_blocks);
+        if (blocks.empty())
+        {
+            return;
+        }
+        std::cout << "一致性缺失最多的块:" << std::endl;
+        for (const BlockSharingReport &block : blocks)
+        {
+            std::cout << "  0x" << std::hex << block.block_address << std::dec
+                      << ": 真共享 " << block.true_sharing
+                      << ", 伪共享 " << block.false_sharing
+                      << ", 作废 " << block.invalidations
+                      << ", 核心 " << block.cores
+                      << ", 写入字节 " << block.written_bytes
+                      << (block.overlapping_writes ? "（多核写同一字节）" : "（各核写入互不重叠）") << std::endl;
+        }
+    }
+
+    CacheStats CacheSimulator::tlbTotalStats(size_t level) const
+    {
+        CacheStats total;
+        for (size_t core = 0; core < caches_.size(); ++core)
+        {
+            total += vm_->getTlbStats(core, level);
+        }
+        return total;
+    }
+
+    void CacheSimulator::writeVirtualMemoryJson(std::ostream &os, const std::string &indent) const
+    {
+        const VirtualMemoryConfig &vm_config = vm_->getConfig();
+        const VirtualMemoryStats &stats = vm_->getStats();
+        os << "{\n"
+           << indent << "  \"page_size\": " << vm_config.page_size << ",\n"
+           << indent << "  \"page_table_levels\": " << vm_config.page_table_levels << ",\n"
+           << indent << "  \"physical_frames\": " << vm_config.physical_frames << ",\n"
+           << indent << "  \"page_replacement\": \"" << VirtualMemory::getReplacementName(vm_config.page_replacement) << "\",\n"
+           << indent << "  \"tlb\": [";
+        for (size_t level = 0; level < vm_config.tlb_levels.size(); ++level)
+        {
+            CacheStats tlb = tlbTotalStats(level);
+            os << (level == 0 ? "\n" : ",\n") << indent << "    {\"level\": " << level + 1
+               << ", \"entries\": " << vm_config.tlb_levels[level].entries
+               << ", \"associativity\": " << vm_config.tlb_levels[level].associativity
+               << ", \"reach\": " << vm_config.tlb_levels[level].entries * vm_config.page_size
+               << ", \"hits\": " << tlb.hits << ", \"misses\": " << tlb.misses
+               << ", \"hit_rate\": " << std::fixed << std::setprecision(2) << tlb.hitRate() * 100.0 << "}";
+        }
+        os << (vm_config.tlb_levels.empty() ? "],\n" : "\n" + indent + "  ],\n")
+           << indent << "  \"translations\": " << stats.translations << ",\n"
+           << indent << "  \"page_walks\": " << stats.page_walks << ",\n"
+           << indent << "  \"pte_accesses\": " << stats.pte_accesses << ",\n"
+           << indent << "  \"pte_cache_hits\": " << stats.pte_cache_hits << ",\n"
+           << indent << "  \"page_faults\": " << stats.page_faults << ",\n"
+           << indent << "  \"major_faults\": " << stats.major_faults << ",\n"
+           << indent << "  \"page_evictions\": " << stats.page_evictions << ",\n"
+           << indent << "  \"swap_outs\": " << stats.swap_outs << ",\n"
+           << indent << "  \"tlb_shootdowns\": " << stats.tlb_shootdowns << ",\n"
+           << indent << "  \"resident_pages\": " << vm_->residentPages() << ",\n"
+           << indent << "  \"page_table_pages\": " << vm_->pageTablePages() << "\n"
+           << indent << "}";
+    }
+
+    void CacheSimulator::printVirtualMemoryText() const
+    {
+        const VirtualMemoryConfig &vm_config = vm_->getConfig();
+        const VirtualMemoryStats &stats = vm_->getStats();
+
+        std::cout << std::endl;
+        std::cout << "--- 虚拟内存 ---" << std::endl;
+        std::cout << "页大小: " << vm_config.page_size << " 字节, 页表 " << vm_config.page_table_levels << " 级" << std::endl;
+        std::cout << "物理页框: ";
+        if (vm_config.physical_frames == 0)
+        {
+            std::cout << "不限" << std::endl;
+        }
+        else
+        {
+            std::cout << vm_config.physical_frames << " (" << VirtualMemory::getReplacementName(vm_config.page_replacement) << " 置换)" << std::endl;
+        }
+        std::cout << "地址转换: " << stats.translations << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (size_t level = 0; level < vm_config.tlb_levels.size(); ++level)
+        {
+            CacheStats tlb = tlbTotalStats(level);
+            std::cout << "L" << level + 1 << " TLB (" << vm_config.tlb_levels[level].entries << " 项, "
+                      << vm_config.tlb_levels[level].associativity << " 路, 覆盖 "
+                      << vm_config.tlb_levels[level].entries * vm_config.page_size / 1024 << " KB): 命中 "
+                      << tlb.hits << " / " << tlb.hits + tlb.misses << " (" << tlb.hitRate() * 100 << "%)" << std::endl;
+        }
+        std::cout << "页表遍历: " << stats.page_walks << std::endl;
+        std::cout << "页表项读取: " << stats.pte_accesses << ", 数据缓存命中 " << stats.pte_cache_hits;
+        if (stats.pte_accesses > 0)
+        {
+            std::cout << " (" << static_cast<double>(stats.pte_cache_hits) * 100.0 / stats.pte_accesses << "%)";
+        }
+        std::cout << std::endl;
+        std::cout << "缺页: " << stats.page_faults << ", 其中换入 " << stats.major_faults << std::endl;
+        std::cout << "页面置换: " << stats.page_evictions << ", 脏页写回 " << stats.swap_outs << std::endl;
+        std::cout << "TLB 击落: " << stats.tlb_shootdowns << std::endl;
+        std::cout << "驻留页: " << vm_->residentPages() << ", 页表页: " << vm_->pageTablePages() << std::endl;
+    }
 
-    CacheSimulator::CacheSimulator(const SimulatorConfig &config)
-        : config_(config)
+    void CacheSimulator::writeNumaJson(std::ostream &os, const std::string &indent) const
     {
-        createCaches();
+        const NumaConfig &numa = interconnect_->getConfig();
+        const std::vector<NumaSocketStats> &sockets = interconnect_->getStats();
+        os << "{\n"
+           << indent << "  \"sockets\": " << numa.sockets << ",\n"
+           << indent << "  \"interleave\": \"" << Interconnect::getInterleaveName(numa.interleave) << "\",\n"
+           << indent << "  \"page_size\": " << numa.page_size << ",\n"
+           << indent << "  \"latency\": {\"local_cache\": " << numa.local_cache_latency
+           << ", \"remote_cache\": " << numa.remote_cache_latency
+           << ", \"local_memory\": " << numa.local_memory_latency
+           << ", \"remote_memory\": " << numa.remote_memory_latency << "},\n"
+           << indent << "  \"list\": [";
+        for (size_t socket = 0; socket < sockets.size(); ++socket)
+        {
+            const NumaSocketStats &stats = sockets[socket];
+            CacheStats total;
+            for (size_t core = 0; core < caches_.size(); ++core)
+            {
+                if (socketOf(core) == socket)
+                {
+                    total += caches_[core]->getStats();
+                }
+            }
+            os << (socket == 0 ? "\n" : ",\n") << indent << "    {\"socket\": " << socket
+               << ", \"local_hits\": " << total.hits
+               << ", \"local_transfers\": " << stats.local_transfers
+               << ", \"remote_cache_hits\": " << stats.remote_cache_hits
+               << ", \"local_memory\": " << stats.local_memory
+               << ", \"remote_memory\": " << stats.remote_memory
+               << ", \"remote_invalidations\": " << stats.remote_invalidations
+               << ", \"remote_writebacks\": " << stats.remote_writebacks
+               << ", \"stale_sharers\": " << stats.stale_sharers
+               << ", \"avg_miss_latency\": " << std::fixed << std::setprecision(2) << interconnect_->averageMissLatency(socket) << "}";
+        }
+        os << "\n" << indent << "  ]\n"
+           << indent << "}";
     }
 
-    void CacheSimulator::createCaches()
+    void CacheSimulator::printNumaText() const
     {
-        bus_ = std::make_unique<Bus>();
-        caches_.reserve(config_.num_cores);
+        const NumaConfig &numa = interconnect_->getConfig();
+        const std::vector<NumaSocketStats> &sockets = interconnect_->getStats();
 
-        for (int i = 0; i < config_.num_cores; ++i)
+        std::cout << std::endl;
+        std::cout << "--- 多插槽 (NUMA) ---" << std::endl;
+        std::cout << "插槽: " << numa.sockets << ", 每插槽 " << caches_.size() / numa.sockets << " 核心, 内存分布: "
+                  << Interconnect::getInterleaveName(numa.interleave) << " (" << numa.page_size << " 字节页)" << std::endl;
+        std::cout << "延迟: 本地缓存 " << numa.local_cache_latency << ", 远程缓存 " << numa.remote_cache_latency
+                  << ", 本地内存 " << numa.local_memory_latency << ", 远程内存 " << numa.remote_memory_latency << " 周期" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (size_t socket = 0; socket < sockets.size(); ++socket)
         {
-            std::unique_ptr<Cache> cache;
-            switch (config_.replacement_policy)
+            const NumaSocketStats &stats = sockets[socket];
+            uint64_t hits = 0;
+            for (size_t core = 0; core < caches_.size(); ++core)
             {
-            case ReplacementPolicy::LRU:
-                cache = std::make_unique<LRUCache>(config_.cache_config, i, bus_.get());
-                break;
-            case ReplacementPolicy::LFU:
-                cache = std::make_unique<LFUCache>(config_.cache_config, i, bus_.get());
-                break;
+                if (socketOf(core) == socket)
+                {
+                    hits += caches_[core]->getStats().hits;
+                }
+            }
+            std::cout << "插槽 " << socket << ": 本地命中 " << hits << ", 插槽内传输 " << stats.local_transfers
+                      << ", 远程缓存 " << stats.remote_cache_hits << ", 本地内存 " << stats.local_memory
+                      << ", 远程内存 " << stats.remote_memory << ", 远程作废 " << stats.remote_invalidations
+                      << ", 远程写回 " << stats.remote_writebacks
+                      << ", 平均缺失延迟 " << interconnect_->averageMissLatency(socket) << " 周期" << std::endl;
+        }
+    }
 
-            default:
-                std::cerr << "[Warning] 未知的替换策略，使用默认的 LRU 策略。" << std::endl;
-                cache = std::make_unique<LRUCache>(config_.cache_config, i, bus_.get());
-                break;
+    void CacheSimulator::writeDramJson(std::ostream &os, const std::string &indent) const
+    {
+        const DramConfig &dram = memory_->getConfig();
+        const DramStats &stats = memory_->getStats();
+        os << "{\n"
+           << indent << "  \"channels\": " << dram.channels << ",\n"
+           << indent << "  \"ranks\": " << dram.ranks << ",\n"
+           << indent << "  \"banks\": " << dram.banks << ",\n"
+           << indent << "  \"row_size\": " << dram.row_size << ",\n"
+           << indent << "  \"page_policy\": \"" << MemoryController::getPagePolicyName(dram.page_policy) << "\",\n"
+           << indent << "  \"mapping\": \"" << MemoryController::getMappingName(dram.mapping) << "\",\n"
+           << indent << "  \"timing\": {\"t_rcd\": " << dram.t_rcd << ", \"t_rp\": " << dram.t_rp
+           << ", \"t_cas\": " << dram.t_cas << ", \"t_burst\": " << dram.t_burst << "},\n"
+           << indent << "  \"reads\": " << stats.reads << ",\n"
+           << indent << "  \"writes\": " << stats.writes << ",\n"
+           << indent << "  \"row_hits\": " << stats.row_hits << ",\n"
+           << indent << "  \"row_empty\": " << stats.row_empty << ",\n"
+           << indent << "  \"row_conflicts\": " << stats.row_conflicts << ",\n"
+           << indent << "  \"row_hit_rate\": " << std::fixed << std::setprecision(2) << stats.rowHitRate() * 100.0 << ",\n"
+           << indent << "  \"avg_queue_cycles\": " << stats.avgQueueCycles() << ",\n"
+           << indent << "  \"avg_read_latency_cycles\": " << stats.avgReadLatency() << ",\n"
+           << indent << "  \"avg_read_latency_ns\": " << stats.avgReadLatency() * 1000.0 / dram.clock_mhz << ",\n"
+           << indent << "  \"queue_full_stalls\": " << stats.queue_full_stalls << ",\n"
+           << indent << "  \"stall_cycles\": " << stats.stall_cycles << ",\n"
+           << indent << "  \"bytes\": " << stats.bytes << ",\n"
+           << indent << "  \"elapsed_cycles\": " << memory_->elapsedCycles() << ",\n"
+           << indent << "  \"bandwidth_gbps\": " << memory_->bandwidth() << ",\n"
+           << indent << "  \"peak_bandwidth_gbps\": " << memory_->peakBandwidth() << "\n"
+           << indent << "}";
+    }
+
+    void CacheSimulator::printDramText() const
+    {
+        const DramConfig &dram = memory_->getConfig();
+        const DramStats &stats = memory_->getStats();
+
+        std::cout << std::endl;
+        std::cout << "--- DRAM ---" << std::endl;
+        std::cout << "组织: " << dram.channels << " 通道 x " << dram.ranks << " rank x " << dram.banks << " bank, 行大小 "
+                  << dram.row_size << " 字节, " << MemoryController::getPagePolicyName(dram.page_policy) << ", "
+                  << MemoryController::getMappingName(dram.mapping) << std::endl;
+        std::cout << "时序: tRCD " << dram.t_rcd << ", tRP " << dram.t_rp << ", tCAS " << dram.t_cas
+                  << ", 突发 " << dram.t_burst << " 周期 (" << dram.clock_mhz << " MHz)" << std::endl;
+        std::cout << "请求: 读 " << stats.reads << ", 写 " << stats.writes << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "行缓冲: 命中 " << stats.row_hits << ", 空 " << stats.row_empty << ", 冲突 " << stats.row_conflicts
+                  << " (命中率 " << stats.rowHitRate() * 100 << "%)" << std::endl;
+        std::cout << "平均排队: " << stats.avgQueueCycles() << " 周期, 队列满停顿 " << stats.queue_full_stalls << " 次 ("
+                  << stats.stall_cycles << " 周期)" << std::endl;
+        std::cout << "平均读延迟: " << stats.avgReadLatency() << " 周期 (" << stats.avgReadLatency() * 1000.0 / dram.clock_mhz
+                  << " ns)" << std::endl;
+        std::cout << "带宽: " << memory_->bandwidth() << " GB/s / 峰值 " << memory_->peakBandwidth() << " GB/s ("
+                  << stats.bytes << " 字节, " << memory_->elapsedCycles() << " 周期)" << std::endl;
+    }
+
+    CompressionStats CacheSimulator::compressionTotalStats() const
+    {
+        CompressionStats total;
+        for (const auto &compressed : compressed_)
+        {
+            const CompressionStats &stats = compressed->getStats();
+            total.hits += stats.hits;
+            total.misses += stats.misses;
+            total.evictions += stats.evictions;
+            total.writebacks += stats.writebacks;
+            total.fill_bytes += stats.fill_bytes;
+            total.size_changes += stats.size_changes;
+            total.growth_evictions += stats.growth_evictions;
+            for (size_t i = 0; i < static_cast<size_t>(BdiEncoding::Count); ++i)
+            {
+                total.encodings[i] += stats.encodings[i];
             }
+        }
+        return total;
+    }
 
-            bus_->attach(cache.get());
-            caches_.push_back(std::move(cache));
+    void CacheSimulator::writeCompressionJson(std::ostream &os, const std::string &indent) const
+    {
+        const CompressionConfig &compression = config_.compression_config;
+        CompressionStats stats = compressionTotalStats();
+        CacheStats baseline = getAverageStats();
+        size_t physical = 0;
+        size_t effective = 0;
+        double ratio = 0.0;
+        for (const auto &compressed : compressed_)
+        {
+            physical += compressed->physicalCapacity();
+            effective += compressed->effectiveCapacity();
+            ratio += compressed->compressionRatio();
+        }
+
+        os << "{\n"
+           << indent << "  \"algorithm\": \"" << CompressedCache::getAlgorithmName(compression.algorithm) << "\",\n"
+           << indent << "  \"values\": \"" << MemoryImage::getValueModelName(compression.value_model) << "\",\n"
+           << indent << "  \"tag_factor\": " << compression.tag_factor << ",\n"
+           << indent << "  \"segment_size\": " << compression.segment_size << ",\n"
+           << indent << "  \"hits\": " << stats.hits << ",\n"
+           << indent << "  \"misses\": " << stats.misses << ",\n"
+           << indent << "  \"evictions\": " << stats.evictions << ",\n"
+           << indent << "  \"writebacks\": " << stats.writebacks << ",\n"
+           << indent << "  \"size_changes\": " << stats.size_changes << ",\n"
+           << indent << "  \"growth_evictions\": " << stats.growth_evictions << ",\n"
+           << indent << "  \"hit_rate\": " << std::fixed << std::setprecision(2) << stats.hitRate() * 100.0 << ",\n"
+           << indent << "  \"baseline_hit_rate\": " << baseline.hitRate() * 100.0 << ",\n"
+           << indent << "  \"avg_fill_bytes\": " << stats.avgFillBytes() << ",\n"
+           << indent << "  \"compression_ratio\": " << ratio / compressed_.size() << ",\n"
+           << indent << "  \"physical_capacity\": " << physical << ",\n"
+           << indent << "  \"effective_capacity\": " << effective;
+        if (compression.algorithm == CompressionAlgorithm::BDI)
+        {
+            os << ",\n"
+               << indent << "  \"encodings\": {";
+            for (size_t i = 0; i < static_cast<size_t>(BdiEncoding::Count); ++i)
+            {
+                os << (i > 0 ? ", " : "") << "\"" << CompressedCache::getEncodingName(static_cast<BdiEncoding>(i)) << "\": "
+                   << stats.encodings[i];
+            }
+            os << "}";
         }
+        os << "\n"
+           << indent << "}";
     }
 
-    void CacheSimulator::run()
+    void CacheSimulator::printCompressionText() const
+    {
+        const CompressionConfig &compression = config_.compression_config;
+        CompressionStats stats = compressionTotalStats();
+        CacheStats baseline = getAverageStats();
+        size_t physical = 0;
+        size_t effective = 0;
+        double ratio = 0.0;
+        for (const auto &compressed : compressed_)
+        {
+            physical += compressed->physicalCapacity();
+            effective += compressed->effectiveCapacity();
+            ratio += compressed->compressionRatio();
+        }
+
+        std::cout << std::endl;
+        std::cout << "--- 压缩缓存 ---" << std::endl;
+        std::cout << "算法: " << CompressedCache::getAlgorithmName(compression.algorithm) << ", 取值: "
+                  << MemoryImage::getValueModelName(compression.value_model) << ", 每组标签 " << compression.tag_factor
+                  << " 倍路数, 分配粒度 " << compression.segment_size << " 字节" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "命中率: " << stats.hitRate() * 100 << "% (未压缩 " << baseline.hitRate() * 100 << "%), 命中 "
+                  << stats.hits << ", 缺失 " << stats.misses << std::endl;
+        std::cout << "驱逐: " << stats.evictions << " (脏块 " << stats.writebacks << ", 写入变大导致 " << stats.growth_evictions
+                  << "), 写入改变大小 " << stats.size_changes << " 次" << std::endl;
+        std::cout << "压缩率: " << ratio / compressed_.size() << ", 装入块平均 " << stats.avgFillBytes() << " 字节" << std::endl;
+        std::cout << "有效容量: " << effective << " 字节 / 物理容量 " << physical << " 字节 ("
+                  << (physical > 0 ? static_cast<double>(effective) / physical : 0.0) << " 倍)" << std::endl;
+        if (compression.algorithm == CompressionAlgorithm::BDI && stats.misses > 0)
+        {
+            std::cout << "编码分布:";
+            for (size_t i = 0; i < static_cast<size_t>(BdiEncoding::Count); ++i)
+            {
+                std::cout << " " << CompressedCache::getEncodingName(static_cast<BdiEncoding>(i)) << " "
+                          << stats.encodings[i] * 100.0 / stats.misses << "%";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    void CacheSimulator::writeProcessJson(std::ostream &os, const std::string &indent) const
+    {
+        os << "{\n"
+           << indent << "  \"per_core\": " << config_.processes_per_core << ",\n"
+           << indent << "  \"time_slice\": " << config_.time_slice << ",\n"
+           << indent << "  \"switch_flush\": \"" << SimulatorConfig::getSwitchFlushName(config_.switch_flush) << "\",\n"
+           << indent << "  \"refill_window\": " << config_.refill_window << ",\n"
+           << indent << "  \"hardware_asids\": " << config_.hardware_asids << ",\n"
+           << indent << "  \"context_switches\": " << context_switches_ << ",\n"
+           << indent << "  \"list\": [";
+        for (size_t p = 0; p < process_stats_.size(); ++p)
+        {
+            const ProcessStats &stats = process_stats_[p];
+            os << (p == 0 ? "\n" : ",\n") << indent << "    {\"process\": " << p
+               << ", \"core\": " << p / config_.processes_per_core
+               << ", \"accesses\": " << stats.accesses << ", \"misses\": " << stats.misses
+               << ", \"slices\": " << stats.slices
+               << ", \"refill_windows\": " << stats.refill_windows
+               << ", \"refill_accesses\": " << stats.refill_accesses << ", \"refill_misses\": " << stats.refill_misses
+               << ", \"steady_miss_rate\": " << std::fixed << std::setprecision(4) << stats.steadyMissRate()
+               << ", \"refill_cost\": " << std::setprecision(2) << stats.refillCost()
+               << ", \"flushed_blocks\": " << stats.flushed_blocks
+               << ", \"evicted_others\": " << stats.foreign_evictions
+               << ", \"evicted_by_others\": " << getEvictedByOthers(p) << "}";
+        }
+        os << "\n" << indent << "  ]\n"
+           << indent << "}";
+    }
+
+    void CacheSimulator::printProcessText() const
+    {
+        std::cout << std::endl;
+        std::cout << "--- 多进程调度 ---" << std::endl;
+        std::cout << "每核心进程数: " << config_.processes_per_core << ", 时间片: " << config_.time_slice
+                  << " 次访问, 切换时: " << SimulatorConfig::getSwitchFlushName(config_.switch_flush);
+        if (config_.switch_flush == SwitchFlush::Partial)
+        {
+            std::cout << "（每核心 " << config_.hardware_asids << " 个硬件 ASID）";
+        }
+        std::cout << std::endl;
+        std::cout << "上下文切换: " << context_switches_ << std::endl;
+        std::cout << "重新填充代价: 换入后前 " << config_.refill_window << " 次访问中超出稳态缺失率的缺失数" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (size_t p = 0; p < process_stats_.size(); ++p)
+        {
+            const ProcessStats &stats = process_stats_[p];
+            double miss_rate = stats.accesses > 0 ? static_cast<double>(stats.misses) * 100.0 / stats.accesses : 0.0;
+            double refill_rate = stats.refill_accesses > 0 ? static_cast<double>(stats.refill_misses) * 100.0 / stats.refill_accesses : 0.0;
+            std::cout << "进程 " << p << " (核心 " << p / config_.processes_per_core << "): 访问 " << stats.accesses
+                      << ", 缺失率 " << miss_rate << "%, 换入后 " << refill_rate << "% / 稳态 "
+                      << stats.steadyMissRate() * 100 << "%, 每次切换额外缺失 " << stats.refillCost()
+                      << ", 驱逐其他进程的行 " << stats.foreign_evictions
+                      << ", 被其他进程驱逐 " << getEvictedByOthers(p);
+            if (config_.switch_flush != SwitchFlush::Keep)
+            {
+                std::cout << ", 被刷新 " << stats.flushed_blocks << " 块";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    void CacheSimulator::writePartitionJson(std::ostream &os, const std::string &indent) const
+    {
+        os << "{\n"
+           << indent << "  \"mode\": \"" << (config_.ucp_interval > 0 ? "ucp" : "static") << "\",\n"
+           << indent << "  \"ucp_interval\": " << config_.ucp_interval << ",\n"
+           << indent << "  \"repartitions\": " << repartitions_ << ",\n"
+           << indent << "  \"list\": [";
+        std::vector<PartitionStats> partitions = getPartitionStats();
+        for (size_t i = 0; i < partitions.size(); ++i)
+        {
+            const PartitionStats &partition = partitions[i];
+            os << (i == 0 ? "\n" : ",\n") << indent << "    {\"core\": " << partition.core_id
+               << ", \"clos\": " << partition.clos
+               << ", \"way_mask\": \"0x" << std::hex << partition.way_mask << std::dec << "\""
+               << ", \"ways\": " << __builtin_popcountll(partition.way_mask)
+               << ", \"occupancy\": " << partition.occupancy
+               << ", \"accesses\": " << partition.accesses << ", \"hits\": " << partition.hits
+               << ", \"hit_rate\": " << std::fixed << std::setprecision(2) << partition.hitRate() * 100.0 << "}";
+        }
+        os << "\n" << indent << "  ]\n"
+           << indent << "}";
+    }
+
+    void CacheSimulator::printPartitionText() const
+    {
+        std::cout << std::endl;
+        std::cout << "--- 路划分 ---" << std::endl;
+        if (config_.ucp_interval > 0)
+        {
+            std::cout << "UCP 动态划分: 每 " << config_.ucp_interval << " 次访问重新划分, 共 " << repartitions_ << " 次" << std::endl;
+        }
+        else
+        {
+            std::cout << "静态划分: " << config_.way_masks.size() << " 个 CLOS" << std::endl;
+        }
+        std::cout << std::fixed << std::setprecision(2);
+        size_t num_lines = config_.cache_config.cache_size / config_.cache_config.block_size;
+        for (const PartitionStats &partition : getPartitionStats())
+        {
+            std::cout << "核心 " << partition.core_id << " CLOS " << partition.clos
+                      << ": 掩码 0x" << std::hex << partition.way_mask << std::dec
+                      << " (" << __builtin_popcountll(partition.way_mask) << " 路), 占用 " << partition.occupancy
+                      << " 行 (" << static_cast<double>(partition.occupancy) * 100.0 / num_lines << "%), 命中 "
+                      << partition.hits << " / " << partition.accesses << " (" << partition.hitRate() * 100 << "%)" << std::endl;
+        }
+    }
+
+#ifdef CACHE_SIM_SET_STATS
+    void CacheSimulator::writeSetHeatmap() const
     {
-        // 随机种子用于选择核心
-        static std::mt19937 rng(std::chrono::steady_clock::now().time_since_epoch().count());
-        std::uniform_int_distribution<int> core_dist(0, config_.num_cores - 1);
+        std::ofstream file(config_.set_heatmap_output);
+        if (!file)
+        {
+            std::cerr << "[Warning] 无法打开热力图输出文件 '" << config_.set_heatmap_output << "'" << std::endl;
+            return;
+        }
 
-        for (size_t i = 0; i < config_.num_accesses; ++i)
+        file << "core_id,set,accesses,misses,evictions\n";
+        for (size_t i = 0; i < caches_.size(); ++i)
         {
-            uint64_t address = generateAddress(i);
-            bool is_write = (i % 4 == 0);    // 模拟 25% 的写操作
-            size_t core_id = core_dist(rng); // 随机选择一个核心发起请求
-            performAccess(core_id, address, is_write);
+            cache_sim::writeSetHeatmap(file, static_cast<int>(i), caches_[i]->getSetStats());
         }
     }
+#endif
 
     void CacheSimulator::printResults() const
     {
         if (config_.output_json)
         {
             std::ostringstream oss;
-            oss << "{\n  \"cores\": [\n";
+            oss << "{\n  \"seed\": " << config_.seed << ",\n"
+                << "  \"warmup_accesses\": " << config_.warmup_accesses << ",\n"
+                << "  \"cores\": [\n";
             for (int i = 0; i < config_.num_cores; ++i)
             {
-                const CacheStats &stats = caches_[i]->getStats();
-                double hit_rate = stats.hitRate() * 100.0;
-                double conflict_rate = stats.conflictRate() * 100.0;
                 oss << "    {\n"
-                    << "      \"core_id\": " << i << ",\n"
-                    << "      \"reads\": " << stats.reads << ",\n"
-                    << "      \"writes\": " << stats.writes << ",\n"
-                    << "      \"hits\": " << stats.hits << ",\n"
-                    << "      \"misses\": " << stats.misses << ",\n"
-                    << "      \"hit_rate\": " << std::fixed << std::setprecision(2) << hit_rate << ",\n"
-                    << "      \"conflicts\": " << stats.conflicts << ",\n"
-                    << "      \"conflict_rate\": " << std::fixed << std::setprecision(2) << conflict_rate << "\n"
-                    << "    }" << (i + 1 == config_.num_cores ? "\n" : ",\n");
-            }
-            CacheStats avg_stats = getAverageStats();
-            double avg_hit_rate = avg_stats.hitRate() * 100.0;
-            double avg_conflict_rate = avg_stats.conflictRate() * 100.0;
+                    << "      \"core_id\": " << i << ",\n";
+                if (!config_.core_workloads.empty())
+                {
+                    const CoreWorkload &workload = streams_[i * config_.processes_per_core]->getWorkload();
+                    oss << "      \"workload\": {\"pattern\": \"" << getPatterName(workload.pattern) << "\""
+                        << ", \"address_base\": " << workload.address_base
+                        << ", \"address_range\": " << workload.address_range
+                        << ", \"write_ratio\": " << workload.write_ratio
+                        << ", \"weight\": " << workload.weight
+                        << ", \"sharers\": " << (workload.sharers == 0 ? config_.num_cores : workload.sharers) << "},\n";
+                }
+                writeStatsJson(oss, caches_[i]->getStats(), "      ");
+                if (caches_[i]->isSampling())
+                {
+                    oss << ",\n      \"sampling\": ";
+                    writeSamplingJson(oss, caches_[i]->getSamplingEstimate(), caches_[i]->getStats(), "      ");
+                }
+#ifdef CACHE_SIM_SET_STATS
+                const std::vector<SetStats> &set_stats = caches_[i]->getSetStats();
+                oss << ",\n      \"set_skew\": {\n"
+                    << "        \"num_sets\": " << set_stats.size() << ",\n"
+                    << "        \"accesses\": ";
+                writeSkewJson(oss, computeSkew(set_stats, &SetStats::accesses));
+                oss << ",\n        \"misses\": ";
+                writeSkewJson(oss, computeSkew(set_stats, &SetStats::misses));
+                oss << ",\n        \"evictions\": ";
+                writeSkewJson(oss, computeSkew(set_stats, &SetStats::evictions));
+                oss << "\n      }";
+#endif
+                if (config_.reuse_distance)
+                {
+                    oss << ",\n      \"reuse_distance\": ";
+                    core_profilers_[i]->getHistogram().writeJson(oss, "      ");
+                }
+                oss << "\n    }" << (i + 1 == config_.num_cores ? "\n" : ",\n");
+            }
             oss << "  ],\n"
-                << "  \"average\": {\n"
-                << "    \"reads\": " << avg_stats.reads << ",\n"
-                << "    \"writes\": " << avg_stats.writes << ",\n"
-                << "    \"hits\": " << avg_stats.hits << ",\n"
-                << "    \"misses\": " << avg_stats.misses << ",\n"
-                << "    \"hit_rate\": " << std::fixed << std::setprecision(2) << avg_hit_rate << ",\n"
-                << "    \"conflicts\": " << avg_stats.conflicts << ",\n"
-                << "    \"conflict_rate\": " << std::fixed << std::setprecision(2) << avg_conflict_rate << "\n"
-                << "  }\n"
-                << "}\n";
+                << "  \"average\": {\n";
+            writeStatsJson(oss, getAverageStats(), "    ");
+            oss << "\n  },\n";
+            if (caches_[0]->isSampling())
+            {
+                CacheStats total;
+                for (const auto &cache : caches_)
+                {
+                    total += cache->getStats();
+                }
+                oss << "  \"sampling\": ";
+                writeSamplingJson(oss, getSamplingEstimate(), total, "  ");
+                oss << ",\n";
+            }
+            oss << "  \"bus\": ";
+            writeBusStatsJson(oss, "  ");
+            if (config_.reuse_distance)
+            {
+                oss << ",\n  \"reuse_distance\": ";
+                global_profiler_->getHistogram().writeJson(oss, "  ");
+            }
+            if (sharing_detector_)
+            {
+                oss << ",\n  \"sharing\": ";
+                writeSharingJson(oss, "  ");
+            }
+            if (vm_)
+            {
+                oss << ",\n  \"virtual_memory\": ";
+                writeVirtualMemoryJson(oss, "  ");
+            }
+            if (!process_stats_.empty())
+            {
+                oss << ",\n  \"processes\": ";
+                writeProcessJson(oss, "  ");
+            }
+            if (!clos_masks_.empty())
+            {
+                oss << ",\n  \"partitions\": ";
+                writePartitionJson(oss, "  ");
+            }
+            if (interconnect_)
+            {
+                oss << ",\n  \"numa\": ";
+                writeNumaJson(oss, "  ");
+            }
+            if (memory_)
+            {
+                oss << ",\n  \"dram\": ";
+                writeDramJson(oss, "  ");
+            }
+            if (!compressed_.empty())
+            {
+                oss << ",\n  \"compression\": ";
+                writeCompressionJson(oss, "  ");
+            }
+            oss << "\n}\n";
             std::cout << oss.str();
         }
         else
@@ -100,7 +1484,58 @@ namespace cache_sim
             std::cout << "核心数量: " << config_.num_cores << std::endl;
             std::cout << "替换策略: " << SimulatorConfig::getPolicyName(config_.replacement_policy) << std::endl;
             std::cout << "访问模式: " << getPatterName(config_.access_pattern) << std::endl;
-            std::cout << "访问次数: " << config_.num_accesses << std::endl;
+            std::cout << "访问次数: " << executed_accesses_ << std::endl;
+            if (config_.warmup_accesses > 0)
+            {
+                std::cout << "预热访问: " << config_.warmup_accesses << "（不计入统计）" << std::endl;
+            }
+            if (!config_.checkpoint_input.empty())
+            {
+                std::cout << "初始状态: " << config_.checkpoint_input << std::endl;
+            }
+            for (size_t i = 0; i < config_.trace_files.size() && i < traces_.size(); ++i)
+            {
+                if (traces_[i])
+                {
+                    std::cout << "核心 " << i << " trace: " << config_.trace_files[i] << std::endl;
+                }
+            }
+            std::cout << "随机数种子: " << config_.seed << std::endl;
+            if (isKeyValuePattern(config_.access_pattern))
+            {
+                std::cout << "Zipf theta: " << config_.zipf_theta << std::endl;
+                std::cout << "对象大小: " << std::max(config_.object_size, config_.cache_config.block_size) << " 字节" << std::endl;
+                if (config_.access_pattern == AccessPattern::Hotspot)
+                {
+                    std::cout << "热点: " << config_.hot_fraction * 100 << "% 的键承担 " << config_.hot_access * 100 << "% 的访问" << std::endl;
+                }
+            }
+            if (config_.num_cores > 1)
+            {
+                std::cout << "访问流交织: " << SimulatorConfig::getInterleaveName(config_.interleave) << std::endl;
+            }
+            if (!config_.core_workloads.empty())
+            {
+                for (int i = 0; i < config_.num_cores; ++i)
+                {
+                    const CoreWorkload &workload = streams_[i * config_.processes_per_core]->getWorkload();
+                    std::cout << "  核心 " << i << ": " << getPatterName(workload.pattern)
+                              << ", 地址 [0x" << std::hex << workload.address_base << ", 0x"
+                              << workload.address_base + workload.address_range << std::dec << ")"
+                              << ", 写比例 " << workload.write_ratio
+                              << ", 权重 " << workload.weight;
+                    if (isSharingPattern(workload.pattern))
+                    {
+                        std::cout << ", 共享度 " << (workload.sharers == 0 ? config_.num_cores : workload.sharers);
+                    }
+                    if (isKeyValuePattern(workload.pattern))
+                    {
+                        std::cout << ", theta " << workload.zipf_theta << ", 对象 "
+                                  << std::max(workload.object_size, config_.cache_config.block_size) << " 字节";
+                    }
+                    std::cout << std::endl;
+                }
+            }
             std::cout << std::endl;
 
             const CacheConfig &config = caches_[0]->getConfig();
@@ -108,92 +1543,307 @@ namespace cache_sim
             std::cout << "缓存大小: " << config.cache_size << " 字节 ("
                       << config.cache_size / 1024 << " KB)" << std::endl;
             std::cout << "块大小: " << config.block_size << " 字节" << std::endl;
+            if (caches_[0]->getSectorsPerBlock() > 1)
+            {
+                std::cout << "扇区: 每块 " << caches_[0]->getSectorsPerBlock() << " 个 " << config.sector_size << " 字节扇区" << std::endl;
+            }
             std::cout << "关联度: " << config.associativity << " 路组相联" << std::endl;
+            std::cout << "组索引函数: " << SimulatorConfig::getIndexFunctionName(config.index_function) << std::endl;
+            std::cout << "一致性协议: " << SimulatorConfig::getProtocolName(config.coherence_protocol) << std::endl;
+            std::cout << "写策略: " << (config.write_policy == WritePolicy::WriteBack ? "写回" : "写直达")
+                      << (config.write_allocate ? "，写分配" : "，写不分配") << std::endl;
+            if (caches_[0]->isSampling())
+            {
+                std::cout << "组采样: " << SimulatorConfig::getSamplingName(config.set_sampling)
+                          << "，约每 " << config.sampling_ratio << " 组模拟一组" << std::endl;
+            }
+            if (config.write_buffer_entries > 0)
+            {
+                std::cout << "写缓冲: " << config.write_buffer_entries << " 项" << std::endl;
+            }
+            if (config.victim_cache_entries > 0)
+            {
+                std::cout << (config.victim_cache_mode == VictimCacheMode::Victim ? "受害者缓存: " : "缺失缓存: ")
+                          << config.victim_cache_entries << " 项" << std::endl;
+            }
             std::cout << std::endl;
 
             for (int i = 0; i < config_.num_cores; ++i)
             {
-                const CacheStats &stats = caches_[i]->getStats();
                 std::cout << "--- Core " << i << " 统计 ---" << std::endl;
-                std::cout << "读操作次数: " << stats.reads << std::endl;
-                std::cout << "写操作次数: " << stats.writes << std::endl;
-                std::cout << "缓存命中: " << stats.hits << std::endl;
-                std::cout << "缓存缺失: " << stats.misses << std::endl;
-                std::cout << std::fixed << std::setprecision(2);
-                std::cout << "命中率: " << stats.hitRate() * 100 << "%" << std::endl;
-                std::cout << "冲突次数: " << stats.conflicts << std::endl;
-                std::cout << "冲突率: " << stats.conflictRate() * 100 << "%" << std::endl;
+                printStatsText(caches_[i]->getStats());
+                if (caches_[i]->isSampling())
+                {
+                    printSamplingText(caches_[i]->getSamplingEstimate(), caches_[i]->getStats());
+                }
+#ifdef CACHE_SIM_SET_STATS
+                SkewSummary access_skew = computeSkew(caches_[i]->getSetStats(), &SetStats::accesses);
+                SkewSummary miss_skew = computeSkew(caches_[i]->getSetStats(), &SetStats::misses);
+                std::cout << "组访问偏斜: 最大/平均 = " << std::setprecision(4) << access_skew.max_mean_ratio
+                          << ", 基尼系数 = " << access_skew.gini << std::endl;
+                std::cout << "组缺失偏斜: 最大/平均 = " << miss_skew.max_mean_ratio
+                          << ", 基尼系数 = " << miss_skew.gini << std::endl;
+                std::cout << std::setprecision(2);
+#endif
                 std::cout << std::endl;
             }
 
             std::cout << "--- 平均统计 ---" << std::endl;
-            CacheStats avg_stats = getAverageStats();
-            std::cout << "读操作次数: " << avg_stats.reads << std::endl;
-            std::cout << "写操作次数: " << avg_stats.writes << std::endl;
-            std::cout << "缓存命中: " << avg_stats.hits << std::endl;
-            std::cout << "缓存缺失: " << avg_stats.misses << std::endl;
-            std::cout << std::fixed << std::setprecision(2);
-            std::cout << "命中率: " << avg_stats.hitRate() * 100 << "%" << std::endl;
-            std::cout << "冲突次数: " << avg_stats.conflicts << std::endl;
-            std::cout << "冲突率: " << avg_stats.conflictRate() * 100 << "%" << std::endl;
-            
+            printStatsText(getAverageStats());
+            if (caches_[0]->isSampling())
+            {
+                CacheStats total;
+                for (const auto &cache : caches_)
+                {
+                    total += cache->getStats();
+                }
+                std::cout << std::endl;
+                std::cout << "--- 组采样外推（全部核心） ---" << std::endl;
+                printSamplingText(getSamplingEstimate(), total);
+            }
+
+            BusStats bus = getBusStats();
+            std::cout << std::endl;
+            std::cout << "--- 总线统计 ---" << std::endl;
+            std::cout << "BusRd: " << bus.bus_rd << std::endl;
+            std::cout << "BusRdX: " << bus.bus_rdx << std::endl;
+            std::cout << "BusUpgr: " << bus.bus_upgr << std::endl;
+            std::cout << "刷新写回 (Flush): " << bus.flushes << std::endl;
+            std::cout << "缓存间传输: " << bus.cache_to_cache << std::endl;
+            std::cout << "副本作废: " << bus.invalidations << std::endl;
+            std::cout << "主存读取: " << bus.memory_reads << std::endl;
+            if (config_.reuse_distance)
+            {
+                std::cout << std::endl;
+                std::cout << "--- 复用距离直方图（全局） ---" << std::endl;
+                const ReuseHistogram &hist = global_profiler_->getHistogram();
+                for (size_t b = 0; b < hist.bins.size(); ++b)
+                {
+                    std::cout << "[" << ReuseHistogram::binLowerBound(b) << ", "
+                              << ReuseHistogram::binUpperBound(b) << "]: " << hist.bins[b] << std::endl;
+                }
+                std::cout << "首次访问: " << hist.cold << std::endl;
+            }
+            if (sharing_detector_)
+            {
+                printSharingText();
+            }
+            if (vm_)
+            {
+                printVirtualMemoryText();
+            }
+            if (!process_stats_.empty())
+            {
+                printProcessText();
+            }
+            if (!clos_masks_.empty())
+            {
+                printPartitionText();
+            }
+            if (interconnect_)
+            {
+                printNumaText();
+            }
+            if (memory_)
+            {
+                printDramText();
+            }
+            if (!compressed_.empty())
+            {
+                printCompressionText();
+            }
+
             std::cout << "==================================" << std::endl;
         }
     }
 
-    uint64_t CacheSimulator::generateAddress(size_t index) const
+    void CacheSimulator::writeStatsJson(std::ostream &os, const CacheStats &stats, const std::string &indent) const
     {
-        // 随机种子
-        static std::mt19937_64 rng(std::chrono::steady_clock::now().time_since_epoch().count());
+        os << indent << "\"reads\": " << stats.reads << ",\n"
+           << indent << "\"writes\": " << stats.writes << ",\n"
+           << indent << "\"hits\": " << stats.hits << ",\n"
+           << indent << "\"misses\": " << stats.misses << ",\n"
+           << indent << "\"hit_rate\": " << std::fixed << std::setprecision(2) << stats.hitRate() * 100.0 << ",\n"
+           << indent << "\"conflicts\": " << stats.conflicts << ",\n"
+           << indent << "\"conflict_rate\": " << std::fixed << std::setprecision(2) << stats.conflictRate() * 100.0 << ",\n"
+           << indent << "\"evictions\": " << stats.evictions << ",\n"
+           << indent << "\"writebacks\": " << stats.writebacks << ",\n"
+           << indent << "\"bus_transactions\": " << stats.bus_transactions << ",\n"
+           << indent << "\"dirty_evictions\": " << stats.dirty_evictions << ",\n"
+           << indent << "\"memory_writes\": " << stats.memory_writes << ",\n"
+           << indent << "\"memory_write_bytes\": " << stats.memory_write_bytes << ",\n"
+           << indent << "\"bytes_fetched\": " << stats.bytes_fetched;
 
-        switch (config_.access_pattern)
+        if (caches_[0]->getSectorsPerBlock() > 1)
         {
-        case AccessPattern::Random:
+            os << ",\n"
+               << indent << "\"sector_misses\": " << stats.sector_misses << ",\n"
+               << indent << "\"sector_miss_rate\": " << std::fixed << std::setprecision(2) << stats.sectorMissRate() * 100.0 << ",\n"
+               << indent << "\"tag_miss_rate\": " << stats.tagMissRate() * 100.0;
+        }
+
+        if (config_.cache_config.write_buffer_entries > 0)
         {
-            std::uniform_int_distribution<uint64_t> dist(0, config_.address_range - 1);
-            return dist(rng);
+            os << ",\n"
+               << indent << "\"write_buffer_coalesced\": " << stats.write_buffer_coalesced;
         }
-        case AccessPattern::Sequential:
+
+        if (config_.cache_config.victim_cache_entries > 0)
         {
-            return (index * caches_[0]->getConfig().block_size) % config_.address_range;
+            os << ",\n"
+               << indent << "\"victim_hits\": " << stats.victim_hits << ",\n"
+               << indent << "\"victim_swaps\": " << stats.victim_swaps << ",\n"
+               << indent << "\"victim_absorbed_conflicts\": " << stats.victim_absorbed_conflicts;
         }
-        case AccessPattern::Localized:
+    }
+
+    void CacheSimulator::writeSamplingJson(std::ostream &os, const SamplingEstimate &estimate, const CacheStats &stats, const std::string &indent) const
+    {
+        double scale = stats.samplingScale();
+        os << "{\n"
+           << indent << "  \"sampled_sets\": " << estimate.sampled_sets << ",\n"
+           << indent << "  \"total_sets\": " << estimate.total_sets << ",\n"
+           << indent << "  \"sampled_accesses\": " << estimate.sampled_accesses << ",\n"
+           << indent << "  \"total_accesses\": " << estimate.total_accesses << ",\n"
+           << indent << "  \"hit_rate\": " << std::fixed << std::setprecision(2) << (1.0 - estimate.miss_rate) * 100.0 << ",\n"
+           << indent << "  \"hit_rate_ci95\": " << estimate.miss_rate_ci * 100.0 << ",\n"
+           << indent << "  \"estimated_misses\": " << std::setprecision(0) << stats.misses * scale << ",\n"
+           << indent << "  \"estimated_evictions\": " << stats.evictions * scale << ",\n"
+           << indent << "  \"estimated_writebacks\": " << stats.writebacks * scale << ",\n"
+           << indent << "  \"estimated_bus_transactions\": " << stats.bus_transactions * scale << "\n"
+           << indent << "}" << std::setprecision(2);
+    }
+
+    void CacheSimulator::printSamplingText(const SamplingEstimate &estimate, const CacheStats &stats) const
+    {
+        double scale = stats.samplingScale();
+        std::cout << "采样组: " << estimate.sampled_sets << " / " << estimate.total_sets
+                  << ", 采样访问: " << estimate.sampled_accesses << " / " << estimate.total_accesses << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "估计命中率: " << (1.0 - estimate.miss_rate) * 100 << "% ± "
+                  << estimate.miss_rate_ci * 100 << "% (95% 置信区间)" << std::endl;
+        std::cout << std::setprecision(0);
+        std::cout << "估计缺失: " << stats.misses * scale << std::endl;
+        std::cout << "估计驱逐: " << stats.evictions * scale << std::endl;
+        std::cout << "估计写回: " << stats.writebacks * scale << std::endl;
+        std::cout << "估计总线事务: " << stats.bus_transactions * scale << std::endl;
+        std::cout << std::setprecision(2);
+    }
+
+    void CacheSimulator::printStatsText(const CacheStats &stats) const
+    {
+        std::cout << "读操作次数: " << stats.reads << std::endl;
+        std::cout << "写操作次数: " << stats.writes << std::endl;
+        std::cout << "缓存命中: " << stats.hits << std::endl;
+        std::cout << "缓存缺失: " << stats.misses << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "命中率: " << stats.hitRate() * 100 << "%" << std::endl;
+        std::cout << "冲突次数: " << stats.conflicts << std::endl;
+        std::cout << "冲突率: " << stats.conflictRate() * 100 << "%" << std::endl;
+        std::cout << "驱逐次数: " << stats.evictions << std::endl;
+        std::cout << "写回次数: " << stats.writebacks << std::endl;
+        std::cout << "总线事务: " << stats.bus_transactions << std::endl;
+        std::cout << "脏行驱逐: " << stats.dirty_evictions << std::endl;
+        std::cout << "主存写事务: " << stats.memory_writes << std::endl;
+        std::cout << "主存写字节: " << stats.memory_write_bytes << std::endl;
+        std::cout << "缺失读取字节: " << stats.bytes_fetched << std::endl;
+        if (caches_[0]->getSectorsPerBlock() > 1)
         {
-            // 模拟局部性：90% 的访问在小范围内，10% 随机访问
-            std::uniform_real_distribution<double> prob_dist(0.0, 1.0);
-            if (prob_dist(rng) < 0.9)
-            {
-                // 局部访问：在当前工作集附近
-                size_t working_set_size = config_.working_set_size;
-                size_t base = (index / config_.working_set_period) * working_set_size;
-                std::uniform_int_distribution<uint64_t> local_dist(0, working_set_size - 1);
-                return (base + local_dist(rng)) % config_.address_range;
-            }
-            else
-            {
-                // 随机访问
-                std::uniform_int_distribution<uint64_t> dist(0, config_.address_range - 1);
-                return dist(rng);
-            }
+            std::cout << "扇区缺失: " << stats.sector_misses << " (扇区缺失率 " << stats.sectorMissRate() * 100
+                      << "%, 标签缺失率 " << stats.tagMissRate() * 100 << "%)" << std::endl;
         }
-        default:
-            return 0;
+        if (config_.cache_config.write_buffer_entries > 0)
+        {
+            std::cout << "写缓冲合并: " << stats.write_buffer_coalesced << std::endl;
+        }
+
+        if (config_.cache_config.victim_cache_entries > 0)
+        {
+            std::cout << "受害者缓存命中: " << stats.victim_hits << std::endl;
+            std::cout << "受害者缓存交换: " << stats.victim_swaps << std::endl;
+            std::cout << "吸收的冲突缺失: " << stats.victim_absorbed_conflicts << std::endl;
         }
     }
 
-    void CacheSimulator::performAccess(size_t core_id, uint64_t address, bool is_write)
+    bool CacheSimulator::access(size_t core_id, uint64_t address, bool is_write)
     {
         if (core_id >= caches_.size())
-            return;
+            return false;
+        ++executed_accesses_;
+        return performAccess(core_id, address, is_write);
+    }
+
+    bool CacheSimulator::performAccess(size_t core_id, uint64_t address, bool is_write)
+    {
+        if (core_id >= caches_.size())
+            return false;
 
-        if (is_write)
+        // 各核心并行执行，每个核心每 access_interval 个 DRAM 周期发出一次访问
+        if (memory_)
         {
-            caches_[core_id]->write(address, 0);
+            uint64_t interval = config_.dram_config.access_interval;
+            uint64_t before = memory_accesses_ * interval / caches_.size();
+            ++memory_accesses_;
+            memory_->advance(memory_accesses_ * interval / caches_.size() - before);
         }
-        else
+
+        // 虚拟地址经 TLB / 页表转换为物理地址，之后的分析与缓存均使用物理地址
+        if (vm_)
+        {
+            address = vm_->translate(core_id, address, is_write);
+        }
+
+        if (config_.reuse_distance)
+        {
+            core_profilers_[core_id]->access(address);
+            global_profiler_->access(address);
+        }
+
+        if (sharing_detector_)
+        {
+            sharing_detector_->access(core_id, address, 1, is_write);
+        }
+
+        // 压缩缓存：写入值先写入内存映像，再以块的新内容重新压缩
+        uint8_t value = 0;
+        if (!compressed_.empty())
+        {
+            if (is_write)
+            {
+                uint64_t data = memory_image_->nextValue(address);
+                memory_image_->write(address, data);
+                value = static_cast<uint8_t>(data);
+            }
+            compressed_[core_id]->access(address, is_write);
+        }
+
+        Cache &cache = *caches_[core_id];
+        uint64_t foreign_evictions = cache.getStats().foreign_evictions;
+        bool hit = is_write ? cache.write(address, value) : cache.read(address);
+
+        if (!process_stats_.empty())
         {
-            caches_[core_id]->read(address);
+            ProcessStats &stats = process_stats_[core_id * config_.processes_per_core + running_[core_id]];
+            stats.accesses++;
+            stats.misses += hit ? 0 : 1;
+            stats.foreign_evictions += cache.getStats().foreign_evictions - foreign_evictions;
+            if (refilling_[core_id])
+            {
+                stats.refill_accesses++;
+                stats.refill_misses += hit ? 0 : 1;
+                refilling_[core_id] = ++since_switch_[core_id] < config_.refill_window;
+            }
+
+            if (!monitors_.empty())
+            {
+                monitors_[core_id][running_[core_id]]->access(cache.getSetIndex(address), address);
+                if (++since_repartition_[core_id] >= config_.ucp_interval)
+                {
+                    repartition(core_id);
+                }
+            }
         }
+        return hit;
     }
 
     std::string CacheSimulator::getPatterName(AccessPattern pattern)
@@ -206,35 +1856,77 @@ namespace cache_sim
             return "顺序访问";
         case AccessPattern::Localized:
             return "局部性访问";
+        case AccessPattern::ProducerConsumer:
+            return "生产者/消费者";
+        case AccessPattern::Migratory:
+            return "迁移对象";
+        case AccessPattern::ReadMostly:
+            return "读多写少共享表";
+        case AccessPattern::LockContention:
+            return "自旋锁竞争";
+        case AccessPattern::Zipfian:
+            return "Zipf 分布";
+        case AccessPattern::ScrambledZipfian:
+            return "打乱的 Zipf 分布";
+        case AccessPattern::Hotspot:
+            return "热点分布";
+        case AccessPattern::Latest:
+            return "最近写入优先";
         default:
             return "未知模式";
         }
     }
 
+    SamplingEstimate CacheSimulator::getSamplingEstimate() const
+    {
+        // 各核心的采样组相同，同一组的计数相加后作为一个整群
+        std::vector<SetStats> merged(caches_[0]->getSampledSetStats().size());
+        uint64_t total_accesses = 0;
+        for (const auto &cache : caches_)
+        {
+            const std::vector<SetStats> &sampled = cache->getSampledSetStats();
+            for (size_t i = 0; i < merged.size(); ++i)
+            {
+                merged[i].accesses += sampled[i].accesses;
+                merged[i].misses += sampled[i].misses;
+                merged[i].evictions += sampled[i].evictions;
+            }
+            const CacheStats &stats = cache->getStats();
+            total_accesses += stats.reads + stats.writes + stats.unsampled;
+        }
+        return estimateFromSample(merged, caches_[0]->getNumIndexedSets(), total_accesses);
+    }
+
     CacheStats CacheSimulator::getAverageStats() const
     {
         CacheStats avg_stats;
         for (const auto &cache : caches_)
         {
-            const CacheStats &stats = cache->getStats();
-            avg_stats.hits += stats.hits;
-            avg_stats.misses += stats.misses;
-            avg_stats.reads += stats.reads;
-            avg_stats.writes += stats.writes;
-            avg_stats.conflicts += stats.conflicts;
+            avg_stats += cache->getStats();
         }
         size_t num_caches = caches_.size();
         if (num_caches > 0)
         {
-            avg_stats.hits /= num_caches;
-            avg_stats.misses /= num_caches;
-            avg_stats.reads /= num_caches;
-            avg_stats.writes /= num_caches;
-            avg_stats.conflicts /= num_caches;
+            avg_stats /= num_caches;
         }
         return avg_stats;
     }
 
+    std::string SimulatorConfig::getSamplingName(SetSampling sampling)
+    {
+        switch (sampling)
+        {
+        case SetSampling::None:
+            return "不采样";
+        case SetSampling::Stride:
+            return "等间隔";
+        case SetSampling::Hashed:
+            return "散列";
+        default:
+            return "未知采样方式";
+        }
+    }
+
     std::string SimulatorConfig::getPolicyName(ReplacementPolicy policy)
     {
         switch (policy)
@@ -248,4 +1940,87 @@ namespace cache_sim
         }
     }
 
+    std::string SimulatorConfig::getIndexFunctionName(IndexFunction index_function)
+    {
+        switch (index_function)
+        {
+        case IndexFunction::Modulo:
+            return "取模";
+        case IndexFunction::XorFold:
+            return "异或折叠";
+        case IndexFunction::PrimeModulo:
+            return "素数取模";
+        case IndexFunction::Skewed:
+            return "斜相联";
+        default:
+            return "未知索引函数";
+        }
+    }
+
+    std::string SimulatorConfig::getProtocolName(CoherenceProtocol protocol)
+    {
+        switch (protocol)
+        {
+        case CoherenceProtocol::MESI:
+            return "MESI";
+        case CoherenceProtocol::MOESI:
+            return "MOESI";
+        case CoherenceProtocol::MESIF:
+            return "MESIF";
+        default:
+            return "未知协议";
+        }
+    }
+
+    std::string SimulatorConfig::getSwitchFlushName(SwitchFlush flush)
+    {
+        switch (flush)
+        {
+        case SwitchFlush::Keep:
+            return "保留";
+        case SwitchFlush::Partial:
+            return "回收 ASID 时刷新";
+        case SwitchFlush::Full:
+            return "全部刷新";
+        default:
+            return "未知处理方式";
+        }
+    }
+
+    std::string SimulatorConfig::getInterleaveName(StreamInterleave interleave)
+    {
+        switch (interleave)
+        {
+        case StreamInterleave::RoundRobin:
+            return "轮转";
+        case StreamInterleave::Weighted:
+            return "加权";
+        default:
+            return "未知交织方式";
+        }
+    }
+
+    CoreWorkload SimulatorConfig::defaultWorkload() const
+    {
+        CoreWorkload workload;
+        workload.pattern = access_pattern;
+        workload.address_base = 0;
+        workload.address_range = address_range;
+        workload.working_set_period = working_set_period;
+        workload.working_set_size = working_set_size;
+        workload.write_ratio = write_ratio;
+        workload.weight = 1;
+        workload.sharers = sharers;
+        workload.zipf_theta = zipf_theta;
+        workload.object_size = object_size;
+        workload.hot_fraction = hot_fraction;
+        workload.hot_access = hot_access;
+        return workload;
+    }
+
+    CoreWorkload SimulatorConfig::workloadFor(size_t core_id) const
+    {
+        return core_id < core_workloads.size() ? core_workloads[core_id] : defaultWorkload();
+    }
+
 } // namespace cache_sim
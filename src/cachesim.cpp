@@ -0,0 +1,318 @@
+#include "cachesim.h"
+#include "cache_simulator.h"
+#include "lru_cache.h"
+#include "lfu_cache.h"
+#include <bits/stdc++.h>
+
+using namespace cache_sim;
+
+// C 接口的枚举值与内部枚举一一对应
+static_assert(CACHESIM_POLICY_LFU == static_cast<int>(ReplacementPolicy::LFU), "替换策略编号不一致");
+static_assert(CACHESIM_INDEX_SKEWED == static_cast<int>(IndexFunction::Skewed), "组索引函数编号不一致");
+static_assert(CACHESIM_PROTOCOL_MESIF == static_cast<int>(CoherenceProtocol::MESIF), "一致性协议编号不一致");
+static_assert(CACHESIM_PATTERN_LATEST == static_cast<int>(AccessPattern::Latest), "访问模式编号不一致");
+
+struct cachesim_cache
+{
+    std::unique_ptr<Cache> cache;
+};
+
+struct cachesim_simulator
+{
+    std::unique_ptr<CacheSimulator> simulator;
+};
+
+namespace
+{
+    thread_local std::string last_error;
+
+    void setError(const std::string &message)
+    {
+        last_error = message;
+    }
+
+    // 检查缓存几何与策略参数并转换为 CacheConfig，无效时记录错误并返回 false
+    bool toCacheConfig(const cachesim_config *config, CacheConfig &out)
+    {
+        if (config == nullptr)
+        {
+            setError("配置为空");
+            return false;
+        }
+        uint64_t block_size = config->block_size;
+        if (block_size == 0 || (block_size & (block_size - 1)) != 0 || config->associativity == 0 ||
+            config->cache_size < block_size * config->associativity ||
+            config->cache_size % (block_size * config->associativity) != 0)
+        {
+            setError("块大小必须是 2 的幂，缓存大小必须是 块大小 * 关联度 的正整数倍");
+            return false;
+        }
+        uint64_t sector_size = config->sector_size;
+        if (sector_size > 0 && ((sector_size & (sector_size - 1)) != 0 || sector_size > block_size || block_size / sector_size > 64))
+        {
+            setError("扇区大小必须是 2 的幂，扇区不大于块且每块最多 64 个扇区");
+            return false;
+        }
+        if (config->policy > CACHESIM_POLICY_LFU || config->index_function > CACHESIM_INDEX_SKEWED ||
+            config->protocol > CACHESIM_PROTOCOL_MESIF)
+        {
+            setError("未知的替换策略、组索引函数或一致性协议");
+            return false;
+        }
+
+        out = CacheConfig(config->cache_size, block_size, config->associativity,
+                          static_cast<IndexFunction>(config->index_function));
+        out.sector_size = sector_size;
+        out.coherence_protocol = static_cast<CoherenceProtocol>(config->protocol);
+        out.write_policy = config->write_through ? WritePolicy::WriteThrough : WritePolicy::WriteBack;
+        out.write_allocate = config->write_allocate != 0;
+        return true;
+    }
+
+    void copyStats(const CacheStats &stats, cachesim_stats *out)
+    {
+        out->reads = stats.reads;
+        out->writes = stats.writes;
+        out->hits = stats.hits;
+        out->misses = stats.misses;
+        out->conflicts = stats.conflicts;
+        out->evictions = stats.evictions;
+        out->writebacks = stats.writebacks;
+        out->dirty_evictions = stats.dirty_evictions;
+        out->bus_transactions = stats.bus_transactions;
+        out->memory_writes = stats.memory_writes;
+        out->memory_write_bytes = stats.memory_write_bytes;
+        out->bytes_fetched = stats.bytes_fetched;
+        out->sector_misses = stats.sector_misses;
+    }
+
+    // 执行 body，异常不越过 C 接口，出错时记录错误并返回 fallback
+    template <typename T, typename F>
+    T guarded(T fallback, F body)
+    {
+        try
+        {
+            return body();
+        }
+        catch (const std::exception &e)
+        {
+            setError(e.what());
+        }
+        catch (...)
+        {
+            setError("未知异常");
+        }
+        return fallback;
+    }
+} // namespace
+
+extern "C"
+{
+    int cachesim_abi_version(void)
+    {
+        return CACHESIM_ABI_VERSION;
+    }
+
+    const char *cachesim_last_error(void)
+    {
+        return last_error.c_str();
+    }
+
+    void cachesim_config_init(cachesim_config *config)
+    {
+        if (config == nullptr)
+        {
+            return;
+        }
+        SimulatorConfig defaults;
+        std::memset(config, 0, sizeof(*config));
+        config->cache_size = defaults.cache_config.cache_size;
+        config->block_size = defaults.cache_config.block_size;
+        config->associativity = defaults.cache_config.associativity;
+        config->sector_size = 0;
+        config->policy = CACHESIM_POLICY_LRU;
+        config->index_function = CACHESIM_INDEX_MODULO;
+        config->protocol = CACHESIM_PROTOCOL_MESI;
+        config->write_through = 0;
+        config->write_allocate = 1;
+        config->num_cores = 1;
+        config->pattern = CACHESIM_PATTERN_RANDOM;
+        config->num_accesses = defaults.num_accesses;
+        config->address_range = defaults.address_range;
+        config->write_ratio = defaults.write_ratio;
+        config->seed = defaults.seed;
+    }
+
+    cachesim_cache *cachesim_cache_create(const cachesim_config *config)
+    {
+        return guarded<cachesim_cache *>(nullptr, [&]() -> cachesim_cache *
+                                         {
+            CacheConfig cache_config;
+            if (!toCacheConfig(config, cache_config))
+            {
+                return nullptr;
+            }
+            std::unique_ptr<cachesim_cache> handle(new cachesim_cache);
+            if (config->policy == CACHESIM_POLICY_LFU)
+            {
+                handle->cache = std::make_unique<LFUCache>(cache_config);
+            }
+            else
+            {
+                handle->cache = std::make_unique<LRUCache>(cache_config);
+            }
+            return handle.release(); });
+    }
+
+    void cachesim_cache_destroy(cachesim_cache *cache)
+    {
+        delete cache;
+    }
+
+    int cachesim_cache_access(cachesim_cache *cache, uint64_t address, int is_write)
+    {
+        Cache &target = *cache->cache;
+        return (is_write ? target.write(address, 0) : target.read(address)) ? 1 : 0;
+    }
+
+    size_t cachesim_cache_access_batch(cachesim_cache *cache, const uint64_t *addresses, const uint8_t *is_write,
+                                       size_t count, uint8_t *hits)
+    {
+        Cache &target = *cache->cache;
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            bool hit = is_write != nullptr && is_write[i] ? target.write(addresses[i], 0) : target.read(addresses[i]);
+            total += hit ? 1 : 0;
+            if (hits != nullptr)
+            {
+                hits[i] = hit ? 1 : 0;
+            }
+        }
+        return total;
+    }
+
+    void cachesim_cache_get_stats(const cachesim_cache *cache, cachesim_stats *stats)
+    {
+        copyStats(cache->cache->getStats(), stats);
+    }
+
+    void cachesim_cache_reset_stats(cachesim_cache *cache)
+    {
+        cache->cache->resetStats();
+    }
+
+    cachesim_simulator *cachesim_simulator_create(const cachesim_config *config)
+    {
+        return guarded<cachesim_simulator *>(nullptr, [&]() -> cachesim_simulator *
+                                             {
+            CacheConfig cache_config;
+            if (!toCacheConfig(config, cache_config))
+            {
+                return nullptr;
+            }
+            if (config->num_cores == 0 || config->num_cores > 1024 || config->pattern > CACHESIM_PATTERN_LATEST ||
+                config->address_range == 0 || !(config->write_ratio >= 0.0 && config->write_ratio <= 1.0))
+            {
+                setError("核心数必须在 1 到 1024 之间，地址范围必须大于 0，写比例必须在 [0, 1] 之间");
+                return nullptr;
+            }
+
+            SimulatorConfig sim_config(config->num_accesses, config->address_range,
+                                       static_cast<AccessPattern>(config->pattern),
+                                       static_cast<ReplacementPolicy>(config->policy),
+                                       static_cast<int>(config->num_cores));
+            sim_config.cache_config = cache_config;
+            sim_config.write_ratio = config->write_ratio;
+            sim_config.seed = config->seed;
+
+            std::unique_ptr<cachesim_simulator> handle(new cachesim_simulator);
+            handle->simulator = std::make_unique<CacheSimulator>(sim_config);
+            return handle.release(); });
+    }
+
+    void cachesim_simulator_destroy(cachesim_simulator *simulator)
+    {
+        delete simulator;
+    }
+
+    void cachesim_simulator_run(cachesim_simulator *simulator)
+    {
+        guarded<int>(0, [&]()
+                     {
+            simulator->simulator->run();
+            return 0; });
+    }
+
+    int64_t cachesim_simulator_access_batch(cachesim_simulator *simulator, const uint64_t *addresses,
+                                            const uint32_t *cores, const uint8_t *is_write, size_t count)
+    {
+        CacheSimulator &target = *simulator->simulator;
+        size_t num_cores = target.getNumCores();
+        if (cores != nullptr)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (cores[i] >= num_cores)
+                {
+                    setError("核心编号超出核心数量");
+                    return -1;
+                }
+            }
+        }
+
+        int64_t hits = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t core = cores != nullptr ? cores[i] : 0;
+            bool write = is_write != nullptr && is_write[i] != 0;
+            hits += target.access(core, addresses[i], write) ? 1 : 0;
+        }
+        return hits;
+    }
+
+    void cachesim_simulator_finish(cachesim_simulator *simulator)
+    {
+        simulator->simulator->finish();
+    }
+
+    void cachesim_simulator_reset_stats(cachesim_simulator *simulator)
+    {
+        simulator->simulator->clearStats();
+    }
+
+    int cachesim_simulator_get_core_stats(const cachesim_simulator *simulator, uint32_t core, cachesim_stats *stats)
+    {
+        const CacheSimulator &target = *simulator->simulator;
+        if (core >= target.getNumCores())
+        {
+            setError("核心编号超出核心数量");
+            return -1;
+        }
+        copyStats(target.getCoreStats(core), stats);
+        return 0;
+    }
+
+    void cachesim_simulator_get_total_stats(const cachesim_simulator *simulator, cachesim_stats *stats)
+    {
+        const CacheSimulator &target = *simulator->simulator;
+        CacheStats total;
+        for (size_t core = 0; core < target.getNumCores(); ++core)
+        {
+            total += target.getCoreStats(core);
+        }
+        copyStats(total, stats);
+    }
+
+    void cachesim_simulator_get_bus_stats(const cachesim_simulator *simulator, cachesim_bus_stats *stats)
+    {
+        BusStats bus = simulator->simulator->getBusStats();
+        stats->bus_rd = bus.bus_rd;
+        stats->bus_rdx = bus.bus_rdx;
+        stats->bus_upgr = bus.bus_upgr;
+        stats->flushes = bus.flushes;
+        stats->cache_to_cache = bus.cache_to_cache;
+        stats->invalidations = bus.invalidations;
+        stats->memory_reads = bus.memory_reads;
+    }
+}
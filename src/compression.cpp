@@ -0,0 +1,598 @@
+#include "compression.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace cache_sim
+{
+    namespace
+    {
+        // SplitMix64 终结函数，用于由块地址与种子生成确定的内容
+        uint64_t mix64(uint64_t x)
+        {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        // 一种 BDI 基址 + 差值编码
+        struct BdiCandidate
+        {
+            BdiEncoding encoding;
+            size_t base_size;  // 元素（基址）字节数
+            size_t delta_size; // 差值字节数
+        };
+
+        const BdiCandidate kCandidates[] = {
+            {BdiEncoding::Base8Delta1, 8, 1},
+            {BdiEncoding::Base4Delta1, 4, 1},
+            {BdiEncoding::Base8Delta2, 8, 2},
+            {BdiEncoding::Base2Delta1, 2, 1},
+            {BdiEncoding::Base4Delta2, 4, 2},
+            {BdiEncoding::Base8Delta4, 8, 4},
+        };
+
+        template <typename T>
+        T loadElement(const uint8_t *p)
+        {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            return value;
+        }
+
+        // value 按 T 的补码是否能用 bits 位的有符号数表示
+        template <typename T>
+        bool fitsSigned(T value, unsigned bits)
+        {
+            return static_cast<T>(value + (T(1) << (bits - 1))) >> bits == 0;
+        }
+
+        template <typename T>
+        uint64_t findBaseOf(const uint8_t *block, size_t block_size, unsigned bits)
+        {
+            for (size_t i = 0; i < block_size; i += sizeof(T))
+            {
+                T value = loadElement<T>(block + i);
+                if (!fitsSigned(value, bits))
+                {
+                    return value;
+                }
+            }
+            return 0;
+        }
+
+        template <typename T>
+        bool fitsScalarOf(const uint8_t *block, size_t block_size, unsigned bits, T base)
+        {
+            bool fits = true;
+            for (size_t i = 0; i < block_size; i += sizeof(T))
+            {
+                T value = loadElement<T>(block + i);
+                fits &= fitsSigned(value, bits) || fitsSigned(static_cast<T>(value - base), bits);
+            }
+            return fits;
+        }
+
+        // 基址：第一个不能直接用差值表示（即不能以零为基址）的元素，全部可以时为 0
+        uint64_t findBase(const uint8_t *block, size_t block_size, const BdiCandidate &candidate)
+        {
+            unsigned bits = static_cast<unsigned>(candidate.delta_size * 8);
+            switch (candidate.base_size)
+            {
+            case 8:
+                return findBaseOf<uint64_t>(block, block_size, bits);
+            case 4:
+                return findBaseOf<uint32_t>(block, block_size, bits);
+            default:
+                return findBaseOf<uint16_t>(block, block_size, bits);
+            }
+        }
+
+        // 每个元素相对零或 base 的差值都能用 delta_size 字节表示
+        bool fitsScalar(const uint8_t *block, size_t block_size, const BdiCandidate &candidate, uint64_t base)
+        {
+            unsigned bits = static_cast<unsigned>(candidate.delta_size * 8);
+            switch (candidate.base_size)
+            {
+            case 8:
+                return fitsScalarOf<uint64_t>(block, block_size, bits, base);
+            case 4:
+                return fitsScalarOf<uint32_t>(block, block_size, bits, static_cast<uint32_t>(base));
+            default:
+                return fitsScalarOf<uint16_t>(block, block_size, bits, static_cast<uint16_t>(base));
+            }
+        }
+
+#ifdef __SSE2__
+        // 各 64 位通道右移 count 后是否为零（SSE2 没有 64 位比较，比较两个 32 位半字）
+        inline __m128i zeroAfterShift64(__m128i value, __m128i count)
+        {
+            __m128i zero = _mm_cmpeq_epi32(_mm_srl_epi64(value, count), _mm_setzero_si128());
+            return _mm_and_si128(zero, _mm_shuffle_epi32(zero, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+
+        // fitsScalar 的 SSE2 实现：每次检查 16 字节，加偏置后右移差值位数为零即可表示
+        bool fitsSse2(const uint8_t *block, size_t block_size, const BdiCandidate &candidate, uint64_t base)
+        {
+            int bits = static_cast<int>(candidate.delta_size * 8);
+            __m128i count = _mm_cvtsi32_si128(bits);
+            __m128i fits = _mm_set1_epi32(-1);
+            switch (candidate.base_size)
+            {
+            case 8:
+            {
+                __m128i bias = _mm_set1_epi64x(static_cast<long long>(uint64_t(1) << (bits - 1)));
+                __m128i base_vec = _mm_set1_epi64x(static_cast<long long>(base));
+                for (size_t i = 0; i < block_size; i += 16)
+                {
+                    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+                    __m128i immediate = zeroAfterShift64(_mm_add_epi64(value, bias), count);
+                    __m128i delta = zeroAfterShift64(_mm_add_epi64(_mm_sub_epi64(value, base_vec), bias), count);
+                    fits = _mm_and_si128(fits, _mm_or_si128(immediate, delta));
+                }
+                break;
+            }
+            case 4:
+            {
+                __m128i bias = _mm_set1_epi32(static_cast<int>(uint32_t(1) << (bits - 1)));
+                __m128i base_vec = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(base)));
+                for (size_t i = 0; i < block_size; i += 16)
+                {
+                    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+                    __m128i immediate = _mm_cmpeq_epi32(_mm_srl_epi32(_mm_add_epi32(value, bias), count), _mm_setzero_si128());
+                    __m128i delta = _mm_cmpeq_epi32(_mm_srl_epi32(_mm_add_epi32(_mm_sub_epi32(value, base_vec), bias), count),
+                                                    _mm_setzero_si128());
+                    fits = _mm_and_si128(fits, _mm_or_si128(immediate, delta));
+                }
+                break;
+            }
+            default:
+            {
+                __m128i bias = _mm_set1_epi16(static_cast<short>(1 << (bits - 1)));
+                __m128i base_vec = _mm_set1_epi16(static_cast<short>(static_cast<uint16_t>(base)));
+                for (size_t i = 0; i < block_size; i += 16)
+                {
+                    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+                    __m128i immediate = _mm_cmpeq_epi16(_mm_srl_epi16(_mm_add_epi16(value, bias), count), _mm_setzero_si128());
+                    __m128i delta = _mm_cmpeq_epi16(_mm_srl_epi16(_mm_add_epi16(_mm_sub_epi16(value, base_vec), bias), count),
+                                                    _mm_setzero_si128());
+                    fits = _mm_and_si128(fits, _mm_or_si128(immediate, delta));
+                }
+                break;
+            }
+            }
+            return _mm_movemask_epi8(fits) == 0xFFFF;
+        }
+#endif
+
+        // 全零与重复值检查，满足时写入 result 并返回 true
+        bool compressUniform(const uint8_t *block, size_t block_size, CompressedSize &result)
+        {
+            uint64_t first = loadElement<uint64_t>(block);
+            uint64_t any = 0;
+            uint64_t differs = 0;
+            for (size_t i = 0; i < block_size; i += 8)
+            {
+                uint64_t value = loadElement<uint64_t>(block + i);
+                any |= value;
+                differs |= value ^ first;
+            }
+            if (any == 0)
+            {
+                result = {1, BdiEncoding::Zeros};
+                return true;
+            }
+            if (differs == 0)
+            {
+                result = {8, BdiEncoding::Repeated};
+                return true;
+            }
+            return false;
+        }
+
+        // 编码后的大小：一个基址加每个元素一个差值
+        size_t candidateSize(const BdiCandidate &candidate, size_t block_size)
+        {
+            return candidate.base_size + block_size / candidate.base_size * candidate.delta_size;
+        }
+
+        template <typename Fits>
+        CompressedSize bdiCompressWith(const uint8_t *block, size_t block_size, Fits fits)
+        {
+            CompressedSize result = {block_size, BdiEncoding::Uncompressed};
+            if (compressUniform(block, block_size, result))
+            {
+                return result;
+            }
+            for (const BdiCandidate &candidate : kCandidates)
+            {
+                size_t size = candidateSize(candidate, block_size);
+                if (size >= result.bytes)
+                {
+                    continue;
+                }
+                uint64_t base = findBase(block, block_size, candidate);
+                if (fits(block, block_size, candidate, base))
+                {
+                    result = {size, candidate.encoding};
+                }
+            }
+            return result;
+        }
+    } // namespace
+
+    CompressedSize bdiCompressScalar(const uint8_t *block, size_t block_size)
+    {
+        return bdiCompressWith(block, block_size, fitsScalar);
+    }
+
+    CompressedSize bdiCompress(const uint8_t *block, size_t block_size)
+    {
+#ifdef __SSE2__
+        if (block_size % 16 == 0)
+        {
+            return bdiCompressWith(block, block_size, fitsSse2);
+        }
+#endif
+        return bdiCompressScalar(block, block_size);
+    }
+
+    CompressedSize fpcCompress(const uint8_t *block, size_t block_size)
+    {
+        size_t bits = 0;
+        size_t zero_run = 0;
+        for (size_t i = 0; i < block_size; i += 4)
+        {
+            uint32_t word = loadElement<uint32_t>(block + i);
+            if (word == 0)
+            {
+                // 零串：3 位前缀 + 3 位长度，最多 8 个字
+                if (zero_run++ % 8 == 0)
+                {
+                    bits += 6;
+                }
+                continue;
+            }
+            zero_run = 0;
+
+            int32_t value = static_cast<int32_t>(word);
+            int16_t high = static_cast<int16_t>(word >> 16);
+            int16_t low = static_cast<int16_t>(word & 0xFFFF);
+            if (value >= -8 && value < 8)
+            {
+                bits += 3 + 4; // 4 位符号扩展
+            }
+            else if (value >= -128 && value < 128)
+            {
+                bits += 3 + 8; // 1 字节符号扩展
+            }
+            else if (word == ((word & 0xFF) * 0x01010101u))
+            {
+                bits += 3 + 8; // 重复字节
+            }
+            else if ((value >= -32768 && value < 32768) || low == 0 ||
+                     (high >= -128 && high < 128 && low >= -128 && low < 128))
+            {
+                bits += 3 + 16; // 半字符号扩展、低半字为零、两个半字各为符号扩展的字节
+            }
+            else
+            {
+                bits += 3 + 32;
+            }
+        }
+        return {std::min(block_size, (bits + 7) / 8), BdiEncoding::Uncompressed};
+    }
+
+    CompressedSize compressBlock(CompressionAlgorithm algorithm, const uint8_t *block, size_t block_size)
+    {
+        return algorithm == CompressionAlgorithm::FPC ? fpcCompress(block, block_size) : bdiCompress(block, block_size);
+    }
+
+    MemoryImage::MemoryImage(size_t block_size, ValueModel model, uint64_t seed)
+        : block_size_(block_size), model_(model), seed_(mix64(seed))
+    {
+        block_bits_ = static_cast<size_t>(__builtin_ctzll(block_size));
+    }
+
+    bool MemoryImage::loadFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        file_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        pool_.clear();
+        offsets_.clear();
+        return true;
+    }
+
+    ValueModel MemoryImage::kindOf(uint64_t block_address) const
+    {
+        if (model_ != ValueModel::Mixed)
+        {
+            return model_;
+        }
+        uint64_t choice = mix64(block_address ^ seed_) % 100;
+        if (choice < 35)
+        {
+            return ValueModel::Zero;
+        }
+        if (choice < 65)
+        {
+            return ValueModel::Narrow;
+        }
+        return choice < 85 ? ValueModel::Pointer : ValueModel::Random;
+    }
+
+    uint64_t MemoryImage::generate(ValueModel kind, uint64_t block_address, uint64_t index) const
+    {
+        uint64_t hash = mix64(mix64(block_address ^ seed_) + index);
+        switch (kind)
+        {
+        case ValueModel::Zero:
+            return 0;
+        case ValueModel::Narrow:
+            // 两个取值小于 256 的 4 字节整数
+            return (hash & 0xFF) | ((hash >> 8) & 0xFF) << 32;
+        case ValueModel::Pointer:
+        {
+            // 同一 4KB 页内的块指向同一 64KB 区域内 8 字节对齐的对象
+            uint64_t region = 0x00007f0000000000ULL + ((mix64((block_address >> (12 - std::min<size_t>(block_bits_, 12))) ^ seed_) & 0xFFFFF) << 16);
+            return region + (hash & 0xFFF) * 8;
+        }
+        case ValueModel::Random:
+        default:
+            return hash;
+        }
+    }
+
+    uint8_t *MemoryImage::fetch(uint64_t block_address)
+    {
+        auto found = offsets_.find(block_address);
+        if (found != offsets_.end())
+        {
+            return &pool_[found->second];
+        }
+
+        size_t offset = pool_.size();
+        offsets_.emplace(block_address, offset);
+        pool_.resize(offset + block_size_);
+        uint8_t *data = &pool_[offset];
+
+        ValueModel kind = kindOf(block_address);
+        for (size_t i = 0; i < block_size_; i += 8)
+        {
+            uint64_t value = generate(kind, block_address, i / 8);
+            std::memcpy(data + i, &value, 8);
+        }
+
+        // 内存映像文件覆盖的部分使用文件内容
+        uint64_t start = block_address << block_bits_;
+        if (start < file_.size())
+        {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(block_size_, file_.size() - start));
+            std::memcpy(data, &file_[start], count);
+        }
+        return data;
+    }
+
+    const uint8_t *MemoryImage::block(uint64_t address)
+    {
+        return fetch(address >> block_bits_);
+    }
+
+    void MemoryImage::write(uint64_t address, uint64_t value)
+    {
+        uint8_t *data = fetch(address >> block_bits_);
+        std::memcpy(data + (address & (block_size_ - 1) & ~uint64_t(7)), &value, 8);
+    }
+
+    uint64_t MemoryImage::nextValue(uint64_t address)
+    {
+        uint64_t block_address = address >> block_bits_;
+        return generate(kindOf(block_address), block_address, (++counter_ << 32) ^ (address & (block_size_ - 1)));
+    }
+
+    std::string MemoryImage::getValueModelName(ValueModel model)
+    {
+        switch (model)
+        {
+        case ValueModel::Zero:
+            return "全零";
+        case ValueModel::Narrow:
+            return "小整数";
+        case ValueModel::Pointer:
+            return "指针";
+        case ValueModel::Random:
+            return "随机";
+        case ValueModel::Mixed:
+            return "混合";
+        default:
+            return "未知取值";
+        }
+    }
+
+    CompressedCache::CompressedCache(const CacheConfig &cache_config, const CompressionConfig &config, MemoryImage *memory)
+        : config_(config), memory_(memory), block_size_(cache_config.block_size)
+    {
+        num_sets_ = std::max<size_t>(1, cache_config.cache_size / (cache_config.block_size * cache_config.associativity));
+        set_bytes_ = cache_config.associativity * cache_config.block_size;
+        sets_.resize(num_sets_);
+        for (Set &set : sets_)
+        {
+            set.entries.resize(cache_config.associativity * config_.tag_factor);
+        }
+    }
+
+    uint32_t CompressedCache::compressedSize(uint64_t address, BdiEncoding *encoding)
+    {
+        CompressedSize compressed = compressBlock(config_.algorithm, memory_->block(address), block_size_);
+        *encoding = compressed.encoding;
+        size_t segment = config_.segment_size;
+        return static_cast<uint32_t>(std::min(block_size_, (compressed.bytes + segment - 1) / segment * segment));
+    }
+
+    bool CompressedCache::evictLru(Set &set, const Entry *keep)
+    {
+        Entry *victim = nullptr;
+        for (Entry &entry : set.entries)
+        {
+            if (entry.valid && &entry != keep && (victim == nullptr || entry.last_access < victim->last_access))
+            {
+                victim = &entry;
+            }
+        }
+        if (victim == nullptr)
+        {
+            return false;
+        }
+        stats_.evictions++;
+        stats_.writebacks += victim->dirty ? 1 : 0;
+        set.used -= victim->size;
+        victim->valid = false;
+        return true;
+    }
+
+    bool CompressedCache::access(uint64_t address, bool is_write)
+    {
+        uint64_t block_address = address / block_size_;
+        Set &set = sets_[block_address % num_sets_];
+        uint64_t tag = block_address / num_sets_;
+        ++time_;
+
+        Entry *free_entry = nullptr;
+        for (Entry &entry : set.entries)
+        {
+            if (!entry.valid)
+            {
+                free_entry = free_entry ? free_entry : &entry;
+                continue;
+            }
+            if (entry.tag != tag)
+            {
+                continue;
+            }
+
+            stats_.hits++;
+            entry.last_access = time_;
+            if (is_write)
+            {
+                // 写入改变块内容，重新压缩，变大时驱逐同组的其他块
+                entry.dirty = true;
+                BdiEncoding encoding;
+                uint32_t size = compressedSize(address, &encoding);
+                if (size != entry.size)
+                {
+                    stats_.size_changes++;
+                    set.used = set.used - entry.size + size;
+                    entry.size = size;
+                    while (set.used > set_bytes_ && evictLru(set, &entry))
+                    {
+                        stats_.growth_evictions++;
+                    }
+                }
+            }
+            return true;
+        }
+
+        stats_.misses++;
+        BdiEncoding encoding;
+        uint32_t size = compressedSize(address, &encoding);
+        stats_.fill_bytes += size;
+        if (config_.algorithm == CompressionAlgorithm::BDI)
+        {
+            stats_.encodings[static_cast<size_t>(encoding)]++;
+        }
+
+        // 需要空闲标签且剩余空间足以容纳新块
+        while (free_entry == nullptr || set.used + size > set_bytes_)
+        {
+            evictLru(set, nullptr);
+            if (free_entry == nullptr)
+            {
+                for (Entry &entry : set.entries)
+                {
+                    if (!entry.valid)
+                    {
+                        free_entry = &entry;
+                        break;
+                    }
+                }
+            }
+        }
+
+        free_entry->valid = true;
+        free_entry->dirty = is_write;
+        free_entry->tag = tag;
+        free_entry->size = size;
+        free_entry->last_access = time_;
+        set.used += size;
+        return false;
+    }
+
+    size_t CompressedCache::residentBlocks() const
+    {
+        size_t count = 0;
+        for (const Set &set : sets_)
+        {
+            for (const Entry &entry : set.entries)
+            {
+                count += entry.valid ? 1 : 0;
+            }
+        }
+        return count;
+    }
+
+    double CompressedCache::compressionRatio() const
+    {
+        size_t used = 0;
+        for (const Set &set : sets_)
+        {
+            used += set.used;
+        }
+        return used > 0 ? static_cast<double>(residentBlocks() * block_size_) / used : 0.0;
+    }
+
+    std::string CompressedCache::getAlgorithmName(CompressionAlgorithm algorithm)
+    {
+        switch (algorithm)
+        {
+        case CompressionAlgorithm::BDI:
+            return "BDI";
+        case CompressionAlgorithm::FPC:
+            return "FPC";
+        default:
+            return "未知算法";
+        }
+    }
+
+    std::string CompressedCache::getEncodingName(BdiEncoding encoding)
+    {
+        switch (encoding)
+        {
+        case BdiEncoding::Zeros:
+            return "zeros";
+        case BdiEncoding::Repeated:
+            return "repeated";
+        case BdiEncoding::Base8Delta1:
+            return "b8d1";
+        case BdiEncoding::Base4Delta1:
+            return "b4d1";
+        case BdiEncoding::Base8Delta2:
+            return "b8d2";
+        case BdiEncoding::Base2Delta1:
+            return "b2d1";
+        case BdiEncoding::Base4Delta2:
+            return "b4d2";
+        case BdiEncoding::Base8Delta4:
+            return "b8d4";
+        case BdiEncoding::Uncompressed:
+            return "uncompressed";
+        default:
+            return "unknown";
+        }
+    }
+
+} // namespace cache_sim
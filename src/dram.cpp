@@ -0,0 +1,261 @@
+#include "dram.h"
+
+namespace cache_sim
+{
+    MemoryController::MemoryController(const DramConfig &config, size_t block_size)
+        : config_(config), block_size_(block_size)
+    {
+        // 通道、rank、bank 数、块大小与行大小均为 2 的幂（由参数解析保证）
+        block_bits_ = static_cast<size_t>(__builtin_ctzll(block_size));
+        row_bits_ = static_cast<size_t>(__builtin_ctzll(config_.row_size));
+        channel_bits_ = static_cast<size_t>(__builtin_ctzll(config_.channels));
+        bank_bits_ = static_cast<size_t>(__builtin_ctzll(config_.banks));
+        rank_bits_ = static_cast<size_t>(__builtin_ctzll(config_.ranks));
+
+        channels_.resize(config_.channels);
+        for (Channel &channel : channels_)
+        {
+            channel.banks.resize(config_.ranks * config_.banks);
+            channel.pending_hit.resize(config_.ranks * config_.banks);
+        }
+    }
+
+    void MemoryController::advance(uint64_t cycles)
+    {
+        now_ += cycles;
+    }
+
+    void MemoryController::enqueue(uint64_t address, bool is_write)
+    {
+        uint64_t bits = address >> (config_.mapping == DramMapping::Row ? row_bits_ : block_bits_);
+        size_t channel_id = static_cast<size_t>(bits & (config_.channels - 1));
+        bits >>= channel_bits_;
+        size_t bank = static_cast<size_t>(bits & (config_.banks - 1));
+        bits >>= bank_bits_;
+        size_t rank = static_cast<size_t>(bits & (config_.ranks - 1));
+        bits >>= rank_bits_;
+        if (config_.mapping == DramMapping::Block)
+        {
+            // 跳过行内的列地址
+            bits >>= row_bits_ - block_bits_;
+        }
+
+        // 先发出在请求到达之前就能发出的请求
+        Channel &channel = channels_[channel_id];
+        while (issue(channel, now_))
+        {
+        }
+
+        // 队列已满：处理器停顿到调度器发出请求腾出位置，之后的访问随之推迟
+        if (channel.queue.size() >= config_.queue_depth)
+        {
+            uint64_t stalled = now_;
+            while (channel.queue.size() >= config_.queue_depth)
+            {
+                issue(channel, std::numeric_limits<uint64_t>::max());
+            }
+            now_ = std::max(now_, channel.next_issue);
+            stats_.queue_full_stalls++;
+            stats_.stall_cycles += now_ - stalled;
+        }
+
+        Request request;
+        request.arrival = now_;
+        request.bank = rank * config_.banks + bank;
+        request.row = bits;
+        request.is_write = is_write;
+        channel.queue.push_back(request);
+    }
+
+    uint32_t MemoryController::rowOverhead(const Bank &bank, uint64_t row) const
+    {
+        if (bank.open && bank.row == row)
+        {
+            return 0;
+        }
+        // 空 bank 只需激活，行冲突需先预充电
+        return bank.open ? config_.t_rp + config_.t_rcd : config_.t_rcd;
+    }
+
+    uint64_t MemoryController::readyTime(const Channel &channel, const Request &request, uint64_t earliest) const
+    {
+        const Bank &bank = channel.banks[request.bank];
+        uint64_t ready = std::max(std::max(earliest, request.arrival), bank.ready);
+        if (bank.open && bank.row != request.row && channel.pending_hit[request.bank] <= ready)
+        {
+            // 行命中优先：该 bank 还有命中打开行的请求时不预充电
+            return std::numeric_limits<uint64_t>::max();
+        }
+        uint64_t latency = rowOverhead(bank, request.row) + config_.t_cas;
+        if (channel.bus_free > latency)
+        {
+            ready = std::max(ready, channel.bus_free - latency);
+        }
+        return ready;
+    }
+
+    bool MemoryController::issue(Channel &channel, uint64_t until)
+    {
+        if (channel.queue.empty())
+        {
+            return false;
+        }
+
+        // 最早的发出时间：命令总线空闲、请求已到达、其 bank 可以接受命令，
+        // 且数据不早于数据总线空闲时就绪（总线积压时请求留在队列中继续参与调度）。
+        // 队列按到达时间排列，到达晚于当前最早时间的请求不必再看
+        uint64_t earliest = std::max(channel.next_issue, channel.queue.front().arrival);
+        std::fill(channel.pending_hit.begin(), channel.pending_hit.end(), std::numeric_limits<uint64_t>::max());
+        for (const Request &request : channel.queue)
+        {
+            const Bank &bank = channel.banks[request.bank];
+            if (bank.open && bank.row == request.row)
+            {
+                channel.pending_hit[request.bank] = std::min(channel.pending_hit[request.bank], request.arrival);
+            }
+        }
+
+        uint64_t issue_time = std::numeric_limits<uint64_t>::max();
+        for (const Request &request : channel.queue)
+        {
+            if (request.arrival > issue_time)
+            {
+                break;
+            }
+            issue_time = std::min(issue_time, readyTime(channel, request, earliest));
+        }
+        if (issue_time > until)
+        {
+            return false;
+        }
+
+        // FR-FCFS：可发出的请求中优先行缓冲命中，其次最早到达
+        auto chosen = channel.queue.end();
+        for (auto it = channel.queue.begin(); it != channel.queue.end() && it->arrival <= issue_time; ++it)
+        {
+            if (readyTime(channel, *it, earliest) > issue_time)
+            {
+                continue;
+            }
+            if (chosen == channel.queue.end())
+            {
+                chosen = it;
+            }
+            const Bank &bank = channel.banks[it->bank];
+            if (bank.open && bank.row == it->row)
+            {
+                chosen = it;
+                break;
+            }
+        }
+
+        Request request = *chosen;
+        channel.queue.erase(chosen);
+        Bank &bank = channel.banks[request.bank];
+
+        if (bank.open && bank.row == request.row)
+        {
+            stats_.row_hits++;
+        }
+        else if (!bank.open)
+        {
+            stats_.row_empty++;
+        }
+        else
+        {
+            stats_.row_conflicts++;
+        }
+        uint64_t column = issue_time + rowOverhead(bank, request.row);
+
+        uint64_t data = std::max(column + config_.t_cas, channel.bus_free);
+        uint64_t done = data + config_.t_burst;
+        channel.bus_free = done;
+        channel.next_issue = issue_time + 1;
+
+        if (config_.page_policy == PagePolicy::Open)
+        {
+            bank.open = true;
+            bank.row = request.row;
+            bank.ready = column + config_.t_burst;
+        }
+        else
+        {
+            // 自动预充电：数据传输结束后关闭该行
+            bank.open = false;
+            bank.ready = done + config_.t_rp;
+        }
+
+        stats_.queue_cycles += issue_time - request.arrival;
+        stats_.bytes += block_size_;
+        if (request.is_write)
+        {
+            stats_.writes++;
+        }
+        else
+        {
+            stats_.reads++;
+            stats_.read_latency_cycles += done - request.arrival;
+        }
+        last_done_ = std::max(last_done_, done);
+        return true;
+    }
+
+    void MemoryController::drain()
+    {
+        for (Channel &channel : channels_)
+        {
+            while (issue(channel, std::numeric_limits<uint64_t>::max()))
+            {
+            }
+        }
+    }
+
+    void MemoryController::resetStats()
+    {
+        stats_ = DramStats();
+        start_time_ = now_;
+    }
+
+    uint64_t MemoryController::elapsedCycles() const
+    {
+        return std::max(last_done_, now_) - start_time_;
+    }
+
+    double MemoryController::bandwidth() const
+    {
+        uint64_t cycles = elapsedCycles();
+        return cycles > 0 ? static_cast<double>(stats_.bytes) * config_.clock_mhz / cycles / 1000.0 : 0.0;
+    }
+
+    double MemoryController::peakBandwidth() const
+    {
+        return static_cast<double>(config_.channels * block_size_) * config_.clock_mhz / config_.t_burst / 1000.0;
+    }
+
+    std::string MemoryController::getMappingName(DramMapping mapping)
+    {
+        switch (mapping)
+        {
+        case DramMapping::Row:
+            return "行交织";
+        case DramMapping::Block:
+            return "块交织";
+        default:
+            return "未知映射";
+        }
+    }
+
+    std::string MemoryController::getPagePolicyName(PagePolicy policy)
+    {
+        switch (policy)
+        {
+        case PagePolicy::Open:
+            return "开页";
+        case PagePolicy::Closed:
+            return "关页";
+        default:
+            return "未知策略";
+        }
+    }
+
+} // namespace cache_sim
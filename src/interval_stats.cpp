@@ -0,0 +1,95 @@
+#include "interval_stats.h"
+
+namespace cache_sim
+{
+    IntervalRecorder::IntervalRecorder(std::ostream &os, IntervalFormat format, size_t num_cores)
+        : os_(os), format_(format), previous_(num_cores), previous_access_count_(0), interval_index_(0)
+    {
+        if (format_ == IntervalFormat::Csv)
+        {
+            os_ << "interval,access_begin,access_end,core_id,reads,writes,hits,misses,"
+                << "evictions,writebacks,bus_transactions,hit_rate\n";
+        }
+    }
+
+    void IntervalRecorder::record(uint64_t access_count, const std::vector<std::unique_ptr<Cache>> &caches)
+    {
+        if (format_ == IntervalFormat::JsonLines)
+        {
+            os_ << "{\"interval\": " << interval_index_
+                << ", \"access_begin\": " << previous_access_count_
+                << ", \"access_end\": " << access_count
+                << ", \"cores\": [";
+        }
+
+        for (size_t i = 0; i < caches.size() && i < previous_.size(); ++i)
+        {
+            const CacheStats &current = caches[i]->getStats();
+            const CacheStats &previous = previous_[i];
+
+            // 计算本区间内的增量
+            CacheStats delta;
+            delta.reads = current.reads - previous.reads;
+            delta.writes = current.writes - previous.writes;
+            delta.hits = current.hits - previous.hits;
+            delta.misses = current.misses - previous.misses;
+            delta.evictions = current.evictions - previous.evictions;
+            delta.writebacks = current.writebacks - previous.writebacks;
+            delta.bus_transactions = current.bus_transactions - previous.bus_transactions;
+            double hit_rate = delta.hitRate() * 100.0;
+
+            if (format_ == IntervalFormat::JsonLines)
+            {
+                os_ << (i == 0 ? "" : ", ")
+                    << "{\"core_id\": " << i
+                    << ", \"reads\": " << delta.reads
+                    << ", \"writes\": " << delta.writes
+                    << ", \"hits\": " << delta.hits
+                    << ", \"misses\": " << delta.misses
+                    << ", \"evictions\": " << delta.evictions
+                    << ", \"writebacks\": " << delta.writebacks
+                    << ", \"bus_transactions\": " << delta.bus_transactions
+                    << ", \"hit_rate\": " << std::fixed << std::setprecision(2) << hit_rate << "}";
+            }
+            else
+            {
+                os_ << interval_index_ << ','
+                    << previous_access_count_ << ','
+                    << access_count << ','
+                    << i << ','
+                    << delta.reads << ','
+                    << delta.writes << ','
+                    << delta.hits << ','
+                    << delta.misses << ','
+                    << delta.evictions << ','
+                    << delta.writebacks << ','
+                    << delta.bus_transactions << ','
+                    << std::fixed << std::setprecision(2) << hit_rate << '\n';
+            }
+
+            previous_[i] = current;
+        }
+
+        if (format_ == IntervalFormat::JsonLines)
+        {
+            os_ << "]}\n";
+        }
+
+        previous_access_count_ = access_count;
+        interval_index_++;
+    }
+
+    std::string IntervalRecorder::getFormatName(IntervalFormat format)
+    {
+        switch (format)
+        {
+        case IntervalFormat::JsonLines:
+            return "jsonl";
+        case IntervalFormat::Csv:
+            return "csv";
+        default:
+            return "未知格式";
+        }
+    }
+
+} // namespace cache_sim
@@ -1,5 +1,4 @@
 #include "lfu_cache.h"
-#include <chrono>
 
 namespace cache_sim
 {
@@ -50,7 +49,7 @@ namespace cache_sim
         auto &lfu_set = lfu_sets_[set_index];
 
         // 更新时间戳
-        line->last_access_time = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        line->last_access_time = ++access_clock_;
 
         if (lfu_set.line_to_node.count(line))
         {
@@ -91,6 +90,16 @@ namespace cache_sim
         }
     }
 
+    bool LFUCache::preferVictim(const CacheLine &a, const CacheLine &b) const
+    {
+        // 访问频率低者优先，频率相同时替换最早访问的
+        if (a.access_count != b.access_count)
+        {
+            return a.access_count < b.access_count;
+        }
+        return a.last_access_time < b.last_access_time;
+    }
+
     void LFUCache::resetLine(size_t set_index, CacheLine *line)
     {
         if (line == nullptr)
@@ -114,4 +123,51 @@ namespace cache_sim
         line->access_count = 0;
     }
 
+    void LFUCache::saveReplacementState(std::ostream &os) const
+    {
+        // 最小频率不一定等于组内最小访问计数（驱逐时不回退），需要单独保存
+        std::vector<uint64_t> min_freq(lfu_sets_.size());
+        for (size_t i = 0; i < lfu_sets_.size(); ++i)
+        {
+            min_freq[i] = lfu_sets_[i].min_freq;
+        }
+        os.write(reinterpret_cast<const char *>(min_freq.data()), min_freq.size() * sizeof(uint64_t));
+    }
+
+    bool LFUCache::loadReplacementState(std::istream &is)
+    {
+        std::vector<uint64_t> min_freq(lfu_sets_.size());
+        if (!is.read(reinterpret_cast<char *>(min_freq.data()), min_freq.size() * sizeof(uint64_t)))
+        {
+            return false;
+        }
+
+        // 访问计数非零的行都在对应频率的链表中，链表内按最后访问时间降序
+        for (size_t set_index = 0; set_index < sets_.size(); ++set_index)
+        {
+            LFUSet &lfu_set = lfu_sets_[set_index];
+            lfu_set.freq_list.clear();
+            lfu_set.line_to_node.clear();
+            lfu_set.min_freq = min_freq[set_index];
+
+            std::vector<CacheLine *> lines;
+            for (auto &line : sets_[set_index].lines)
+            {
+                if (line.access_count > 0)
+                {
+                    lines.push_back(&line);
+                }
+            }
+            std::sort(lines.begin(), lines.end(), [](const CacheLine *a, const CacheLine *b)
+                      { return a->last_access_time > b->last_access_time; });
+            for (CacheLine *line : lines)
+            {
+                auto &list = lfu_set.freq_list[line->access_count];
+                list.push_back(line);
+                lfu_set.line_to_node[line] = std::prev(list.end());
+            }
+        }
+        return true;
+    }
+
 } // namespace cache_sim
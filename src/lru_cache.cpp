@@ -1,5 +1,4 @@
 #include "lru_cache.h"
-#include <chrono>
 
 namespace cache_sim
 {
@@ -40,7 +39,7 @@ namespace cache_sim
     {
         if (line == nullptr) return;
 
-        line->last_access_time = std::chrono::steady_clock::now().time_since_epoch().count();
+        line->last_access_time = ++access_clock_;
 
         auto &lru_set = lru_sets_[set_index];
         auto it = lru_set.line_to_node.find(line);
@@ -73,4 +72,33 @@ namespace cache_sim
         }
     }
 
+    bool LRUCache::loadReplacementState(std::istream &)
+    {
+        // 每次访问都会推进时钟，因此按最后访问时间降序即为 LRU 链表顺序；
+        // 访问过的行（包括被嗅探作废的行）都在链表中
+        for (size_t set_index = 0; set_index < sets_.size(); ++set_index)
+        {
+            LRUSet &lru_set = lru_sets_[set_index];
+            lru_set.lru_list.clear();
+            lru_set.line_to_node.clear();
+
+            std::vector<CacheLine *> lines;
+            for (auto &line : sets_[set_index].lines)
+            {
+                if (line.last_access_time > 0)
+                {
+                    lines.push_back(&line);
+                }
+            }
+            std::sort(lines.begin(), lines.end(), [](const CacheLine *a, const CacheLine *b)
+                      { return a->last_access_time > b->last_access_time; });
+            for (CacheLine *line : lines)
+            {
+                lru_set.lru_list.push_back(line);
+                lru_set.line_to_node[line] = std::prev(lru_set.lru_list.end());
+            }
+        }
+        return true;
+    }
+
 } // namespace cache_sim
@@ -19,18 +19,487 @@ void printUsage(const char *program_name)
     std::cout << "  -h, --help              显示帮助信息" << std::endl;
     std::cout << "  -s, --size <字节>       缓存大小（默认: 32768，即 32KB）" << std::endl;
     std::cout << "  -b, --block <字节>      块大小（默认: 64）" << std::endl;
+    std::cout << "      --sector-size <字节>  分扇区缓存：每个标签对应多个扇区，缺失时只取回所访问的扇区，只写回脏扇区（默认: 不分扇区）" << std::endl;
     std::cout << "  -a, --assoc <数值>      关联度（默认: 4，即 4 路组相联）" << std::endl;
     std::cout << "  -p, --policy <策略>     替换策略: lru 或 lfu（默认: lru）" << std::endl;
+    std::cout << "  -i, --index <函数>      组索引函数: modulo, xor, prime, skewed（默认: modulo）" << std::endl;
+    std::cout << "      --victim-cache <条目数>  为每个 L1 附加全相联受害者缓存（默认: 0，不启用）" << std::endl;
+    std::cout << "      --victim-mode <模式>  附加缓存模式: victim 或 miss（默认: victim）" << std::endl;
+    std::cout << "      --write-policy <策略>  写命中策略: wb（写回）或 wt（写直达）（默认: wb）" << std::endl;
+    std::cout << "      --no-write-allocate  写缺失时不分配缓存行" << std::endl;
+    std::cout << "      --write-buffer <条目数>  合并写缓冲条目数（默认: 0，不启用）" << std::endl;
+    std::cout << "      --sample-sets <k>   组采样：只模拟约 1/k 的组并外推统计（默认: 1，模拟所有组）" << std::endl;
+    std::cout << "      --sample-mode <方式>  组采样方式: hash（散列抽取）或 stride（每 k 组取一）（默认: hash）" << std::endl;
+    std::cout << "      --protocol <协议>   缓存一致性协议: mesi, moesi, mesif（默认: mesi）" << std::endl;
+    std::cout << "      --compare-protocols  在同一访问流上比较 MESI/MOESI/MESIF 的总线流量" << std::endl;
     std::cout << "  -t, --pattern <模式>    访问模式: random, sequential, localized（默认: random）" << std::endl;
+    std::cout << "                          多核共享模式: producer-consumer, migratory, read-mostly, lock" << std::endl;
+    std::cout << "                          键值模式: zipf, scrambled-zipf, hotspot, latest" << std::endl;
+    std::cout << "      --zipf-theta <值>   Zipf 偏斜指数（默认: 0.99）" << std::endl;
+    std::cout << "      --object-size <字节>  键值模式中每个键对应的对象大小，可跨多块（默认: 一块）" << std::endl;
+    std::cout << "      --hot-fraction <比例>  热点模式中热键的比例（默认: 0.2）" << std::endl;
+    std::cout << "      --hot-access <比例>  热点模式中访问热键的比例（默认: 0.8）" << std::endl;
+    std::cout << "      --sharers <数量>    共享模式中每组共享同一份数据的核心数（默认: 0，即全部核心）" << std::endl;
+    std::cout << "      --write-ratio <比例>  写操作比例（默认: 0.25，read-mostly 为 0.02）" << std::endl;
+    std::cout << "      --core-workload <核心>:<键>=<值>,...  单独设置某个核心的负载，可多次指定" << std::endl;
+    std::cout << "                          键: pattern, base, range, ws-size, ws-period, write, weight, sharers," << std::endl;
+    std::cout << "                               theta, object, hot-fraction, hot-access" << std::endl;
+    std::cout << "      --interleave <方式>  各核心访问流的交织方式: rr 或 weighted（默认: rr）" << std::endl;
+    std::cout << "      --processes <数量>  每个核心上按时间片轮转的进程数，各进程有独立的地址空间（默认: 1）" << std::endl;
+    std::cout << "      --time-slice <次数>  时间片长度（该核心的访问次数，默认: 10000）" << std::endl;
+    std::cout << "      --switch-flush <方式>  上下文切换时的缓存处理: keep, partial（回收硬件 ASID 时刷新）, full（默认: keep）" << std::endl;
+    std::cout << "      --asids <数量>      partial 方式下每个核心的硬件 ASID 数（默认: 2）" << std::endl;
+    std::cout << "      --process-workload <进程>:<键>=<值>,...  单独设置核内第 i 个进程的负载（各核心相同），键同 --core-workload" << std::endl;
+    std::cout << "      --way-masks <掩码>,...  路划分（类似 CAT）：各 CLOS 可替换的路，如 0x0f,0xf0（需 --processes 大于 1）" << std::endl;
+    std::cout << "      --clos <进程>:<CLOS>,...  核内进程所属的 CLOS（默认: 核内编号对 CLOS 数取模）" << std::endl;
+    std::cout << "      --ucp <次数>        UCP 动态路划分：按影子标签统计的效用每隔指定访问次数重新划分，每个进程一个分区" << std::endl;
+    std::cout << "      --refill-window <次数>  换入后统计重新填充代价的访问次数（默认: 1000）" << std::endl;
     std::cout << "  -n, --accesses <次数>   访问次数（默认: 10000）" << std::endl;
     std::cout << "  -r, --range <字节>      地址范围（默认: 1048576，即 1MB）" << std::endl;
     std::cout << "  -c, --cores <数量>      CPU 核心数（默认: 1）" << std::endl;
     std::cout << "  -w, --ws-period <次数>  工作集切换周期（默认: 10000）" << std::endl;
     std::cout << "  -v, --ws-size <字节>    工作集大小（默认: 65536，即 64KB）" << std::endl;
+    std::cout << "      --seed <种子>       随机数种子，相同种子得到相同结果（默认: 随机，并在结果中输出）" << std::endl;
+    std::cout << "      --trace <文件>      从 trace 文件读取访问，可多次指定，第 i 个文件驱动第 i 个核心（\"-\" 为标准输入）" << std::endl;
+    std::cout << "      --trace-format <格式>  trace 格式: din, lackey, champsim, native（默认按扩展名 .din/.lackey/.champsim/.cst 推断）" << std::endl;
+    std::cout << "      --trace-threads <数量>  压缩 trace 的解码线程数（默认: 2）" << std::endl;
+    std::cout << "      --convert-trace <文件>  将 --trace 指定的文件转换为压缩格式后退出" << std::endl;
+    std::cout << "      --vm                在数据缓存之前模拟 TLB、页表遍历与页面置换（地址视为虚拟地址）" << std::endl;
+    std::cout << "      --page-size <字节>  页大小（默认: 4096）" << std::endl;
+    std::cout << "      --tlb <条目数>:<关联度>,...  各级 TLB，从 L1 开始（默认: 64:4,1536:12）" << std::endl;
+    std::cout << "      --pt-levels <级数>  页表级数（默认: 4）" << std::endl;
+    std::cout << "      --phys-mem <字节>   物理内存大小，超出时发生页面置换（默认: 0，不限）" << std::endl;
+    std::cout << "      --page-replacement <算法>  页面置换算法: clock, wsclock, lru（默认: clock）" << std::endl;
+    std::cout << "      --wsclock-window <次数>  WSClock 工作集窗口（默认: 10000）" << std::endl;
+    std::cout << "      --page-cache        以文件 I/O 请求驱动页缓存模拟（默认 64MB、4096 字节页、16 路、xor 索引）" << std::endl;
+    std::cout << "      --io-trace <文件>   页缓存的 I/O 请求 trace，每行: <文件编号> <偏移> <长度> <R|W>" << std::endl;
+    std::cout << "      --io-size <字节>    无 I/O trace 时生成请求的长度（默认: 一页）" << std::endl;
+    std::cout << "      --file-size <字节>  无 I/O trace 时按此大小把生成的地址划分为文件（默认: 16777216）" << std::endl;
+    std::cout << "      --readahead <页数>  页缓存的最大预读窗口，0 表示关闭预读（默认: 32）" << std::endl;
+    std::cout << "      --flush-interval <请求数>  定期回写的间隔，0 表示只在驱逐时回写（默认: 5000）" << std::endl;
+    std::cout << "      --dirty-expire <请求数>  脏页变脏超过该时长后由定期回写写出（默认: 30000）" << std::endl;
+    std::cout << "      --sockets <数量>    插槽数，核心按编号连续分配，各插槽有独立的总线，插槽间经互连与主节点目录保持一致（默认: 1）" << std::endl;
+    std::cout << "      --numa-interleave <方式>  内存在插槽间的分布: page, block, first-touch（默认: page）" << std::endl;
+    std::cout << "      --numa-page-size <字节>  按页分布与首次访问分布的粒度（默认: 4096）" << std::endl;
+    std::cout << "      --numa-latency <本地缓存>,<远程缓存>,<本地内存>,<远程内存>  缺失延迟，单位为周期（默认: 40,120,90,150）" << std::endl;
+    std::cout << "      --dram              在最后一级缓存之后模拟 DRAM 内存控制器（FR-FCFS 调度，报告行缓冲命中率、带宽与排队延迟）" << std::endl;
+    std::cout << "      --dram-channels <数量>  DRAM 通道数（默认: 1）" << std::endl;
+    std::cout << "      --dram-ranks <数量>  每通道的 rank 数（默认: 1）" << std::endl;
+    std::cout << "      --dram-banks <数量>  每个 rank 的 bank 数（默认: 8）" << std::endl;
+    std::cout << "      --dram-row-size <字节>  行缓冲大小（默认: 8192）" << std::endl;
+    std::cout << "      --dram-page <策略>  行缓冲策略: open 或 closed（默认: open）" << std::endl;
+    std::cout << "      --dram-mapping <方式>  地址映射: row（同一行的连续块在同一 bank）或 block（连续块分布到各通道与 bank）（默认: row）" << std::endl;
+    std::cout << "      --dram-timing <tRCD>,<tRP>,<tCAS>[,<突发>]  DRAM 时序，单位为 DRAM 周期（默认: 22,22,22,4）" << std::endl;
+    std::cout << "      --dram-queue <深度>  每通道的请求队列深度（默认: 32）" << std::endl;
+    std::cout << "      --dram-clock <MHz>  DRAM 时钟频率，用于换算带宽与纳秒（默认: 1600）" << std::endl;
+    std::cout << "      --dram-interval <周期>  每个核心相邻两次访问之间的 DRAM 周期数（默认: 4）" << std::endl;
+    std::cout << "      --compression <算法>  以带真实数据的压缩缓存对照模拟各核心的缓存: bdi 或 fpc（报告压缩率与有效容量）" << std::endl;
+    std::cout << "      --values <模型>     块初始内容与写入值的取值模型: zero, narrow, pointer, random, mixed（默认: mixed）" << std::endl;
+    std::cout << "      --memory-image <文件>  块初始内容的二进制文件（第 i 个字节为地址 i 的内容，其余地址使用取值模型）" << std::endl;
+    std::cout << "      --compression-tags <倍数>  压缩缓存每组的标签数是路数的倍数（默认: 2）" << std::endl;
+    std::cout << "      --compression-segment <字节>  压缩块的数据空间分配粒度（默认: 8）" << std::endl;
+    std::cout << "      --warmup <次数>     先执行指定次数的预热访问，其统计不计入结果（默认: 0）" << std::endl;
+    std::cout << "      --load-checkpoint <文件>  运行前从检查点恢复缓存状态（缓存配置、核心数与替换策略需一致）" << std::endl;
+    std::cout << "      --save-checkpoint <文件>  运行后将缓存状态保存为检查点" << std::endl;
+    std::cout << "  -j, --json              以 JSON 格式输出结果" << std::endl;
+    std::cout << "      --sharing           检测真共享 / 伪共享导致的一致性缺失" << std::endl;
+    std::cout << "      --sharing-top <数量>  报告一致性缺失最多的块数（默认: 10）" << std::endl;
+    std::cout << "      --reuse-distance    统计复用距离直方图（按块粒度，对数分桶）" << std::endl;
+    std::cout << "      --reuse-max-blocks <数量>  复用距离分析最多跟踪的块数（默认: 1048576）" << std::endl;
+    std::cout << "      --interval <次数>   每隔指定访问次数输出一次区间统计快照（默认: 0，关闭）" << std::endl;
+    std::cout << "      --interval-out <文件>  区间统计输出文件（默认: intervals.jsonl 或 intervals.csv）" << std::endl;
+    std::cout << "      --interval-format <格式>  区间统计格式: jsonl 或 csv（默认: jsonl）" << std::endl;
+    std::cout << "      --set-heatmap <文件>  输出按组访问/缺失/驱逐热力图 CSV（需以 -DENABLE_SET_STATS=ON 编译）" << std::endl;
     std::cout << std::endl;
     std::cout << "示例:" << std::endl;
     std::cout << "  " << program_name << " -s 65536 -b 64 -a 4 -p lru -t random -n 10000" << std::endl;
     std::cout << "  " << program_name << " --size 32768 --policy lfu --pattern localized" << std::endl;
+    std::cout << "  " << program_name << " --trace app.lackey --convert-trace app.cst" << std::endl;
+    std::cout << "  " << program_name << " -s 33554432 -a 16 --trace app.cst --sample-sets 32" << std::endl;
+    std::cout << "  " << program_name << " --vm --phys-mem 262144 --page-replacement wsclock -r 1048576 -t localized" << std::endl;
+    std::cout << "  " << program_name << " -c 2 --processes 4 --time-slice 5000 --switch-flush partial -t localized" << std::endl;
+    std::cout << "  " << program_name << " --processes 2 --process-workload 1:pattern=sequential,range=0x1000000 -a 8 --way-masks 0xfc,0x3" << std::endl;
+    std::cout << "  " << program_name << " -c 8 --sockets 2 --numa-interleave first-touch -t migratory" << std::endl;
+    std::cout << "  " << program_name << " -s 1048576 -a 16 -t sequential -r 67108864 --dram --dram-channels 2 --dram-page closed --dram-mapping block" << std::endl;
+    std::cout << "  " << program_name << " -s 16384 -t localized -r 262144 --compression bdi --values pointer" << std::endl;
+    std::cout << "  " << program_name << " -s 262144 -b 512 --sector-size 64 -t sequential -r 4194304" << std::endl;
+    std::cout << "  " << program_name << " --page-cache --io-trace app.io --readahead 64 --flush-interval 1000" << std::endl;
+    std::cout << "  " << program_name << " -t zipf -n 0 --warmup 1000000 --save-checkpoint warm.ckpt && " << program_name << " -t zipf --load-checkpoint warm.ckpt --write-policy wt" << std::endl;
+    std::cout << "  " << program_name << " -c 2 --core-workload 0:pattern=sequential,write=0 --core-workload 1:base=0x100000,weight=3 --interleave weighted" << std::endl;
+}
+
+/**
+ * @brief 解析访问模式名称
+ * @param name 模式名称
+ * @param pattern 解析结果
+ * @return 是否解析成功
+ */
+bool parsePattern(const std::string &name, AccessPattern &pattern)
+{
+    if (name == "random")
+    {
+        pattern = AccessPattern::Random;
+    }
+    else if (name == "sequential")
+    {
+        pattern = AccessPattern::Sequential;
+    }
+    else if (name == "localized")
+    {
+        pattern = AccessPattern::Localized;
+    }
+    else if (name == "producer-consumer")
+    {
+        pattern = AccessPattern::ProducerConsumer;
+    }
+    else if (name == "migratory")
+    {
+        pattern = AccessPattern::Migratory;
+    }
+    else if (name == "read-mostly")
+    {
+        pattern = AccessPattern::ReadMostly;
+    }
+    else if (name == "lock")
+    {
+        pattern = AccessPattern::LockContention;
+    }
+    else if (name == "zipf")
+    {
+        pattern = AccessPattern::Zipfian;
+    }
+    else if (name == "scrambled-zipf")
+    {
+        pattern = AccessPattern::ScrambledZipfian;
+    }
+    else if (name == "hotspot")
+    {
+        pattern = AccessPattern::Hotspot;
+    }
+    else if (name == "latest")
+    {
+        pattern = AccessPattern::Latest;
+    }
+    else
+    {
+        std::cerr << "错误: 未知的访问模式 '" << name << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 检查键值模式参数
+ * @return 参数是否合法
+ */
+bool validateKeyValueParams(double zipf_theta, double hot_fraction, double hot_access)
+{
+    if (zipf_theta < 0.0)
+    {
+        std::cerr << "错误: Zipf theta 不能为负数" << std::endl;
+        return false;
+    }
+    if (hot_fraction <= 0.0 || hot_fraction > 1.0 || hot_access < 0.0 || hot_access > 1.0)
+    {
+        std::cerr << "错误: 热键比例必须在 (0, 1] 之间，热键访问比例必须在 [0, 1] 之间" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 解析多插槽缺失延迟，格式为 <本地缓存>,<远程缓存>,<本地内存>,<远程内存>
+ * @param spec 延迟描述
+ * @param numa 多插槽配置的引用
+ * @return 是否解析成功
+ */
+bool parseNumaLatency(const std::string &spec, NumaConfig &numa)
+{
+    std::vector<uint32_t> values;
+    std::stringstream fields(spec);
+    std::string field;
+    while (std::getline(fields, field, ','))
+    {
+        values.push_back(static_cast<uint32_t>(std::stoul(field)));
+    }
+    if (values.size() != 4)
+    {
+        std::cerr << "错误: NUMA 延迟格式应为 <本地缓存>,<远程缓存>,<本地内存>,<远程内存>，收到 '" << spec << "'" << std::endl;
+        return false;
+    }
+    numa.local_cache_latency = values[0];
+    numa.remote_cache_latency = values[1];
+    numa.local_memory_latency = values[2];
+    numa.remote_memory_latency = values[3];
+    return true;
+}
+
+/**
+ * @brief 解析 DRAM 时序，格式为 <tRCD>,<tRP>,<tCAS>[,<突发>]
+ * @param spec 时序描述
+ * @param dram DRAM 配置的引用
+ * @return 是否解析成功
+ */
+bool parseDramTiming(const std::string &spec, DramConfig &dram)
+{
+    std::vector<uint32_t> values;
+    std::stringstream fields(spec);
+    std::string field;
+    while (std::getline(fields, field, ','))
+    {
+        values.push_back(static_cast<uint32_t>(std::stoul(field)));
+    }
+    if (values.size() < 3 || values.size() > 4)
+    {
+        std::cerr << "错误: DRAM 时序格式应为 <tRCD>,<tRP>,<tCAS>[,<突发>]，收到 '" << spec << "'" << std::endl;
+        return false;
+    }
+    dram.t_rcd = values[0];
+    dram.t_rp = values[1];
+    dram.t_cas = values[2];
+    if (values.size() == 4)
+    {
+        dram.t_burst = values[3];
+    }
+    return true;
+}
+
+/**
+ * @brief 解析 TLB 层级描述，格式为 <条目数>:<关联度>[,<条目数>:<关联度>...]，从 L1 开始
+ * @param spec TLB 描述
+ * @param levels 解析结果
+ * @return 是否解析成功
+ */
+bool parseTlbLevels(const std::string &spec, std::vector<TlbLevelConfig> &levels)
+{
+    levels.clear();
+    std::stringstream fields(spec);
+    std::string field;
+    while (std::getline(fields, field, ','))
+    {
+        size_t colon = field.find(':');
+        if (colon == std::string::npos)
+        {
+            std::cerr << "错误: TLB 格式应为 <条目数>:<关联度>,... ，收到 '" << field << "'" << std::endl;
+            return false;
+        }
+        TlbLevelConfig level;
+        level.entries = std::stoul(field.substr(0, colon));
+        level.associativity = std::stoul(field.substr(colon + 1));
+        if (level.associativity == 0 || level.entries < level.associativity || level.entries % level.associativity != 0)
+        {
+            std::cerr << "错误: TLB 条目数必须是关联度的正整数倍，收到 '" << field << "'" << std::endl;
+            return false;
+        }
+        levels.push_back(level);
+    }
+    return true;
+}
+
+/**
+ * @brief 解析路划分参数，格式为 <掩码>,<掩码>,...（各 CLOS 的路掩码）与 <进程>:<CLOS>,...
+ * @param masks_spec 路掩码列表（为空时不解析）
+ * @param clos_spec 进程到 CLOS 的映射（为空时不解析）
+ * @param config 配置结构体的引用
+ * @return 是否解析成功
+ */
+bool parsePartitions(const std::string &masks_spec, const std::string &clos_spec, SimulatorConfig &config)
+{
+    std::stringstream masks(masks_spec);
+    std::string field;
+    while (std::getline(masks, field, ','))
+    {
+        uint64_t mask = std::stoull(field, nullptr, 0);
+        if (!isContiguousMask(mask))
+        {
+            std::cerr << "错误: 路掩码必须是非零且连续的位（与 CAT 的容量位掩码相同），收到 '" << field << "'" << std::endl;
+            return false;
+        }
+        config.way_masks.push_back(mask);
+    }
+
+    std::stringstream mapping(clos_spec);
+    while (std::getline(mapping, field, ','))
+    {
+        size_t colon = field.find(':');
+        if (colon == std::string::npos)
+        {
+            std::cerr << "错误: CLOS 映射格式应为 <进程>:<CLOS>,... ，收到 '" << field << "'" << std::endl;
+            return false;
+        }
+        size_t process = std::stoul(field.substr(0, colon));
+        size_t clos = std::stoul(field.substr(colon + 1));
+        if (process >= config.processes_per_core || clos >= config.way_masks.size())
+        {
+            std::cerr << "错误: CLOS 映射 '" << field << "' 超出进程数或 CLOS 数" << std::endl;
+            return false;
+        }
+        // 未指定的进程按核内编号对 CLOS 数取模
+        while (config.process_clos.size() <= process)
+        {
+            config.process_clos.push_back(config.process_clos.size() % config.way_masks.size());
+        }
+        config.process_clos[process] = clos;
+    }
+    return true;
+}
+
+/**
+ * @brief 将 <键>=<值>[,<键>=<值>...] 形式的字段应用到负载上并检查参数
+ * @param spec 字段列表
+ * @param workload 负载
+ * @param name 负载所属对象的名称（用于错误信息）
+ * @param write_ratio_given 是否指定了全局写比例，未指定且字段中改变了访问模式而没有写比例时使用该模式的默认写比例
+ * @return 是否解析成功
+ */
+bool applyWorkloadFields(const std::string &spec, CoreWorkload &workload, const std::string &name, bool write_ratio_given)
+{
+    std::stringstream fields(spec);
+    std::string field;
+    bool pattern_given = false;
+    while (std::getline(fields, field, ','))
+    {
+        size_t eq = field.find('=');
+        if (eq == std::string::npos)
+        {
+            std::cerr << "错误: 核心负载字段缺少 '=': '" << field << "'" << std::endl;
+            return false;
+        }
+        std::string key = field.substr(0, eq);
+        std::string value = field.substr(eq + 1);
+
+        if (key == "pattern")
+        {
+            if (!parsePattern(value, workload.pattern))
+            {
+                return false;
+            }
+            pattern_given = true;
+        }
+        else if (key == "base")
+        {
+            workload.address_base = std::stoull(value, nullptr, 0);
+        }
+        else if (key == "range")
+        {
+            workload.address_range = std::stoull(value, nullptr, 0);
+        }
+        else if (key == "ws-size")
+        {
+            workload.working_set_size = std::stoull(value, nullptr, 0);
+        }
+        else if (key == "ws-period")
+        {
+            workload.working_set_period = std::stoull(value, nullptr, 0);
+        }
+        else if (key == "write")
+        {
+            workload.write_ratio = std::stod(value);
+            write_ratio_given = true;
+        }
+        else if (key == "weight")
+        {
+            workload.weight = std::stoul(value);
+            if (workload.weight == 0)
+            {
+                std::cerr << "错误: " << name << " 的权重必须为正数" << std::endl;
+                return false;
+            }
+        }
+        else if (key == "sharers")
+        {
+            workload.sharers = std::stoul(value);
+        }
+        else if (key == "theta")
+        {
+            workload.zipf_theta = std::stod(value);
+        }
+        else if (key == "object")
+        {
+            workload.object_size = std::stoull(value, nullptr, 0);
+        }
+        else if (key == "hot-fraction")
+        {
+            workload.hot_fraction = std::stod(value);
+        }
+        else if (key == "hot-access")
+        {
+            workload.hot_access = std::stod(value);
+        }
+        else
+        {
+            std::cerr << "错误: 未知的核心负载字段 '" << key << "'" << std::endl;
+            return false;
+        }
+    }
+    if (pattern_given && !write_ratio_given)
+    {
+        workload.write_ratio = defaultWriteRatio(workload.pattern);
+    }
+
+    if (workload.address_range == 0 || workload.working_set_size == 0 || workload.working_set_period == 0)
+    {
+        std::cerr << "错误: " << name << " 的地址范围、工作集大小与切换周期必须大于 0" << std::endl;
+        return false;
+    }
+    if (workload.write_ratio < 0.0 || workload.write_ratio > 1.0)
+    {
+        std::cerr << "错误: " << name << " 的写比例必须在 [0, 1] 之间" << std::endl;
+        return false;
+    }
+    return validateKeyValueParams(workload.zipf_theta, workload.hot_fraction, workload.hot_access);
+}
+
+/**
+ * @brief 解析单个核心的负载描述，格式为 <核心>:<键>=<值>[,<键>=<值>...]
+ * @param spec 负载描述
+ * @param config 配置结构体的引用，core_workloads 需已按核心数初始化
+ * @param write_ratio_given 是否指定了全局写比例
+ * @return 是否解析成功
+ */
+bool parseCoreWorkload(const std::string &spec, SimulatorConfig &config, bool write_ratio_given)
+{
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos)
+    {
+        std::cerr << "错误: 核心负载格式应为 <核心>:<键>=<值>,... ，收到 '" << spec << "'" << std::endl;
+        return false;
+    }
+
+    size_t core_id = std::stoul(spec.substr(0, colon));
+    if (core_id >= config.core_workloads.size())
+    {
+        std::cerr << "错误: 核心负载中的核心编号 " << core_id << " 超出核心数量" << std::endl;
+        return false;
+    }
+    return applyWorkloadFields(spec.substr(colon + 1), config.core_workloads[core_id], "核心 " + std::to_string(core_id),
+                               write_ratio_given);
+}
+
+/**
+ * @brief 解析核内进程的负载描述，格式为 <进程>:<键>=<值>[,<键>=<值>...]，各核心上同编号的进程使用该负载
+ * @param spec 负载描述
+ * @param config 配置结构体的引用，process_workloads 需已按每核心进程数初始化
+ * @param write_ratio_given 是否指定了全局写比例
+ * @return 是否解析成功
+ */
+bool parseProcessWorkload(const std::string &spec, SimulatorConfig &config, bool write_ratio_given)
+{
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos)
+    {
+        std::cerr << "错误: 进程负载格式应为 <进程>:<键>=<值>,... ，收到 '" << spec << "'" << std::endl;
+        return false;
+    }
+
+    size_t process = std::stoul(spec.substr(0, colon));
+    if (process >= config.process_workloads.size())
+    {
+        std::cerr << "错误: 进程负载中的进程编号 " << process << " 超出每核心进程数" << std::endl;
+        return false;
+    }
+    return applyWorkloadFields(spec.substr(colon + 1), config.process_workloads[process], "进程 " + std::to_string(process),
+                               write_ratio_given);
 }
 
 /**
@@ -40,8 +509,22 @@ void printUsage(const char *program_name)
  * @param config 配置结构体的引用
  * @return 是否解析成功
  */
-bool parseArguments(int argc, char *argv[], SimulatorConfig &config)
+bool parseArguments(int argc, char *argv[], SimulatorConfig &config, std::string &convert_output)
 {
+    // 核心负载依赖全局参数与核心数，待全部选项解析完后再应用
+    std::vector<std::string> core_workload_specs;
+    std::vector<std::string> process_workload_specs;
+    bool seed_given = false;
+    bool write_ratio_given = false;
+    bool accesses_given = false;
+    uint64_t phys_mem = 0;
+    bool size_given = false;
+    bool block_given = false;
+    bool assoc_given = false;
+    bool index_given = false;
+    std::string way_masks_spec;
+    std::string clos_spec;
+
     for (int i = 1; i < argc; ++i)
     {
         std::string arg = argv[i];
@@ -59,6 +542,7 @@ bool parseArguments(int argc, char *argv[], SimulatorConfig &config)
                 return false;
             }
             config.cache_config.cache_size = std::stoul(argv[i]);
+            size_given = true;
         }
         else if (arg == "-b" || arg == "--block")
         {
@@ -68,6 +552,16 @@ bool parseArguments(int argc, char *argv[], SimulatorConfig &config)
                 return false;
             }
             config.cache_config.block_size = std::stoul(argv[i]);
+            block_given = true;
+        }
+        else if (arg == "--sector-size")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少扇区大小参数" << std::endl;
+                return false;
+            }
+            config.cache_config.sector_size = std::stoul(argv[i]);
         }
         else if (arg == "-a" || arg == "--assoc")
         {
@@ -77,6 +571,7 @@ bool parseArguments(int argc, char *argv[], SimulatorConfig &config)
                 return false;
             }
             config.cache_config.associativity = std::stoul(argv[i]);
+            assoc_given = true;
         }
         else if (arg == "-p" || arg == "--policy")
         {
@@ -100,106 +595,1427 @@ bool parseArguments(int argc, char *argv[], SimulatorConfig &config)
                 return false;
             }
         }
-        else if (arg == "-t" || arg == "--pattern")
+        else if (arg == "-i" || arg == "--index")
         {
             if (++i >= argc)
             {
-                std::cerr << "错误: 缺少访问模式参数" << std::endl;
+                std::cerr << "错误: 缺少组索引函数参数" << std::endl;
                 return false;
             }
-            std::string pattern = argv[i];
-            if (pattern == "random")
+            std::string index = argv[i];
+            index_given = true;
+            if (index == "modulo")
             {
-                config.access_pattern = AccessPattern::Random;
+                config.cache_config.index_function = IndexFunction::Modulo;
             }
-            else if (pattern == "sequential")
+            else if (index == "xor")
             {
-                config.access_pattern = AccessPattern::Sequential;
+                config.cache_config.index_function = IndexFunction::XorFold;
             }
-            else if (pattern == "localized")
+            else if (index == "prime")
             {
-                config.access_pattern = AccessPattern::Localized;
+                config.cache_config.index_function = IndexFunction::PrimeModulo;
+            }
+            else if (index == "skewed")
+            {
+                config.cache_config.index_function = IndexFunction::Skewed;
             }
             else
             {
-                std::cerr << "错误: 未知的访问模式 '" << pattern << "'" << std::endl;
+                std::cerr << "错误: 未知的组索引函数 '" << index << "'" << std::endl;
                 return false;
             }
         }
-        else if (arg == "-n" || arg == "--accesses")
+        else if (arg == "--victim-cache")
         {
             if (++i >= argc)
             {
-                std::cerr << "错误: 缺少访问次数参数" << std::endl;
+                std::cerr << "错误: 缺少受害者缓存条目数参数" << std::endl;
                 return false;
             }
-            config.num_accesses = std::stoul(argv[i]);
+            config.cache_config.victim_cache_entries = std::stoul(argv[i]);
         }
-        else if (arg == "-r" || arg == "--range")
+        else if (arg == "--victim-mode")
         {
             if (++i >= argc)
             {
-                std::cerr << "错误: 缺少地址范围参数" << std::endl;
+                std::cerr << "错误: 缺少附加缓存模式参数" << std::endl;
+                return false;
+            }
+            std::string mode = argv[i];
+            if (mode == "victim")
+            {
+                config.cache_config.victim_cache_mode = VictimCacheMode::Victim;
+            }
+            else if (mode == "miss")
+            {
+                config.cache_config.victim_cache_mode = VictimCacheMode::Miss;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的附加缓存模式 '" << mode << "'" << std::endl;
                 return false;
             }
-            config.address_range = std::stoul(argv[i]);
         }
-        else if (arg == "-c" || arg == "--cores")
+        else if (arg == "--write-policy")
         {
             if (++i >= argc)
             {
-                std::cerr << "错误: 缺少核心数参数" << std::endl;
+                std::cerr << "错误: 缺少写策略参数" << std::endl;
+                return false;
+            }
+            std::string policy = argv[i];
+            if (policy == "wb" || policy == "write-back")
+            {
+                config.cache_config.write_policy = WritePolicy::WriteBack;
+            }
+            else if (policy == "wt" || policy == "write-through")
+            {
+                config.cache_config.write_policy = WritePolicy::WriteThrough;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的写策略 '" << policy << "'" << std::endl;
                 return false;
             }
-            config.num_cores = std::stoul(argv[i]);
         }
-        else if (arg == "-w" || arg == "--ws-period")
+        else if (arg == "--no-write-allocate")
+        {
+            config.cache_config.write_allocate = false;
+        }
+        else if (arg == "--write-buffer")
         {
             if (++i >= argc)
             {
-                std::cerr << "错误: 缺少工作集切换周期参数" << std::endl;
+                std::cerr << "错误: 缺少写缓冲条目数参数" << std::endl;
                 return false;
             }
-            config.working_set_period = std::stoul(argv[i]);
+            config.cache_config.write_buffer_entries = std::stoul(argv[i]);
         }
-        else if (arg == "-v" || arg == "--ws-size")
+        else if (arg == "--sample-sets")
         {
             if (++i >= argc)
             {
-                std::cerr << "错误: 缺少工作集大小参数" << std::endl;
+                std::cerr << "错误: 缺少组采样比例参数" << std::endl;
                 return false;
             }
-            config.working_set_size = std::stoul(argv[i]);
+            config.cache_config.sampling_ratio = std::stoul(argv[i]);
+            if (config.cache_config.sampling_ratio == 0)
+            {
+                std::cerr << "错误: 组采样比例必须为正数" << std::endl;
+                return false;
+            }
+            if (config.cache_config.set_sampling == SetSampling::None)
+            {
+                config.cache_config.set_sampling = SetSampling::Hashed;
+            }
         }
-        else if (arg == "-j" || arg == "--json")
+        else if (arg == "--sample-mode")
         {
-            config.output_json = true;
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少组采样方式参数" << std::endl;
+                return false;
+            }
+            std::string mode = argv[i];
+            if (mode == "hash")
+            {
+                config.cache_config.set_sampling = SetSampling::Hashed;
+            }
+            else if (mode == "stride")
+            {
+                config.cache_config.set_sampling = SetSampling::Stride;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的组采样方式 '" << mode << "'" << std::endl;
+                return false;
+            }
         }
-        else
+        else if (arg == "--protocol")
         {
-            std::cerr << "错误: 未知的选项 '" << arg << "'" << std::endl;
-            printUsage(argv[0]);
-            return false;
-        }
-    }
-    return true;
-}
-
-int main(int argc, char *argv[])
-{
-#ifdef _WIN32
-    SetConsoleOutputCP(CP_UTF8);
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少一致性协议参数" << std::endl;
+                return false;
+            }
+            std::string protocol = argv[i];
+            if (protocol == "mesi" || protocol == "MESI")
+            {
+                config.cache_config.coherence_protocol = CoherenceProtocol::MESI;
+            }
+            else if (protocol == "moesi" || protocol == "MOESI")
+            {
+                config.cache_config.coherence_protocol = CoherenceProtocol::MOESI;
+            }
+            else if (protocol == "mesif" || protocol == "MESIF")
+            {
+                config.cache_config.coherence_protocol = CoherenceProtocol::MESIF;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的一致性协议 '" << protocol << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--compare-protocols")
+        {
+            config.compare_protocols = true;
+        }
+        else if (arg == "-t" || arg == "--pattern")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少访问模式参数" << std::endl;
+                return false;
+            }
+            if (!parsePattern(argv[i], config.access_pattern))
+            {
+                return false;
+            }
+        }
+        else if (arg == "--write-ratio")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少写比例参数" << std::endl;
+                return false;
+            }
+            config.write_ratio = std::stod(argv[i]);
+            if (config.write_ratio < 0.0 || config.write_ratio > 1.0)
+            {
+                std::cerr << "错误: 写比例必须在 [0, 1] 之间" << std::endl;
+                return false;
+            }
+            write_ratio_given = true;
+        }
+        else if (arg == "--sharers")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少共享度参数" << std::endl;
+                return false;
+            }
+            config.sharers = std::stoul(argv[i]);
+        }
+        else if (arg == "--seed")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少随机数种子参数" << std::endl;
+                return false;
+            }
+            config.seed = std::stoull(argv[i], nullptr, 0);
+            seed_given = true;
+        }
+        else if (arg == "--trace")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 trace 文件参数" << std::endl;
+                return false;
+            }
+            config.trace_files.push_back(argv[i]);
+        }
+        else if (arg == "--trace-format")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 trace 格式参数" << std::endl;
+                return false;
+            }
+            if (!parseTraceFormat(argv[i], config.trace_format))
+            {
+                std::cerr << "错误: 未知的 trace 格式 '" << argv[i] << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--trace-threads")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少解码线程数参数" << std::endl;
+                return false;
+            }
+            config.trace_threads = std::max<size_t>(std::stoul(argv[i]), 1);
+        }
+        else if (arg == "--convert-trace")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少转换输出文件参数" << std::endl;
+                return false;
+            }
+            convert_output = argv[i];
+        }
+        else if (arg == "--zipf-theta")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 Zipf theta 参数" << std::endl;
+                return false;
+            }
+            config.zipf_theta = std::stod(argv[i]);
+        }
+        else if (arg == "--object-size")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少对象大小参数" << std::endl;
+                return false;
+            }
+            config.object_size = std::stoul(argv[i]);
+        }
+        else if (arg == "--hot-fraction")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少热键比例参数" << std::endl;
+                return false;
+            }
+            config.hot_fraction = std::stod(argv[i]);
+        }
+        else if (arg == "--hot-access")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少热键访问比例参数" << std::endl;
+                return false;
+            }
+            config.hot_access = std::stod(argv[i]);
+        }
+        else if (arg == "--core-workload")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少核心负载参数" << std::endl;
+                return false;
+            }
+            core_workload_specs.push_back(argv[i]);
+        }
+        else if (arg == "--interleave")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少交织方式参数" << std::endl;
+                return false;
+            }
+            std::string interleave = argv[i];
+            if (interleave == "rr")
+            {
+                config.interleave = StreamInterleave::RoundRobin;
+            }
+            else if (interleave == "weighted")
+            {
+                config.interleave = StreamInterleave::Weighted;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的交织方式 '" << interleave << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "-n" || arg == "--accesses")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少访问次数参数" << std::endl;
+                return false;
+            }
+            config.num_accesses = std::stoul(argv[i]);
+            accesses_given = true;
+        }
+        else if (arg == "-r" || arg == "--range")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少地址范围参数" << std::endl;
+                return false;
+            }
+            config.address_range = std::stoul(argv[i]);
+        }
+        else if (arg == "-c" || arg == "--cores")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少核心数参数" << std::endl;
+                return false;
+            }
+            config.num_cores = std::stoul(argv[i]);
+        }
+        else if (arg == "-w" || arg == "--ws-period")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少工作集切换周期参数" << std::endl;
+                return false;
+            }
+            config.working_set_period = std::stoul(argv[i]);
+        }
+        else if (arg == "-v" || arg == "--ws-size")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少工作集大小参数" << std::endl;
+                return false;
+            }
+            config.working_set_size = std::stoul(argv[i]);
+        }
+        else if (arg == "--vm")
+        {
+            config.virtual_memory = true;
+        }
+        else if (arg == "--page-size")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少页大小参数" << std::endl;
+                return false;
+            }
+            config.virtual_memory = true;
+            config.vm_config.page_size = std::stoul(argv[i]);
+        }
+        else if (arg == "--tlb")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 TLB 参数" << std::endl;
+                return false;
+            }
+            config.virtual_memory = true;
+            if (!parseTlbLevels(argv[i], config.vm_config.tlb_levels))
+            {
+                return false;
+            }
+        }
+        else if (arg == "--pt-levels")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少页表级数参数" << std::endl;
+                return false;
+            }
+            config.virtual_memory = true;
+            config.vm_config.page_table_levels = std::stoul(argv[i]);
+        }
+        else if (arg == "--phys-mem")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少物理内存大小参数" << std::endl;
+                return false;
+            }
+            config.virtual_memory = true;
+            phys_mem = std::stoull(argv[i]);
+        }
+        else if (arg == "--page-replacement")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少页面置换算法参数" << std::endl;
+                return false;
+            }
+            config.virtual_memory = true;
+            std::string replacement = argv[i];
+            if (replacement == "clock")
+            {
+                config.vm_config.page_replacement = PageReplacement::Clock;
+            }
+            else if (replacement == "wsclock")
+            {
+                config.vm_config.page_replacement = PageReplacement::WSClock;
+            }
+            else if (replacement == "lru")
+            {
+                config.vm_config.page_replacement = PageReplacement::LRU;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的页面置换算法 '" << replacement << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--wsclock-window")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 WSClock 窗口参数" << std::endl;
+                return false;
+            }
+            config.virtual_memory = true;
+            config.vm_config.wsclock_window = std::stoul(argv[i]);
+        }
+        else if (arg == "--processes")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少进程数参数" << std::endl;
+                return false;
+            }
+            config.processes_per_core = std::stoul(argv[i]);
+        }
+        else if (arg == "--time-slice")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少时间片参数" << std::endl;
+                return false;
+            }
+            config.time_slice = std::stoul(argv[i]);
+        }
+        else if (arg == "--switch-flush")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少上下文切换缓存处理方式参数" << std::endl;
+                return false;
+            }
+            std::string flush = argv[i];
+            if (flush == "keep")
+            {
+                config.switch_flush = SwitchFlush::Keep;
+            }
+            else if (flush == "partial")
+            {
+                config.switch_flush = SwitchFlush::Partial;
+            }
+            else if (flush == "full")
+            {
+                config.switch_flush = SwitchFlush::Full;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的上下文切换缓存处理方式 '" << flush << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--asids")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少硬件 ASID 数参数" << std::endl;
+                return false;
+            }
+            config.hardware_asids = std::stoul(argv[i]);
+        }
+        else if (arg == "--process-workload")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少进程负载参数" << std::endl;
+                return false;
+            }
+            process_workload_specs.push_back(argv[i]);
+        }
+        else if (arg == "--way-masks")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少路掩码参数" << std::endl;
+                return false;
+            }
+            way_masks_spec = argv[i];
+        }
+        else if (arg == "--clos")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 CLOS 映射参数" << std::endl;
+                return false;
+            }
+            clos_spec = argv[i];
+        }
+        else if (arg == "--ucp")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 UCP 划分间隔参数" << std::endl;
+                return false;
+            }
+            config.ucp_interval = std::stoul(argv[i]);
+        }
+        else if (arg == "--refill-window")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少重新填充窗口参数" << std::endl;
+                return false;
+            }
+            config.refill_window = std::stoul(argv[i]);
+        }
+        else if (arg == "--page-cache")
+        {
+            config.page_cache = true;
+        }
+        else if (arg == "--io-trace")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 I/O trace 文件参数" << std::endl;
+                return false;
+            }
+            config.page_cache = true;
+            config.page_cache_config.io_trace = argv[i];
+        }
+        else if (arg == "--io-size")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少请求长度参数" << std::endl;
+                return false;
+            }
+            config.page_cache = true;
+            config.page_cache_config.io_size = std::stoul(argv[i]);
+        }
+        else if (arg == "--file-size")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少文件大小参数" << std::endl;
+                return false;
+            }
+            config.page_cache = true;
+            config.page_cache_config.file_size = std::stoul(argv[i]);
+        }
+        else if (arg == "--readahead")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少预读窗口参数" << std::endl;
+                return false;
+            }
+            config.page_cache = true;
+            config.page_cache_config.max_readahead = std::stoul(argv[i]);
+        }
+        else if (arg == "--flush-interval")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少定期回写间隔参数" << std::endl;
+                return false;
+            }
+            config.page_cache = true;
+            config.page_cache_config.flush_interval = std::stoul(argv[i]);
+        }
+        else if (arg == "--dirty-expire")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少脏页过期时长参数" << std::endl;
+                return false;
+            }
+            config.page_cache = true;
+            config.page_cache_config.dirty_expire = std::stoul(argv[i]);
+        }
+        else if (arg == "--sockets")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少插槽数参数" << std::endl;
+                return false;
+            }
+            config.numa_config.sockets = std::stoul(argv[i]);
+        }
+        else if (arg == "--numa-interleave")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少内存分布方式参数" << std::endl;
+                return false;
+            }
+            std::string interleave = argv[i];
+            if (interleave == "page")
+            {
+                config.numa_config.interleave = NumaInterleave::Page;
+            }
+            else if (interleave == "block")
+            {
+                config.numa_config.interleave = NumaInterleave::Block;
+            }
+            else if (interleave == "first-touch")
+            {
+                config.numa_config.interleave = NumaInterleave::FirstTouch;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的内存分布方式 '" << interleave << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--numa-page-size")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 NUMA 页大小参数" << std::endl;
+                return false;
+            }
+            config.numa_config.page_size = std::stoul(argv[i]);
+        }
+        else if (arg == "--numa-latency")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 NUMA 延迟参数" << std::endl;
+                return false;
+            }
+            if (!parseNumaLatency(argv[i], config.numa_config))
+            {
+                return false;
+            }
+        }
+        else if (arg == "--dram")
+        {
+            config.dram = true;
+        }
+        else if (arg == "--dram-channels")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 DRAM 通道数参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            config.dram_config.channels = std::stoul(argv[i]);
+        }
+        else if (arg == "--dram-ranks")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 DRAM rank 数参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            config.dram_config.ranks = std::stoul(argv[i]);
+        }
+        else if (arg == "--dram-banks")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 DRAM bank 数参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            config.dram_config.banks = std::stoul(argv[i]);
+        }
+        else if (arg == "--dram-row-size")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少行缓冲大小参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            config.dram_config.row_size = std::stoul(argv[i]);
+        }
+        else if (arg == "--dram-page")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少行缓冲策略参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            std::string policy = argv[i];
+            if (policy == "open")
+            {
+                config.dram_config.page_policy = PagePolicy::Open;
+            }
+            else if (policy == "closed")
+            {
+                config.dram_config.page_policy = PagePolicy::Closed;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的行缓冲策略 '" << policy << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--dram-mapping")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 DRAM 地址映射参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            std::string mapping = argv[i];
+            if (mapping == "row")
+            {
+                config.dram_config.mapping = DramMapping::Row;
+            }
+            else if (mapping == "block")
+            {
+                config.dram_config.mapping = DramMapping::Block;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的 DRAM 地址映射 '" << mapping << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--dram-timing")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 DRAM 时序参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            if (!parseDramTiming(argv[i], config.dram_config))
+            {
+                return false;
+            }
+        }
+        else if (arg == "--dram-queue")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 DRAM 队列深度参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            config.dram_config.queue_depth = std::stoul(argv[i]);
+        }
+        else if (arg == "--dram-clock")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少 DRAM 时钟频率参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            config.dram_config.clock_mhz = std::stod(argv[i]);
+        }
+        else if (arg == "--dram-interval")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少访问间隔参数" << std::endl;
+                return false;
+            }
+            config.dram = true;
+            config.dram_config.access_interval = std::stoul(argv[i]);
+        }
+        else if (arg == "--compression")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少压缩算法参数" << std::endl;
+                return false;
+            }
+            config.compression = true;
+            std::string algorithm = argv[i];
+            if (algorithm == "bdi")
+            {
+                config.compression_config.algorithm = CompressionAlgorithm::BDI;
+            }
+            else if (algorithm == "fpc")
+            {
+                config.compression_config.algorithm = CompressionAlgorithm::FPC;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的压缩算法 '" << algorithm << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--values")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少取值模型参数" << std::endl;
+                return false;
+            }
+            config.compression = true;
+            std::string model = argv[i];
+            if (model == "zero")
+            {
+                config.compression_config.value_model = ValueModel::Zero;
+            }
+            else if (model == "narrow")
+            {
+                config.compression_config.value_model = ValueModel::Narrow;
+            }
+            else if (model == "pointer")
+            {
+                config.compression_config.value_model = ValueModel::Pointer;
+            }
+            else if (model == "random")
+            {
+                config.compression_config.value_model = ValueModel::Random;
+            }
+            else if (model == "mixed")
+            {
+                config.compression_config.value_model = ValueModel::Mixed;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的取值模型 '" << model << "'" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--memory-image")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少内存映像文件参数" << std::endl;
+                return false;
+            }
+            config.compression = true;
+            config.compression_config.memory_image = argv[i];
+        }
+        else if (arg == "--compression-tags")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少标签倍数参数" << std::endl;
+                return false;
+            }
+            config.compression = true;
+            config.compression_config.tag_factor = std::stoul(argv[i]);
+        }
+        else if (arg == "--compression-segment")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少分配粒度参数" << std::endl;
+                return false;
+            }
+            config.compression = true;
+            config.compression_config.segment_size = std::stoul(argv[i]);
+        }
+        else if (arg == "--warmup")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少预热访问次数参数" << std::endl;
+                return false;
+            }
+            config.warmup_accesses = std::stoul(argv[i]);
+        }
+        else if (arg == "--load-checkpoint")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少检查点文件参数" << std::endl;
+                return false;
+            }
+            config.checkpoint_input = argv[i];
+        }
+        else if (arg == "--save-checkpoint")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少检查点文件参数" << std::endl;
+                return false;
+            }
+            config.checkpoint_output = argv[i];
+        }
+        else if (arg == "-j" || arg == "--json")
+        {
+            config.output_json = true;
+        }
+        else if (arg == "--sharing")
+        {
+            config.sharing_analysis = true;
+        }
+        else if (arg == "--sharing-top")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少报告块数参数" << std::endl;
+                return false;
+            }
+            config.sharing_analysis = true;
+            config.sharing_top_blocks = std::stoul(argv[i]);
+        }
+        else if (arg == "--reuse-distance")
+        {
+            config.reuse_distance = true;
+        }
+        else if (arg == "--reuse-max-blocks")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少复用距离跟踪块数参数" << std::endl;
+                return false;
+            }
+            config.reuse_max_blocks = std::stoul(argv[i]);
+        }
+        else if (arg == "--interval")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少区间统计间隔参数" << std::endl;
+                return false;
+            }
+            config.stats_interval = std::stoul(argv[i]);
+        }
+        else if (arg == "--interval-out")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少区间统计输出文件参数" << std::endl;
+                return false;
+            }
+            config.interval_output = argv[i];
+        }
+        else if (arg == "--set-heatmap")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少热力图输出文件参数" << std::endl;
+                return false;
+            }
+#ifdef CACHE_SIM_SET_STATS
+            config.set_heatmap_output = argv[i];
+#else
+            std::cerr << "错误: 按组统计未启用，请使用 -DENABLE_SET_STATS=ON 重新编译" << std::endl;
+            return false;
+#endif
+        }
+        else if (arg == "--interval-format")
+        {
+            if (++i >= argc)
+            {
+                std::cerr << "错误: 缺少区间统计格式参数" << std::endl;
+                return false;
+            }
+            std::string format = argv[i];
+            if (format == "jsonl")
+            {
+                config.interval_format = IntervalFormat::JsonLines;
+            }
+            else if (format == "csv")
+            {
+                config.interval_format = IntervalFormat::Csv;
+            }
+            else
+            {
+                std::cerr << "错误: 未知的区间统计格式 '" << format << "'" << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            std::cerr << "错误: 未知的选项 '" << arg << "'" << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    // 未指定写比例时使用访问模式的默认写比例（核心负载与进程负载由此继承）
+    if (!write_ratio_given)
+    {
+        config.write_ratio = defaultWriteRatio(config.access_pattern);
+    }
+
+    // 未指定种子时使用随机种子，种子会随结果输出以便复现
+    if (!seed_given)
+    {
+        config.seed = (static_cast<uint64_t>(std::random_device{}()) << 32) ^
+                      static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    // 检查 trace 格式，每个 trace 文件驱动一个核心
+    for (const std::string &path : config.trace_files)
+    {
+        if (config.trace_format == TraceFormat::Auto && guessTraceFormat(path) == TraceFormat::Auto)
+        {
+            std::cerr << "错误: 无法从文件名推断 '" << path << "' 的格式，请使用 --trace-format 指定" << std::endl;
+            return false;
+        }
+    }
+    if (!convert_output.empty() && config.trace_files.size() != 1)
+    {
+        std::cerr << "错误: --convert-trace 需要且只能指定一个 --trace 输入" << std::endl;
+        return false;
+    }
+    if (config.compare_protocols && (!config.checkpoint_input.empty() || !config.checkpoint_output.empty()))
+    {
+        std::cerr << "错误: --compare-protocols 不支持检查点" << std::endl;
+        return false;
+    }
+
+    // 虚拟内存参数
+    if (config.virtual_memory)
+    {
+        const VirtualMemoryConfig &vm = config.vm_config;
+        if (vm.page_size < 64 || (vm.page_size & (vm.page_size - 1)) != 0)
+        {
+            std::cerr << "错误: 页大小必须是不小于 64 的 2 的幂" << std::endl;
+            return false;
+        }
+        if (vm.page_table_levels == 0 || vm.page_table_levels > 8)
+        {
+            std::cerr << "错误: 页表级数必须在 1 到 8 之间" << std::endl;
+            return false;
+        }
+        if (!config.checkpoint_input.empty() || !config.checkpoint_output.empty())
+        {
+            // 检查点只保存缓存内容，不含页表与页框分配，恢复后物理地址不再对应
+            std::cerr << "错误: --vm 不支持检查点" << std::endl;
+            return false;
+        }
+        config.vm_config.physical_frames = phys_mem / vm.page_size;
+        if (phys_mem > 0 && config.vm_config.physical_frames == 0)
+        {
+            std::cerr << "错误: 物理内存小于一页" << std::endl;
+            return false;
+        }
+    }
+    // 多进程调度：进程编号作为 ASID 放在地址高位，也作为缓存行的所有者
+    if (config.processes_per_core == 0 || config.time_slice == 0 || config.hardware_asids == 0)
+    {
+        std::cerr << "错误: 进程数、时间片与硬件 ASID 数必须大于 0" << std::endl;
+        return false;
+    }
+    if (config.processes_per_core > 1)
+    {
+        if (!config.trace_files.empty() || config.compare_protocols || config.virtual_memory || config.page_cache)
+        {
+            std::cerr << "错误: 多进程调度不支持 --trace、--compare-protocols、--vm 与页缓存模式" << std::endl;
+            return false;
+        }
+        if (config.processes_per_core * static_cast<size_t>(config.num_cores) > std::numeric_limits<uint16_t>::max())
+        {
+            std::cerr << "错误: 进程总数过多" << std::endl;
+            return false;
+        }
+        // 稳态缺失率取自窗口之外的访问，窗口覆盖整个时间片时无从比较
+        if (config.refill_window >= config.time_slice)
+        {
+            config.refill_window = config.time_slice / 2;
+            std::cerr << "[Warning] 重新填充窗口不小于时间片，已改为时间片的一半（" << config.refill_window << "）。" << std::endl;
+        }
+    }
+
+    // 路划分：同一核心上的进程共享该核心的缓存，CLOS 随上下文切换装入
+    if (!way_masks_spec.empty() || !clos_spec.empty() || config.ucp_interval > 0)
+    {
+        size_t ways = config.cache_config.associativity;
+        if (config.processes_per_core < 2)
+        {
+            std::cerr << "错误: 路划分需要 --processes 大于 1（同一核心上的进程共享该核心的缓存）" << std::endl;
+            return false;
+        }
+        if (ways > 64 || config.cache_config.index_function == IndexFunction::Skewed)
+        {
+            std::cerr << "错误: 路划分要求关联度不超过 64 且不使用斜相联索引" << std::endl;
+            return false;
+        }
+        if (config.ucp_interval > 0 && (!way_masks_spec.empty() || !clos_spec.empty()))
+        {
+            std::cerr << "错误: --ucp 不能与 --way-masks 或 --clos 同时使用" << std::endl;
+            return false;
+        }
+        if (config.ucp_interval > 0 && ways < config.processes_per_core)
+        {
+            std::cerr << "错误: UCP 要求关联度不小于每核心进程数" << std::endl;
+            return false;
+        }
+        if (config.ucp_interval == 0)
+        {
+            if (way_masks_spec.empty())
+            {
+                std::cerr << "错误: --clos 需要同时指定 --way-masks" << std::endl;
+                return false;
+            }
+            if (!parsePartitions(way_masks_spec, clos_spec, config))
+            {
+                return false;
+            }
+            for (uint64_t mask : config.way_masks)
+            {
+                if (ways < 64 && (mask >> ways) != 0)
+                {
+                    std::cerr << "错误: 路掩码 0x" << std::hex << mask << std::dec << " 超出关联度 " << ways << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    // DRAM：地址按位拆分为通道、bank 与行，各项需为 2 的幂
+    if (config.dram)
+    {
+        const DramConfig &dram = config.dram_config;
+        if (config.compare_protocols || config.page_cache)
+        {
+            std::cerr << "错误: --dram 不支持 --compare-protocols 与页缓存模式" << std::endl;
+            return false;
+        }
+        auto power_of_two = [](size_t value)
+        { return value > 0 && (value & (value - 1)) == 0; };
+        if (!power_of_two(dram.channels) || !power_of_two(dram.ranks) || !power_of_two(dram.banks) || !power_of_two(dram.row_size) ||
+            !power_of_two(config.cache_config.block_size))
+        {
+            std::cerr << "错误: DRAM 通道数、rank 数、bank 数、行大小与块大小必须是 2 的幂" << std::endl;
+            return false;
+        }
+        if (dram.row_size < config.cache_config.block_size)
+        {
+            std::cerr << "错误: 行缓冲大小不能小于块大小" << std::endl;
+            return false;
+        }
+        if (dram.queue_depth == 0 || dram.t_burst == 0 || dram.clock_mhz <= 0.0)
+        {
+            std::cerr << "错误: DRAM 队列深度、突发周期与时钟频率必须大于 0" << std::endl;
+            return false;
+        }
+    }
+
+    // 分扇区：扇区位图为 64 位，受害者缓存项与检查点只记录整块的状态
+    size_t sector_size = config.cache_config.sector_size;
+    if (sector_size > 0)
+    {
+        size_t block_size = config.cache_config.block_size;
+        if ((sector_size & (sector_size - 1)) != 0 || (block_size & (block_size - 1)) != 0 || sector_size > block_size ||
+            block_size / sector_size > 64)
+        {
+            std::cerr << "错误: 扇区大小与块大小必须是 2 的幂，扇区不大于块且每块最多 64 个扇区" << std::endl;
+            return false;
+        }
+        if (config.cache_config.victim_cache_entries > 0 || config.page_cache ||
+            !config.checkpoint_input.empty() || !config.checkpoint_output.empty())
+        {
+            std::cerr << "错误: 分扇区缓存不支持 --victim-cache、页缓存模式与检查点" << std::endl;
+            return false;
+        }
+    }
+
+    // 压缩缓存：BDI 以 8 字节为最大元素，块按 2 的幂对齐存放
+    if (config.compression)
+    {
+        const CompressionConfig &compression = config.compression_config;
+        size_t block_size = config.cache_config.block_size;
+        if (config.compare_protocols || config.page_cache)
+        {
+            std::cerr << "错误: --compression 不支持 --compare-protocols 与页缓存模式" << std::endl;
+            return false;
+        }
+        if (block_size < 8 || (block_size & (block_size - 1)) != 0)
+        {
+            std::cerr << "错误: 压缩缓存的块大小必须是不小于 8 的 2 的幂" << std::endl;
+            return false;
+        }
+        if (compression.tag_factor == 0 || compression.segment_size == 0 || compression.segment_size > block_size)
+        {
+            std::cerr << "错误: 标签倍数必须大于 0，分配粒度必须在 1 到块大小之间" << std::endl;
+            return false;
+        }
+    }
+
+    // 页缓存模式：块即页，未指定时使用页缓存的默认几何参数
+    if (config.page_cache)
+    {
+        if (config.compare_protocols || config.virtual_memory || !config.trace_files.empty() ||
+            !config.checkpoint_input.empty() || !config.checkpoint_output.empty() || config.num_cores != 1)
+        {
+            std::cerr << "错误: 页缓存模式不支持 --compare-protocols、--vm、--trace、检查点与多核" << std::endl;
+            return false;
+        }
+        if (!size_given)
+        {
+            config.cache_config.cache_size = 64 << 20;
+        }
+        if (!block_given)
+        {
+            config.cache_config.block_size = 4096;
+        }
+        if (!assoc_given)
+        {
+            config.cache_config.associativity = 16;
+        }
+        if (!index_given)
+        {
+            config.cache_config.index_function = IndexFunction::XorFold;
+        }
+        size_t page_size = config.cache_config.block_size;
+        if (page_size == 0 || (page_size & (page_size - 1)) != 0)
+        {
+            std::cerr << "错误: 页大小必须是 2 的幂" << std::endl;
+            return false;
+        }
+        if (config.page_cache_config.file_size < page_size)
+        {
+            std::cerr << "错误: 文件大小不能小于一页" << std::endl;
+            return false;
+        }
+        // 使用 I/O trace 且未指定请求数时运行到 trace 结束
+        if (!config.page_cache_config.io_trace.empty() && !accesses_given)
+        {
+            config.num_accesses = std::numeric_limits<size_t>::max();
+        }
+    }
+    if (config.trace_files.size() > static_cast<size_t>(config.num_cores))
+    {
+        config.num_cores = static_cast<int>(config.trace_files.size());
+    }
+    // 多插槽：每个插槽的核心数相同，目录以位图记录持有副本的插槽
+    const NumaConfig &numa = config.numa_config;
+    if (numa.sockets == 0 || numa.sockets > 64 || config.num_cores % numa.sockets != 0)
+    {
+        std::cerr << "错误: 插槽数必须在 1 到 64 之间且能整除核心数" << std::endl;
+        return false;
+    }
+    if (numa.page_size == 0 || (numa.page_size & (numa.page_size - 1)) != 0)
+    {
+        std::cerr << "错误: NUMA 页大小必须是 2 的幂" << std::endl;
+        return false;
+    }
+    if (numa.sockets > 1)
+    {
+        // 检查点不含目录，恢复后目录不知道各插槽持有的副本
+        if (config.dram || config.page_cache || !config.checkpoint_input.empty() || !config.checkpoint_output.empty())
+        {
+            std::cerr << "错误: 多插槽不支持 --dram、页缓存模式与检查点" << std::endl;
+            return false;
+        }
+    }
+    // 使用 trace 且未指定访问次数时运行到 trace 结束
+    if (!config.trace_files.empty() && !accesses_given)
+    {
+        config.num_accesses = std::numeric_limits<size_t>::max();
+    }
+
+    if (!validateKeyValueParams(config.zipf_theta, config.hot_fraction, config.hot_access))
+    {
+        return false;
+    }
+
+    if (!core_workload_specs.empty())
+    {
+        config.core_workloads.assign(config.num_cores, config.defaultWorkload());
+        for (const std::string &spec : core_workload_specs)
+        {
+            if (!parseCoreWorkload(spec, config, write_ratio_given))
+            {
+                return false;
+            }
+        }
+    }
+    if (!process_workload_specs.empty())
+    {
+        if (config.processes_per_core < 2)
+        {
+            std::cerr << "错误: --process-workload 需要 --processes 大于 1" << std::endl;
+            return false;
+        }
+        config.process_workloads.assign(config.processes_per_core, config.defaultWorkload());
+        for (const std::string &spec : process_workload_specs)
+        {
+            if (!parseProcessWorkload(spec, config, write_ratio_given))
+            {
+                return false;
+            }
+        }
+    }
+
+    // 未指定区间统计输出文件时按格式选择默认文件名
+    if (config.stats_interval > 0 && config.interval_output.empty())
+    {
+        config.interval_output = "intervals." + IntervalRecorder::getFormatName(config.interval_format);
+    }
+    return true;
+}
+
+/**
+ * @brief 将 trace 转换为压缩格式
+ * @param config 配置（使用其中唯一的 trace 文件与格式）
+ * @param output 输出文件
+ * @return 是否转换成功
+ */
+bool convertTrace(const SimulatorConfig &config, const std::string &output)
+{
+    const std::string &input = config.trace_files[0];
+    std::unique_ptr<TraceReader> reader = openTrace(input, config.trace_format, config.trace_threads);
+    if (!reader)
+    {
+        std::cerr << "错误: 无法读取 trace 文件 '" << input << "'" << std::endl;
+        return false;
+    }
+
+    NativeTraceWriter writer(output);
+    if (!writer.ok())
+    {
+        std::cerr << "错误: 无法创建输出文件 '" << output << "'" << std::endl;
+        return false;
+    }
+
+    std::vector<TraceRecord> batch(1 << 16);
+    size_t count;
+    while ((count = reader->read(batch.data(), batch.size())) > 0)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!writer.add(batch[i]))
+            {
+                std::cerr << "错误: 地址 0x" << std::hex << batch[i].address << std::dec << " 超出压缩格式支持的范围" << std::endl;
+                return false;
+            }
+        }
+    }
+    if (!writer.close())
+    {
+        std::cerr << "错误: 写入输出文件 '" << output << "' 失败" << std::endl;
+        return false;
+    }
+
+    std::cout << "已转换 " << writer.records() << " 条访问记录，输出 " << writer.bytesWritten() << " 字节";
+    if (writer.records() > 0)
+    {
+        std::cout << "（平均每条 " << std::fixed << std::setprecision(2)
+                  << static_cast<double>(writer.bytesWritten()) / writer.records() << " 字节）";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
 #endif
 
     SimulatorConfig config;
+    std::string convert_output;
 
-    if (!parseArguments(argc, argv, config))
+    if (!parseArguments(argc, argv, config, convert_output))
     {
         return (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help")) ? 0 : 1;
     }
 
+    if (!convert_output.empty())
+    {
+        return convertTrace(config, convert_output) ? 0 : 1;
+    }
+
+    if (config.page_cache)
+    {
+        return CacheSimulator::runPageCache(config) ? 0 : 1;
+    }
+
+    if (config.compare_protocols)
+    {
+        return CacheSimulator::compareProtocols(config) ? 0 : 1;
+    }
+
     CacheSimulator simulator(config);
+    if (!simulator.ok())
+    {
+        return 1;
+    }
+    if (!config.checkpoint_input.empty() && !simulator.loadCheckpoint(config.checkpoint_input))
+    {
+        std::cerr << "错误: 无法从检查点 '" << config.checkpoint_input << "' 恢复缓存状态" << std::endl;
+        return 1;
+    }
     simulator.run();
+    if (!config.checkpoint_output.empty() && !simulator.saveCheckpoint(config.checkpoint_output))
+    {
+        return 1;
+    }
     simulator.printResults();
 
     return 0;
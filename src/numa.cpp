@@ -0,0 +1,136 @@
+#include "numa.h"
+
+namespace cache_sim
+{
+    Interconnect::Interconnect(const NumaConfig &config, size_t block_size)
+        : config_(config), stats_(config.sockets)
+    {
+        // 块大小与页大小均为 2 的幂（由参数解析保证）
+        block_bits_ = static_cast<size_t>(__builtin_ctzll(block_size));
+        page_bits_ = static_cast<size_t>(__builtin_ctzll(config_.page_size));
+    }
+
+    void Interconnect::attach(Bus *bus)
+    {
+        bus->setInterconnect(this, buses_.size());
+        buses_.push_back(bus);
+    }
+
+    size_t Interconnect::homeOf(uint64_t address, size_t requester)
+    {
+        switch (config_.interleave)
+        {
+        case NumaInterleave::Block:
+            return static_cast<size_t>((address >> block_bits_) % config_.sockets);
+        case NumaInterleave::FirstTouch:
+            return first_touch_.emplace(address >> page_bits_, requester).first->second;
+        case NumaInterleave::Page:
+        default:
+            return static_cast<size_t>((address >> page_bits_) % config_.sockets);
+        }
+    }
+
+    void Interconnect::request(size_t socket, int sender_id, uint64_t address, BusEvent event, BusResponse &response)
+    {
+        NumaSocketStats &stats = stats_[socket];
+        uint64_t self = uint64_t(1) << socket;
+        bool local_supplied = response.supplied;
+        uint64_t &sharers = directory_[address >> block_bits_];
+
+        // 读请求已由本插槽满足时不必访问其他插槽；写请求需作废其他插槽的全部副本
+        uint64_t pending = sharers & ~self;
+        if (pending != 0 && (event != BusEvent::BusRd || !local_supplied))
+        {
+            while (pending != 0)
+            {
+                size_t remote = static_cast<size_t>(__builtin_ctzll(pending));
+                uint64_t bit = uint64_t(1) << remote;
+                pending &= pending - 1;
+
+                BusResponse result = buses_[remote]->snoopRemote(sender_id, address, event);
+                if (!result.shared)
+                {
+                    // 该插槽的副本已被静默驱逐
+                    stats.stale_sharers++;
+                    sharers &= ~bit;
+                    continue;
+                }
+                response.shared = true;
+                response.supplied = response.supplied || result.supplied;
+                if (event != BusEvent::BusRd)
+                {
+                    stats.remote_invalidations++;
+                }
+            }
+        }
+
+        // 读请求加入共享者，写请求之后只有本插槽持有副本
+        sharers = event == BusEvent::BusRd ? (sharers | self) : self;
+
+        // 升级请求不需要数据
+        if (event == BusEvent::BusUpgr)
+        {
+            return;
+        }
+        if (local_supplied)
+        {
+            stats.local_transfers++;
+        }
+        else if (response.supplied)
+        {
+            stats.remote_cache_hits++;
+        }
+        else if (homeOf(address, socket) == socket)
+        {
+            stats.local_memory++;
+        }
+        else
+        {
+            stats.remote_memory++;
+        }
+    }
+
+    void Interconnect::writeBack(size_t socket, uint64_t address)
+    {
+        if (homeOf(address, socket) != socket)
+        {
+            stats_[socket].remote_writebacks++;
+        }
+    }
+
+    double Interconnect::averageMissLatency(size_t socket) const
+    {
+        const NumaSocketStats &stats = stats_[socket];
+        uint64_t misses = stats.local_transfers + stats.remote_cache_hits + stats.local_memory + stats.remote_memory;
+        if (misses == 0)
+        {
+            return 0.0;
+        }
+        double cycles = static_cast<double>(stats.local_transfers) * config_.local_cache_latency +
+                        static_cast<double>(stats.remote_cache_hits) * config_.remote_cache_latency +
+                        static_cast<double>(stats.local_memory) * config_.local_memory_latency +
+                        static_cast<double>(stats.remote_memory) * config_.remote_memory_latency;
+        return cycles / misses;
+    }
+
+    void Interconnect::resetStats()
+    {
+        stats_.assign(config_.sockets, NumaSocketStats());
+    }
+
+    std::string Interconnect::getInterleaveName(NumaInterleave interleave)
+    {
+        switch (interleave)
+        {
+        case NumaInterleave::Page:
+            return "按页交织";
+        case NumaInterleave::Block:
+            return "按块交织";
+        case NumaInterleave::FirstTouch:
+            return "首次访问";
+        default:
+            return "未知分布";
+        }
+    }
+
+} // namespace cache_sim
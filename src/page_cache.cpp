@@ -0,0 +1,340 @@
+#include "page_cache.h"
+#include "lru_cache.h"
+#include "lfu_cache.h"
+
+namespace cache_sim
+{
+    const size_t PageCache::kFileShift;
+    const uint64_t PageCache::kMaxFileId;
+
+    namespace
+    {
+        uint64_t roundUpPow2(uint64_t value)
+        {
+            uint64_t result = 1;
+            while (result < value)
+            {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        // 初始预读窗口：小请求放大 4 倍，中等请求放大 2 倍，不超过上限
+        uint64_t initialWindow(uint64_t request_pages, uint64_t max_pages)
+        {
+            uint64_t size = roundUpPow2(request_pages);
+            if (size <= max_pages / 32)
+            {
+                return size * 4;
+            }
+            if (size <= max_pages / 4)
+            {
+                return size * 2;
+            }
+            return max_pages;
+        }
+
+        // 下一个预读窗口：小窗口增长 4 倍，较大窗口增长 2 倍，不超过上限
+        uint64_t nextWindow(uint64_t size, uint64_t max_pages)
+        {
+            if (size < max_pages / 16)
+            {
+                return size * 4;
+            }
+            if (size <= max_pages / 2)
+            {
+                return size * 2;
+            }
+            return max_pages;
+        }
+    } // namespace
+
+    PageCache::PageCache(const CacheConfig &cache_config, ReplacementPolicy policy, const PageCacheConfig &config)
+        : config_(config)
+    {
+        if (policy == ReplacementPolicy::LFU)
+        {
+            cache_ = std::make_unique<LFUCache>(cache_config);
+        }
+        else
+        {
+            cache_ = std::make_unique<LRUCache>(cache_config);
+        }
+        cache_->setEvictionLog(&evicted_);
+        page_bits_ = static_cast<size_t>(__builtin_ctzll(cache_config.block_size));
+    }
+
+    bool PageCache::access(const IoRequest &request)
+    {
+        uint64_t file_limit = uint64_t(1) << kFileShift;
+        if (request.file_id >= kMaxFileId || request.offset >= file_limit || request.length > file_limit - request.offset)
+        {
+            return false;
+        }
+
+        ++now_;
+        stats_.requests++;
+        if (request.is_write)
+        {
+            stats_.write_requests++;
+            stats_.write_bytes += request.length;
+        }
+        else
+        {
+            stats_.read_requests++;
+            stats_.read_bytes += request.length;
+        }
+
+        if (request.length > 0)
+        {
+            uint64_t page_size = uint64_t(1) << page_bits_;
+            uint64_t first = request.offset >> page_bits_;
+            uint64_t last = (request.offset + request.length - 1) >> page_bits_;
+            for (uint64_t page = first; page <= last; ++page)
+            {
+                if (request.is_write)
+                {
+                    // 未覆盖整页的写缺失需要先读入该页
+                    uint64_t start = page << page_bits_;
+                    bool full_page = start >= request.offset && start + page_size <= request.offset + request.length;
+                    writePage(request.file_id, page, full_page);
+                }
+                else
+                {
+                    readPage(request.file_id, page, last - page + 1);
+                }
+            }
+        }
+
+        if (config_.flush_interval > 0 && now_ % config_.flush_interval == 0)
+        {
+            flushExpired();
+        }
+        return true;
+    }
+
+    void PageCache::readPage(uint64_t file_id, uint64_t page, uint64_t request_pages)
+    {
+        uint64_t address = pageAddress(file_id, page);
+        bool marked = markers_.erase(address) > 0;
+
+        bool hit = cache_->read(address);
+        dropEvicted();
+        if (hit)
+        {
+            if (readahead_unused_.erase(address) > 0)
+            {
+                stats_.readahead_hits++;
+            }
+            if (marked && config_.max_readahead > 0)
+            {
+                asyncReadahead(file_id);
+            }
+        }
+        else
+        {
+            // 按需读入：此前的预读副本（若有）已在使用前被驱逐，页现在是干净的
+            stats_.disk_reads++;
+            readahead_unused_.erase(address);
+            dirty_since_.erase(address);
+            if (config_.max_readahead > 0)
+            {
+                syncReadahead(file_id, page, request_pages);
+            }
+        }
+
+        readahead_[file_id].prev_page = page;
+    }
+
+    void PageCache::writePage(uint64_t file_id, uint64_t page, bool full_page)
+    {
+        uint64_t address = pageAddress(file_id, page);
+        bool hit = cache_->write(address, 0);
+        dropEvicted();
+        if (hit)
+        {
+            if (readahead_unused_.erase(address) > 0)
+            {
+                stats_.readahead_hits++;
+            }
+        }
+        else
+        {
+            readahead_unused_.erase(address);
+            if (!full_page)
+            {
+                stats_.partial_writes++;
+                stats_.disk_reads++;
+            }
+        }
+
+        // 新装入的页从本次写入开始计算变脏时间，已脏的页保持原时间
+        auto entry = dirty_since_.emplace(address, now_);
+        if (entry.second || !hit)
+        {
+            entry.first->second = now_;
+            if (config_.flush_interval > 0)
+            {
+                dirty_queue_.emplace_back(address, now_);
+            }
+        }
+    }
+
+    void PageCache::syncReadahead(uint64_t file_id, uint64_t page, uint64_t request_pages)
+    {
+        Readahead &ra = readahead_[file_id];
+        uint64_t max_pages = config_.max_readahead;
+
+        // 文件开头、超大请求或紧接上一次访问的缺页视为顺序读，其余为随机读，只读入请求的页
+        bool sequential = page == 0 || request_pages > max_pages || page == ra.prev_page || page == ra.prev_page + 1;
+        if (!sequential)
+        {
+            return;
+        }
+
+        ra.start = page;
+        ra.size = initialWindow(std::min(request_pages, max_pages), max_pages);
+        ra.async_size = ra.size > request_pages ? ra.size - request_pages : ra.size;
+
+        // 同步窗口与下一个异步窗口合并提交
+        if (ra.size == ra.async_size)
+        {
+            uint64_t add = nextWindow(ra.size, max_pages);
+            if (ra.size + add <= max_pages)
+            {
+                ra.async_size = add;
+                ra.size += add;
+            }
+            else
+            {
+                ra.size = max_pages;
+                ra.async_size = max_pages / 2;
+            }
+        }
+        submitReadahead(file_id, ra);
+    }
+
+    void PageCache::asyncReadahead(uint64_t file_id)
+    {
+        // 顺序读走到了预读标记：紧接当前窗口预读下一个更大的窗口
+        Readahead &ra = readahead_[file_id];
+        ra.start += ra.size;
+        ra.size = nextWindow(ra.size, config_.max_readahead);
+        ra.async_size = ra.size;
+        submitReadahead(file_id, ra);
+    }
+
+    void PageCache::submitReadahead(uint64_t file_id, const Readahead &ra)
+    {
+        stats_.readahead_windows++;
+        for (uint64_t page = ra.start; page < ra.start + ra.size; ++page)
+        {
+            uint64_t address = pageAddress(file_id, page);
+            if (cache_->prefetch(address))
+            {
+                stats_.readahead_pages++;
+                stats_.disk_reads++;
+                readahead_unused_.insert(address);
+                dirty_since_.erase(address);
+            }
+            dropEvicted();
+        }
+
+        // 窗口中倒数第 async_size 页带标记，读到它时发起下一次异步预读（该页已在预读中被驱逐时不加标记）
+        if (ra.async_size > 0 && ra.async_size <= ra.size)
+        {
+            uint64_t marker = pageAddress(file_id, ra.start + ra.size - ra.async_size);
+            if (cache_->findLine(marker) != nullptr)
+            {
+                markers_.insert(marker);
+            }
+        }
+    }
+
+    void PageCache::flushExpired()
+    {
+        while (!dirty_queue_.empty() && dirty_queue_.front().second + config_.dirty_expire <= now_)
+        {
+            std::pair<uint64_t, uint64_t> entry = dirty_queue_.front();
+            dirty_queue_.pop_front();
+
+            // 队列中可能有页重新装入后留下的过期项
+            auto it = dirty_since_.find(entry.first);
+            if (it == dirty_since_.end() || it->second != entry.second)
+            {
+                continue;
+            }
+            dirty_since_.erase(it);
+            if (cache_->clean(entry.first))
+            {
+                stats_.flushed_pages++;
+            }
+        }
+    }
+
+    void PageCache::dropEvicted()
+    {
+        for (uint64_t address : evicted_)
+        {
+            dirty_since_.erase(address);
+            readahead_unused_.erase(address);
+            markers_.erase(address);
+        }
+        evicted_.clear();
+    }
+
+    size_t PageCache::dirtyPages() const
+    {
+        size_t count = 0;
+        for (const auto &entry : dirty_since_)
+        {
+            CacheLine *line = cache_->findLine(entry.first);
+            if (line != nullptr && line->dirty)
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    void PageCache::resetStats()
+    {
+        stats_ = PageCacheStats();
+        cache_->resetStats();
+    }
+
+    bool parseIoRequest(const std::string &line, IoRequest &request)
+    {
+        std::istringstream fields(line);
+        std::string file_id, offset, length, op;
+        if (!(fields >> file_id >> offset >> length >> op))
+        {
+            return false;
+        }
+        try
+        {
+            request.file_id = std::stoull(file_id, nullptr, 0);
+            request.offset = std::stoull(offset, nullptr, 0);
+            request.length = std::stoull(length, nullptr, 0);
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+
+        if (op == "R" || op == "r" || op == "read")
+        {
+            request.is_write = false;
+        }
+        else if (op == "W" || op == "w" || op == "write")
+        {
+            request.is_write = true;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+} // namespace cache_sim
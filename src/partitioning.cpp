@@ -0,0 +1,104 @@
+#include "partitioning.h"
+
+namespace cache_sim
+{
+    UtilityMonitor::UtilityMonitor(size_t num_sets, size_t ways, size_t block_size, size_t sample_stride)
+        : ways_(ways), position_hits_(ways, 0)
+    {
+        block_bits_ = static_cast<size_t>(__builtin_ctzll(block_size));
+        sample_stride_ = std::max<size_t>(1, std::min(sample_stride, num_sets));
+        tags_.resize((num_sets + sample_stride_ - 1) / sample_stride_);
+    }
+
+    void UtilityMonitor::access(size_t set_index, uint64_t address)
+    {
+        if (set_index % sample_stride_ != 0)
+        {
+            return;
+        }
+
+        std::vector<uint64_t> &stack = tags_[set_index / sample_stride_];
+        uint64_t block = address >> block_bits_;
+        auto it = std::find(stack.begin(), stack.end(), block);
+        if (it != stack.end())
+        {
+            position_hits_[it - stack.begin()]++;
+            stack.erase(it);
+        }
+        else if (stack.size() == ways_)
+        {
+            stack.pop_back();
+        }
+        stack.insert(stack.begin(), block);
+    }
+
+    uint64_t UtilityMonitor::hitsWithWays(size_t ways) const
+    {
+        ways = std::min(ways, ways_);
+        return std::accumulate(position_hits_.begin(), position_hits_.begin() + ways, uint64_t(0));
+    }
+
+    void UtilityMonitor::decay()
+    {
+        for (uint64_t &hits : position_hits_)
+        {
+            hits /= 2;
+        }
+    }
+
+    std::vector<size_t> lookaheadPartition(const std::vector<const UtilityMonitor *> &monitors, size_t ways)
+    {
+        size_t n = monitors.size();
+        std::vector<size_t> allocation(n, 1);
+        size_t balance = ways > n ? ways - n : 0;
+
+        while (balance > 0)
+        {
+            // 每个分区找出使每路平均收益最大的增量，再取收益最大的分区
+            size_t winner = 0;
+            size_t winner_ways = 1;
+            double winner_utility = -1.0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                uint64_t base = monitors[i]->hitsWithWays(allocation[i]);
+                for (size_t k = 1; k <= balance; ++k)
+                {
+                    double utility = static_cast<double>(monitors[i]->hitsWithWays(allocation[i] + k) - base) / k;
+                    if (utility > winner_utility)
+                    {
+                        winner = i;
+                        winner_ways = k;
+                        winner_utility = utility;
+                    }
+                }
+            }
+            allocation[winner] += winner_ways;
+            balance -= winner_ways;
+        }
+        return allocation;
+    }
+
+    std::vector<uint64_t> contiguousWayMasks(const std::vector<size_t> &allocation)
+    {
+        std::vector<uint64_t> masks;
+        size_t start = 0;
+        for (size_t ways : allocation)
+        {
+            uint64_t bits = ways >= 64 ? ~uint64_t(0) : (uint64_t(1) << ways) - 1;
+            masks.push_back(bits << start);
+            start += ways;
+        }
+        return masks;
+    }
+
+    bool isContiguousMask(uint64_t mask)
+    {
+        if (mask == 0)
+        {
+            return false;
+        }
+        uint64_t shifted = mask >> __builtin_ctzll(mask);
+        return (shifted & (shifted + 1)) == 0;
+    }
+
+} // namespace cache_sim
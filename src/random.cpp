@@ -0,0 +1,83 @@
+#include "random.h"
+
+namespace cache_sim
+{
+    constexpr size_t Xoshiro256::kLanes;
+
+    namespace
+    {
+        // SplitMix64，用于把种子扩展为 xoshiro 的初始状态
+        uint64_t splitMix64(uint64_t &state)
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        inline uint64_t rotl(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+    }
+
+    Xoshiro256::Xoshiro256(uint64_t seed, uint64_t stream)
+        : lane_(kLanes)
+    {
+        uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+        for (size_t lane = 0; lane < kLanes; ++lane)
+        {
+            s0_[lane] = splitMix64(state);
+            s1_[lane] = splitMix64(state);
+            s2_[lane] = splitMix64(state);
+            s3_[lane] = splitMix64(state);
+        }
+    }
+
+    void Xoshiro256::step(uint64_t *out)
+    {
+        for (size_t lane = 0; lane < kLanes; ++lane)
+        {
+            out[lane] = rotl(s1_[lane] * 5, 7) * 9;
+
+            uint64_t t = s1_[lane] << 17;
+            s2_[lane] ^= s0_[lane];
+            s3_[lane] ^= s1_[lane];
+            s1_[lane] ^= s2_[lane];
+            s0_[lane] ^= s3_[lane];
+            s2_[lane] ^= t;
+            s3_[lane] = rotl(s3_[lane], 45);
+        }
+    }
+
+    void Xoshiro256::fill(uint64_t *out, size_t count)
+    {
+        size_t i = 0;
+
+        // 先取完上次剩余的缓冲，保持与逐个取数相同的序列
+        while (i < count && lane_ < kLanes)
+        {
+            out[i++] = buffer_[lane_++];
+        }
+
+        for (; i + kLanes <= count; i += kLanes)
+        {
+            step(out + i);
+        }
+
+        while (i < count)
+        {
+            out[i++] = (*this)();
+        }
+    }
+
+    void Xoshiro256::fillBounded(uint64_t *out, size_t count, uint64_t range)
+    {
+        fill(out, count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = scale(out[i], range);
+        }
+    }
+
+} // namespace cache_sim
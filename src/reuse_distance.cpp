@@ -0,0 +1,170 @@
+#include "reuse_distance.h"
+
+namespace cache_sim
+{
+    namespace
+    {
+        // Fenwick 树的初始容量（时间槽数量）
+        const uint64_t kInitialCapacity = 1024;
+
+        // 计算分桶下标
+        size_t binIndex(uint64_t distance)
+        {
+            if (distance == 0)
+            {
+                return 0;
+            }
+            return static_cast<size_t>(64 - __builtin_clzll(distance));
+        }
+    } // namespace
+
+    void ReuseHistogram::add(uint64_t distance)
+    {
+        size_t bin = binIndex(distance);
+        if (bins.size() <= bin)
+        {
+            bins.resize(bin + 1, 0);
+        }
+        bins[bin]++;
+        total++;
+    }
+
+    void ReuseHistogram::addCold()
+    {
+        cold++;
+        total++;
+    }
+
+    uint64_t ReuseHistogram::binLowerBound(size_t bin)
+    {
+        return bin == 0 ? 0 : (uint64_t(1) << (bin - 1));
+    }
+
+    uint64_t ReuseHistogram::binUpperBound(size_t bin)
+    {
+        return bin == 0 ? 0 : (uint64_t(1) << (bin - 1)) * 2 - 1;
+    }
+
+    void ReuseHistogram::writeJson(std::ostream &os, const std::string &indent) const
+    {
+        os << "{\n"
+           << indent << "  \"total\": " << total << ",\n"
+           << indent << "  \"cold\": " << cold << ",\n"
+           << indent << "  \"bins\": [";
+        for (size_t i = 0; i < bins.size(); ++i)
+        {
+            os << (i == 0 ? "\n" : ",\n")
+               << indent << "    {\"min\": " << binLowerBound(i)
+               << ", \"max\": " << binUpperBound(i)
+               << ", \"count\": " << bins[i] << "}";
+        }
+        os << (bins.empty() ? "]\n" : "\n" + indent + "  ]\n")
+           << indent << "}";
+    }
+
+    constexpr uint64_t ReuseDistanceProfiler::kColdDistance;
+
+    ReuseDistanceProfiler::ReuseDistanceProfiler(size_t block_size, size_t max_tracked_blocks)
+        : block_bits_(static_cast<size_t>(std::log2(block_size))),
+          max_tracked_blocks_(std::max<size_t>(max_tracked_blocks, 1)),
+          tree_(kInitialCapacity + 1, 0),
+          next_slot_(1)
+    {
+    }
+
+    void ReuseDistanceProfiler::treeAdd(uint64_t slot, int delta)
+    {
+        for (; slot < tree_.size(); slot += slot & (~slot + 1))
+        {
+            tree_[slot] += delta;
+        }
+    }
+
+    uint64_t ReuseDistanceProfiler::treePrefix(uint64_t slot) const
+    {
+        uint64_t sum = 0;
+        for (; slot > 0; slot -= slot & (~slot + 1))
+        {
+            sum += tree_[slot];
+        }
+        return sum;
+    }
+
+    uint64_t ReuseDistanceProfiler::access(uint64_t address)
+    {
+        if (next_slot_ >= tree_.size())
+        {
+            compact();
+        }
+
+        uint64_t block = address >> block_bits_;
+        uint64_t slot = next_slot_++;
+        uint64_t distance = kColdDistance;
+
+        auto it = last_slot_.find(block);
+        if (it != last_slot_.end())
+        {
+            // 上次访问之后仍存活的块数即为复用距离
+            distance = last_slot_.size() - treePrefix(it->second);
+            treeAdd(it->second, -1);
+            it->second = slot;
+            histogram_.add(distance);
+        }
+        else
+        {
+            last_slot_.emplace(block, slot);
+            histogram_.addCold();
+        }
+
+        treeAdd(slot, 1);
+        return distance;
+    }
+
+    void ReuseDistanceProfiler::compact()
+    {
+        // 按最后访问时间排序所有存活的块
+        std::vector<std::pair<uint64_t, uint64_t>> live;
+        live.reserve(last_slot_.size());
+        for (const auto &entry : last_slot_)
+        {
+            live.emplace_back(entry.second, entry.first);
+        }
+        std::sort(live.begin(), live.end());
+
+        // 超出跟踪上限时丢弃最久未访问的块
+        size_t drop = live.size() > max_tracked_blocks_ ? live.size() - max_tracked_blocks_ : 0;
+        for (size_t i = 0; i < drop; ++i)
+        {
+            last_slot_.erase(live[i].second);
+        }
+
+        // 新容量至少为存活块数的两倍，且不超过跟踪上限的两倍
+        size_t kept = live.size() - drop;
+        uint64_t capacity = std::max<uint64_t>(kInitialCapacity, 2 * kept);
+        capacity = std::min<uint64_t>(capacity, std::max<uint64_t>(kInitialCapacity, 2 * max_tracked_blocks_));
+
+        // 重新编号并以 O(n) 方式重建 Fenwick 树
+        tree_.assign(capacity + 1, 0);
+        for (size_t i = 0; i < kept; ++i)
+        {
+            uint64_t slot = i + 1;
+            last_slot_[live[drop + i].second] = slot;
+            tree_[slot] += 1;
+            uint64_t parent = slot + (slot & (~slot + 1));
+            if (parent <= capacity)
+            {
+                tree_[parent] += tree_[slot];
+            }
+        }
+        for (uint64_t slot = kept + 1; slot <= capacity; ++slot)
+        {
+            uint64_t parent = slot + (slot & (~slot + 1));
+            if (parent <= capacity)
+            {
+                tree_[parent] += tree_[slot];
+            }
+        }
+        next_slot_ = kept + 1;
+    }
+
+} // namespace cache_sim
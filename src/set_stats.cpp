@@ -0,0 +1,104 @@
+#include "set_stats.h"
+
+namespace cache_sim
+{
+    SkewSummary computeSkew(const std::vector<uint64_t> &counts)
+    {
+        SkewSummary summary;
+        if (counts.empty())
+        {
+            return summary;
+        }
+
+        std::vector<uint64_t> sorted(counts);
+        std::sort(sorted.begin(), sorted.end());
+
+        // 基尼系数: G = 2 * sum(i * x_i) / (n * sum(x)) - (n + 1) / n，其中 x 升序、i 从 1 开始
+        double n = static_cast<double>(sorted.size());
+        double sum = 0.0;
+        double weighted_sum = 0.0;
+        for (size_t i = 0; i < sorted.size(); ++i)
+        {
+            sum += static_cast<double>(sorted[i]);
+            weighted_sum += static_cast<double>(i + 1) * static_cast<double>(sorted[i]);
+        }
+
+        summary.max = sorted.back();
+        summary.mean = sum / n;
+        if (sum > 0.0)
+        {
+            summary.max_mean_ratio = static_cast<double>(summary.max) / summary.mean;
+            summary.gini = 2.0 * weighted_sum / (n * sum) - (n + 1.0) / n;
+        }
+        return summary;
+    }
+
+    SkewSummary computeSkew(const std::vector<SetStats> &sets, uint64_t SetStats::*field)
+    {
+        std::vector<uint64_t> counts;
+        counts.reserve(sets.size());
+        for (const auto &set : sets)
+        {
+            counts.push_back(set.*field);
+        }
+        return computeSkew(counts);
+    }
+
+    SamplingEstimate estimateFromSample(const std::vector<SetStats> &sampled, size_t total_sets, uint64_t total_accesses)
+    {
+        SamplingEstimate estimate;
+        estimate.sampled_sets = sampled.size();
+        estimate.total_sets = total_sets;
+        estimate.total_accesses = total_accesses;
+
+        uint64_t misses = 0;
+        for (const auto &set : sampled)
+        {
+            estimate.sampled_accesses += set.accesses;
+            misses += set.misses;
+        }
+        if (estimate.sampled_accesses == 0)
+        {
+            estimate.miss_rate_ci = 1.0;
+            return estimate;
+        }
+        estimate.miss_rate = static_cast<double>(misses) / estimate.sampled_accesses;
+
+        // 全部组都被采样时没有抽样误差；只有一组时无法估计方差
+        double n = static_cast<double>(sampled.size());
+        double population = static_cast<double>(std::max(total_sets, sampled.size()));
+        if (sampled.size() == total_sets)
+        {
+            return estimate;
+        }
+        if (sampled.size() < 2)
+        {
+            estimate.miss_rate_ci = 1.0;
+            return estimate;
+        }
+
+        // Var(r) = (1 - n/N) * sum((m_i - r * a_i)^2) / (n - 1) / (n * mean(a)^2)
+        double residual = 0.0;
+        for (const auto &set : sampled)
+        {
+            double d = static_cast<double>(set.misses) - estimate.miss_rate * static_cast<double>(set.accesses);
+            residual += d * d;
+        }
+        double mean_accesses = static_cast<double>(estimate.sampled_accesses) / n;
+        double variance = (1.0 - n / population) * residual / (n - 1.0) / (n * mean_accesses * mean_accesses);
+        estimate.miss_rate_ci = 1.96 * std::sqrt(std::max(variance, 0.0));
+        return estimate;
+    }
+
+    void writeSetHeatmap(std::ostream &os, int core_id, const std::vector<SetStats> &sets)
+    {
+        for (size_t i = 0; i < sets.size(); ++i)
+        {
+            os << core_id << ',' << i << ','
+               << sets[i].accesses << ','
+               << sets[i].misses << ','
+               << sets[i].evictions << '\n';
+        }
+    }
+
+} // namespace cache_sim
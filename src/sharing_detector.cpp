@@ -0,0 +1,192 @@
+#include "sharing_detector.h"
+
+namespace cache_sim
+{
+    SharingDetector::SharingDetector(size_t block_size, size_t num_cores)
+        : block_size_(block_size), num_cores_(num_cores), words_per_mask_((block_size + 63) / 64),
+          true_sharing_(0), false_sharing_(0)
+    {
+        if (num_cores_ > 64)
+        {
+            std::cerr << "[Warning] 共享检测最多支持 64 个核心，超出的核心将被忽略。" << std::endl;
+            num_cores_ = 64;
+        }
+    }
+
+    void SharingDetector::access(size_t core_id, uint64_t address, size_t size, bool is_write)
+    {
+        if (core_id >= num_cores_)
+        {
+            return;
+        }
+
+        // 只跟踪发生过作废的块
+        auto it = blocks_.find(address & ~uint64_t(block_size_ - 1));
+        if (it == blocks_.end())
+        {
+            return;
+        }
+
+        BlockRecord &record = it->second;
+        size_t offset = address & (block_size_ - 1);
+        uint64_t core_bit = uint64_t(1) << core_id;
+
+        // 副本被作废后的首次访问即一致性缺失
+        if (record.pending & core_bit)
+        {
+            uint64_t *remote = &record.remote[core_id * words_per_mask_];
+            if (testBytes(remote, offset, size))
+            {
+                record.true_sharing++;
+                true_sharing_++;
+            }
+            else
+            {
+                record.false_sharing++;
+                false_sharing_++;
+            }
+            record.pending &= ~core_bit;
+            std::fill(remote, remote + words_per_mask_, 0);
+        }
+
+        setBytes(&record.touched[core_id * words_per_mask_], offset, size);
+        if (is_write)
+        {
+            setBytes(&record.written[core_id * words_per_mask_], offset, size);
+
+            // 写入的字节对其他副本已作废的核心可见
+            for (size_t core = 0; core < num_cores_; ++core)
+            {
+                if (core != core_id && (record.pending & (uint64_t(1) << core)))
+                {
+                    setBytes(&record.remote[core * words_per_mask_], offset, size);
+                }
+            }
+        }
+    }
+
+    void SharingDetector::invalidate(size_t core_id, size_t writer_id, uint64_t address, size_t size)
+    {
+        if (core_id >= num_cores_ || writer_id >= num_cores_)
+        {
+            return;
+        }
+
+        auto inserted = blocks_.emplace(address & ~uint64_t(block_size_ - 1), BlockRecord());
+        BlockRecord &record = inserted.first->second;
+        if (inserted.second)
+        {
+            size_t words = num_cores_ * words_per_mask_;
+            record.touched.assign(words, 0);
+            record.written.assign(words, 0);
+            record.remote.assign(words, 0);
+            record.pending = 0;
+            record.true_sharing = 0;
+            record.false_sharing = 0;
+            record.invalidations = 0;
+        }
+
+        record.invalidations++;
+        record.pending |= uint64_t(1) << core_id;
+
+        // 引起作废的写入本身也算作其他核心写过的字节
+        size_t offset = address & (block_size_ - 1);
+        setBytes(&record.remote[core_id * words_per_mask_], offset, size);
+        setBytes(&record.touched[writer_id * words_per_mask_], offset, size);
+        setBytes(&record.written[writer_id * words_per_mask_], offset, size);
+    }
+
+    std::vector<BlockSharingReport> SharingDetector::topBlocks(size_t count) const
+    {
+        std::vector<BlockSharingReport> reports;
+        reports.reserve(blocks_.size());
+        for (const auto &entry : blocks_)
+        {
+            const BlockRecord &record = entry.second;
+            BlockSharingReport report;
+            report.block_address = entry.first;
+            report.true_sharing = record.true_sharing;
+            report.false_sharing = record.false_sharing;
+            report.invalidations = record.invalidations;
+            report.cores = 0;
+            report.written_bytes = 0;
+            report.overlapping_writes = false;
+
+            std::vector<uint64_t> any_written(words_per_mask_, 0);
+            for (size_t core = 0; core < num_cores_; ++core)
+            {
+                bool touched = false;
+                for (size_t w = 0; w < words_per_mask_; ++w)
+                {
+                    uint64_t written = record.written[core * words_per_mask_ + w];
+                    touched = touched || record.touched[core * words_per_mask_ + w] != 0;
+                    if (any_written[w] & written)
+                    {
+                        report.overlapping_writes = true;
+                    }
+                    any_written[w] |= written;
+                }
+                if (touched)
+                {
+                    report.cores++;
+                }
+            }
+            for (uint64_t word : any_written)
+            {
+                report.written_bytes += __builtin_popcountll(word);
+            }
+            reports.push_back(report);
+        }
+
+        // 一致性缺失次数相同时按地址排序，保证输出稳定
+        std::sort(reports.begin(), reports.end(),
+                  [](const BlockSharingReport &a, const BlockSharingReport &b)
+                  {
+                      if (a.coherenceMisses() != b.coherenceMisses())
+                      {
+                          return a.coherenceMisses() > b.coherenceMisses();
+                      }
+                      return a.block_address < b.block_address;
+                  });
+        if (reports.size() > count)
+        {
+            reports.resize(count);
+        }
+        return reports;
+    }
+
+    void SharingDetector::setBytes(uint64_t *mask, size_t offset, size_t size) const
+    {
+        size_t end = std::min(offset + size, block_size_);
+        for (size_t byte = offset; byte < end; ++byte)
+        {
+            mask[byte / 64] |= uint64_t(1) << (byte % 64);
+        }
+    }
+
+    bool SharingDetector::testBytes(const uint64_t *mask, size_t offset, size_t size) const
+    {
+        size_t end = std::min(offset + size, block_size_);
+        for (size_t byte = offset; byte < end; ++byte)
+        {
+            if (mask[byte / 64] & (uint64_t(1) << (byte % 64)))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void SharingDetector::resetStats()
+    {
+        true_sharing_ = 0;
+        false_sharing_ = 0;
+        for (auto &entry : blocks_)
+        {
+            entry.second.true_sharing = 0;
+            entry.second.false_sharing = 0;
+            entry.second.invalidations = 0;
+        }
+    }
+
+} // namespace cache_sim
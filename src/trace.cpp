@@ -0,0 +1,550 @@
+#include "trace.h"
+
+namespace cache_sim
+{
+    namespace
+    {
+        const char kHeaderMagic[8] = {'C', 'S', 'T', 'R', 'A', 'C', 'E', '\0'};
+        const char kIndexMagic[8] = {'C', 'S', 'T', 'R', 'I', 'D', 'X', '\0'};
+        const uint32_t kFormatVersion = 1;
+        const size_t kHeaderSize = 16;
+        const size_t kTrailerSize = 24;
+        const size_t kIndexEntrySize = 16;
+
+        // 地址上限：保证 zigzag 增量左移一位后不溢出
+        const uint64_t kMaxAddress = uint64_t(1) << 62;
+
+        // ChampSim input_instr 记录布局
+        const size_t kChampSimRecordSize = 64;
+        const size_t kChampSimDestMemoryOffset = 16;
+        const size_t kChampSimDestMemoryCount = 2;
+        const size_t kChampSimSrcMemoryOffset = 32;
+        const size_t kChampSimSrcMemoryCount = 4;
+
+        template <typename T>
+        void writeLE(std::ostream &os, T value)
+        {
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                os.put(static_cast<char>(value & 0xFF));
+                value >>= 8;
+            }
+        }
+
+        template <typename T>
+        T readLE(const uint8_t *data)
+        {
+            T value = 0;
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                value |= static_cast<T>(data[i]) << (8 * i);
+            }
+            return value;
+        }
+
+        // 解析十六进制地址，允许 0x 前缀
+        bool parseHex(const std::string &text, uint64_t &value)
+        {
+            if (text.empty())
+            {
+                return false;
+            }
+            char *end = nullptr;
+            value = std::strtoull(text.c_str(), &end, 16);
+            return end != text.c_str();
+        }
+
+        bool endsWith(const std::string &text, const std::string &suffix)
+        {
+            return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+    }
+
+    bool parseTraceFormat(const std::string &name, TraceFormat &format)
+    {
+        if (name == "din")
+        {
+            format = TraceFormat::Din;
+        }
+        else if (name == "lackey")
+        {
+            format = TraceFormat::Lackey;
+        }
+        else if (name == "champsim")
+        {
+            format = TraceFormat::ChampSim;
+        }
+        else if (name == "native")
+        {
+            format = TraceFormat::Native;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    TraceFormat guessTraceFormat(const std::string &path)
+    {
+        if (endsWith(path, ".din"))
+        {
+            return TraceFormat::Din;
+        }
+        if (endsWith(path, ".lackey"))
+        {
+            return TraceFormat::Lackey;
+        }
+        if (endsWith(path, ".champsim") || endsWith(path, ".champsimtrace"))
+        {
+            return TraceFormat::ChampSim;
+        }
+        if (endsWith(path, ".cst"))
+        {
+            return TraceFormat::Native;
+        }
+        return TraceFormat::Auto;
+    }
+
+    std::string getTraceFormatName(TraceFormat format)
+    {
+        switch (format)
+        {
+        case TraceFormat::Auto:
+            return "auto";
+        case TraceFormat::Din:
+            return "din";
+        case TraceFormat::Lackey:
+            return "lackey";
+        case TraceFormat::ChampSim:
+            return "champsim";
+        case TraceFormat::Native:
+            return "native";
+        default:
+            return "unknown";
+        }
+    }
+
+    std::unique_ptr<TraceReader> openTrace(const std::string &path, TraceFormat format, size_t decode_threads)
+    {
+        if (format == TraceFormat::Auto)
+        {
+            format = guessTraceFormat(path);
+        }
+
+        if (format == TraceFormat::Native)
+        {
+            NativeTraceReader *native = new NativeTraceReader(path, decode_threads);
+            std::unique_ptr<TraceReader> reader(native);
+            if (!native->ok())
+            {
+                return nullptr;
+            }
+            return reader;
+        }
+
+        std::istream *in = &std::cin;
+        std::unique_ptr<std::istream> file;
+        if (path != "-")
+        {
+            std::ios::openmode mode = format == TraceFormat::ChampSim ? std::ios::in | std::ios::binary : std::ios::in;
+            file.reset(new std::ifstream(path, mode));
+            if (!*file)
+            {
+                std::cerr << "[Warning] 无法打开 trace 文件 '" << path << "'" << std::endl;
+                return nullptr;
+            }
+            in = file.get();
+        }
+
+        std::unique_ptr<TraceReader> reader;
+        switch (format)
+        {
+        case TraceFormat::Din:
+            reader.reset(new DinTraceReader(*in));
+            break;
+        case TraceFormat::Lackey:
+            reader.reset(new LackeyTraceReader(*in));
+            break;
+        case TraceFormat::ChampSim:
+            reader.reset(new ChampSimTraceReader(*in));
+            break;
+        default:
+            std::cerr << "[Warning] 无法确定 trace 文件 '" << path << "' 的格式" << std::endl;
+            return nullptr;
+        }
+        reader->ownStream(std::move(file));
+        return reader;
+    }
+
+    size_t DinTraceReader::read(TraceRecord *out, size_t max)
+    {
+        size_t count = 0;
+        std::string line;
+        while (count < max && std::getline(in_, line))
+        {
+            std::istringstream fields(line);
+            int label;
+            std::string address_text;
+            if (!(fields >> label >> address_text))
+            {
+                continue;
+            }
+
+            // 只保留数据读写，取指、刷新等标签不经过数据缓存
+            uint64_t address;
+            if ((label == 0 || label == 1) && parseHex(address_text, address))
+            {
+                out[count++] = TraceRecord{address, label == 1};
+            }
+        }
+        return count;
+    }
+
+    size_t LackeyTraceReader::read(TraceRecord *out, size_t max)
+    {
+        size_t count = 0;
+        std::string line;
+        while (count < max)
+        {
+            if (pending_write_)
+            {
+                out[count++] = TraceRecord{pending_address_, true};
+                pending_write_ = false;
+                continue;
+            }
+            if (!std::getline(in_, line))
+            {
+                break;
+            }
+
+            // 数据访问行形如 " L 04222cac,8"，取指行以 'I' 开头，Valgrind 消息以 "==" 开头
+            size_t pos = line.find_first_not_of(' ');
+            if (pos == std::string::npos || pos + 1 >= line.size() || line[pos + 1] != ' ')
+            {
+                continue;
+            }
+            char op = line[pos];
+            if (op != 'L' && op != 'S' && op != 'M')
+            {
+                continue;
+            }
+
+            size_t start = line.find_first_not_of(' ', pos + 1);
+            size_t comma = line.find(',', start);
+            uint64_t address;
+            if (start == std::string::npos || !parseHex(line.substr(start, comma - start), address))
+            {
+                continue;
+            }
+
+            out[count++] = TraceRecord{address, op == 'S'};
+            if (op == 'M')
+            {
+                // 修改 = 读 + 写同一地址
+                pending_write_ = true;
+                pending_address_ = address;
+            }
+        }
+        return count;
+    }
+
+    size_t ChampSimTraceReader::read(TraceRecord *out, size_t max)
+    {
+        size_t count = 0;
+        uint8_t record[kChampSimRecordSize];
+        while (count < max)
+        {
+            if (!pending_.empty())
+            {
+                out[count++] = pending_.front();
+                pending_.pop_front();
+                continue;
+            }
+            if (!in_.read(reinterpret_cast<char *>(record), kChampSimRecordSize))
+            {
+                break;
+            }
+
+            // 先读源操作数，再写目的操作数
+            for (size_t i = 0; i < kChampSimSrcMemoryCount; ++i)
+            {
+                uint64_t address = readLE<uint64_t>(record + kChampSimSrcMemoryOffset + 8 * i);
+                if (address != 0)
+                {
+                    pending_.push_back(TraceRecord{address, false});
+                }
+            }
+            for (size_t i = 0; i < kChampSimDestMemoryCount; ++i)
+            {
+                uint64_t address = readLE<uint64_t>(record + kChampSimDestMemoryOffset + 8 * i);
+                if (address != 0)
+                {
+                    pending_.push_back(TraceRecord{address, true});
+                }
+            }
+        }
+        return count;
+    }
+
+    NativeTraceWriter::NativeTraceWriter(const std::string &path, size_t chunk_records)
+        : out_(path, std::ios::out | std::ios::binary | std::ios::trunc), chunk_records_(std::max<size_t>(chunk_records, 1)),
+          chunk_count_(0), previous_(0), records_(0), bytes_written_(0), closed_(false)
+    {
+        if (out_)
+        {
+            out_.write(kHeaderMagic, sizeof(kHeaderMagic));
+            writeLE<uint32_t>(out_, kFormatVersion);
+            writeLE<uint32_t>(out_, 0);
+            bytes_written_ = kHeaderSize;
+        }
+    }
+
+    NativeTraceWriter::~NativeTraceWriter()
+    {
+        close();
+    }
+
+    bool NativeTraceWriter::add(const TraceRecord &record)
+    {
+        if (record.address >= kMaxAddress)
+        {
+            return false;
+        }
+
+        int64_t delta = static_cast<int64_t>(record.address - previous_);
+        putVarint(chunk_, (zigzagEncode(delta) << 1) | (record.is_write ? 1 : 0));
+        previous_ = record.address;
+        ++records_;
+        if (++chunk_count_ == chunk_records_)
+        {
+            flushChunk();
+        }
+        return true;
+    }
+
+    void NativeTraceWriter::flushChunk()
+    {
+        if (chunk_count_ == 0)
+        {
+            return;
+        }
+        index_.push_back(ChunkInfo{bytes_written_, static_cast<uint32_t>(chunk_.size()), chunk_count_});
+        out_.write(reinterpret_cast<const char *>(chunk_.data()), chunk_.size());
+        bytes_written_ += chunk_.size();
+
+        // 下一块从 0 开始编码，保证各块可独立解码
+        chunk_.clear();
+        chunk_count_ = 0;
+        previous_ = 0;
+    }
+
+    bool NativeTraceWriter::close()
+    {
+        if (closed_ || !out_)
+        {
+            return static_cast<bool>(out_);
+        }
+        closed_ = true;
+
+        flushChunk();
+        uint64_t index_offset = bytes_written_;
+        for (const ChunkInfo &chunk : index_)
+        {
+            writeLE<uint64_t>(out_, chunk.offset);
+            writeLE<uint32_t>(out_, chunk.bytes);
+            writeLE<uint32_t>(out_, chunk.records);
+        }
+        writeLE<uint64_t>(out_, index_offset);
+        writeLE<uint64_t>(out_, index_.size());
+        out_.write(kIndexMagic, sizeof(kIndexMagic));
+        bytes_written_ += index_.size() * kIndexEntrySize + kTrailerSize;
+        out_.close();
+        return !out_.fail();
+    }
+
+    NativeTraceReader::NativeTraceReader(const std::string &path, size_t threads, size_t start_chunk)
+        : path_(path), total_records_(0), ok_(false), next_to_decode_(0), next_to_consume_(0), window_(0), stop_(false), current_pos_(0)
+    {
+        ok_ = readIndex();
+        if (!ok_)
+        {
+            return;
+        }
+
+        next_to_decode_ = std::min(start_chunk, index_.size());
+        next_to_consume_ = next_to_decode_;
+        threads = std::max<size_t>(threads, 1);
+        window_ = 2 * threads;
+        for (size_t i = 0; i < threads; ++i)
+        {
+            workers_.emplace_back(&NativeTraceReader::workerLoop, this);
+        }
+    }
+
+    NativeTraceReader::~NativeTraceReader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    bool NativeTraceReader::readIndex()
+    {
+        std::ifstream in(path_, std::ios::in | std::ios::binary);
+        if (!in)
+        {
+            std::cerr << "[Warning] 无法打开 trace 文件 '" << path_ << "'" << std::endl;
+            return false;
+        }
+
+        uint8_t header[kHeaderSize];
+        uint8_t trailer[kTrailerSize];
+        in.seekg(0, std::ios::end);
+        std::streamoff size = in.tellg();
+        in.seekg(0);
+        if (size < static_cast<std::streamoff>(kHeaderSize + kTrailerSize) ||
+            !in.read(reinterpret_cast<char *>(header), kHeaderSize) ||
+            std::memcmp(header, kHeaderMagic, sizeof(kHeaderMagic)) != 0 ||
+            readLE<uint32_t>(header + 8) != kFormatVersion)
+        {
+            std::cerr << "[Warning] '" << path_ << "' 不是有效的压缩 trace 文件" << std::endl;
+            return false;
+        }
+
+        in.seekg(size - static_cast<std::streamoff>(kTrailerSize));
+        if (!in.read(reinterpret_cast<char *>(trailer), kTrailerSize) ||
+            std::memcmp(trailer + 16, kIndexMagic, sizeof(kIndexMagic)) != 0)
+        {
+            std::cerr << "[Warning] 压缩 trace 文件 '" << path_ << "' 缺少块索引（写入未完成？）" << std::endl;
+            return false;
+        }
+
+        uint64_t index_offset = readLE<uint64_t>(trailer);
+        uint64_t num_chunks = readLE<uint64_t>(trailer + 8);
+        // 先限制块数再相乘，避免损坏的尾部使乘法溢出后恰好通过检查
+        uint64_t max_chunks = (static_cast<uint64_t>(size) - kHeaderSize - kTrailerSize) / kIndexEntrySize;
+        if (num_chunks > max_chunks ||
+            index_offset != static_cast<uint64_t>(size) - kTrailerSize - num_chunks * kIndexEntrySize)
+        {
+            std::cerr << "[Warning] 压缩 trace 文件 '" << path_ << "' 的块索引已损坏" << std::endl;
+            return false;
+        }
+
+        std::vector<uint8_t> entries(num_chunks * kIndexEntrySize);
+        in.seekg(static_cast<std::streamoff>(index_offset));
+        if (!entries.empty() && !in.read(reinterpret_cast<char *>(entries.data()), entries.size()))
+        {
+            std::cerr << "[Warning] 无法读取压缩 trace 文件 '" << path_ << "' 的块索引" << std::endl;
+            return false;
+        }
+
+        index_.reserve(num_chunks);
+        for (uint64_t i = 0; i < num_chunks; ++i)
+        {
+            const uint8_t *entry = entries.data() + i * kIndexEntrySize;
+            ChunkInfo chunk{readLE<uint64_t>(entry), readLE<uint32_t>(entry + 8), readLE<uint32_t>(entry + 12)};
+            // 数据块须位于头部与块索引之间，否则解码线程会按损坏的长度分配缓冲
+            if (chunk.offset < kHeaderSize || chunk.offset > index_offset || chunk.bytes > index_offset - chunk.offset)
+            {
+                std::cerr << "[Warning] 压缩 trace 文件 '" << path_ << "' 的块索引已损坏" << std::endl;
+                index_.clear();
+                total_records_ = 0;
+                return false;
+            }
+            index_.push_back(chunk);
+            total_records_ += chunk.records;
+        }
+        return true;
+    }
+
+    void NativeTraceReader::workerLoop()
+    {
+        std::ifstream in(path_, std::ios::in | std::ios::binary);
+        std::vector<uint8_t> bytes;
+
+        while (true)
+        {
+            size_t chunk_id;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]
+                         { return stop_ || (next_to_decode_ < index_.size() && next_to_decode_ < next_to_consume_ + window_); });
+                if (stop_)
+                {
+                    return;
+                }
+                chunk_id = next_to_decode_++;
+            }
+
+            const ChunkInfo &chunk = index_[chunk_id];
+            std::vector<TraceRecord> records;
+            records.reserve(chunk.records);
+            bytes.resize(chunk.bytes);
+            in.clear();
+            in.seekg(static_cast<std::streamoff>(chunk.offset));
+            bool valid = static_cast<bool>(in.read(reinterpret_cast<char *>(bytes.data()), bytes.size()));
+
+            const uint8_t *pos = bytes.data();
+            const uint8_t *end = pos + bytes.size();
+            uint64_t previous = 0;
+            for (uint32_t i = 0; valid && i < chunk.records; ++i)
+            {
+                uint64_t value;
+                valid = getVarint(pos, end, value);
+                previous += static_cast<uint64_t>(zigzagDecode(value >> 1));
+                records.push_back(TraceRecord{previous, (value & 1) != 0});
+            }
+            if (!valid)
+            {
+                std::cerr << "[Warning] 压缩 trace 文件 '" << path_ << "' 的第 " << chunk_id << " 块已损坏，已跳过" << std::endl;
+                records.clear();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ready_[chunk_id] = std::move(records);
+            }
+            cv_.notify_all();
+        }
+    }
+
+    size_t NativeTraceReader::read(TraceRecord *out, size_t max)
+    {
+        size_t count = 0;
+        while (count < max)
+        {
+            if (current_pos_ == current_.size())
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (next_to_consume_ >= index_.size())
+                {
+                    break;
+                }
+                cv_.wait(lock, [this]
+                         { return ready_.count(next_to_consume_) != 0; });
+                current_ = std::move(ready_[next_to_consume_]);
+                ready_.erase(next_to_consume_);
+                ++next_to_consume_;
+                current_pos_ = 0;
+                lock.unlock();
+                // 消费者前进后，解码线程可以领取新的块
+                cv_.notify_all();
+                continue;
+            }
+
+            size_t n = std::min(max - count, current_.size() - current_pos_);
+            std::copy(current_.begin() + current_pos_, current_.begin() + current_pos_ + n, out + count);
+            current_pos_ += n;
+            count += n;
+        }
+        return count;
+    }
+
+} // namespace cache_sim
@@ -0,0 +1,95 @@
+#include "victim_cache.h"
+
+namespace cache_sim
+{
+    VictimCache::VictimCache(size_t num_entries)
+        : entries_(num_entries), access_clock_(0)
+    {
+    }
+
+    VictimEntry *VictimCache::find(uint64_t block_address)
+    {
+        for (auto &entry : entries_)
+        {
+            if (entry.valid && entry.block_address == block_address)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    VictimEntry VictimCache::insert(const VictimEntry &entry)
+    {
+        // 已存在则原地更新
+        VictimEntry *slot = find(entry.block_address);
+
+        // 否则优先使用空闲项，再替换最久未访问的项
+        if (slot == nullptr)
+        {
+            for (auto &candidate : entries_)
+            {
+                if (!candidate.valid)
+                {
+                    slot = &candidate;
+                    break;
+                }
+                if (slot == nullptr || candidate.last_access_time < slot->last_access_time)
+                {
+                    slot = &candidate;
+                }
+            }
+        }
+
+        VictimEntry evicted;
+        if (slot == nullptr)
+        {
+            return evicted;
+        }
+        if (slot->valid && slot->block_address != entry.block_address)
+        {
+            evicted = *slot;
+        }
+
+        *slot = entry;
+        slot->valid = true;
+        slot->last_access_time = ++access_clock_;
+        return evicted;
+    }
+
+    void VictimCache::remove(VictimEntry *entry)
+    {
+        if (entry != nullptr)
+        {
+            *entry = VictimEntry();
+        }
+    }
+
+    void VictimCache::touch(VictimEntry *entry)
+    {
+        if (entry != nullptr)
+        {
+            entry->last_access_time = ++access_clock_;
+        }
+    }
+
+    void VictimCache::save(std::ostream &os) const
+    {
+        static_assert(std::is_trivially_copyable<VictimEntry>::value, "VictimEntry 需可按字节复制");
+        uint64_t header[2] = {entries_.size(), access_clock_};
+        os.write(reinterpret_cast<const char *>(header), sizeof(header));
+        os.write(reinterpret_cast<const char *>(entries_.data()), entries_.size() * sizeof(VictimEntry));
+    }
+
+    bool VictimCache::load(std::istream &is)
+    {
+        uint64_t header[2];
+        if (!is.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != entries_.size())
+        {
+            return false;
+        }
+        access_clock_ = header[1];
+        return static_cast<bool>(is.read(reinterpret_cast<char *>(entries_.data()), entries_.size() * sizeof(VictimEntry)));
+    }
+
+} // namespace cache_sim
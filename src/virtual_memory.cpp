@@ -0,0 +1,267 @@
+#include "virtual_memory.h"
+#include "lru_cache.h"
+
+namespace cache_sim
+{
+    const uint64_t VirtualMemory::kPteSize;
+    const uint64_t VirtualMemory::kPageTableBase;
+
+    VirtualMemory::VirtualMemory(const VirtualMemoryConfig &config, const std::vector<std::unique_ptr<Cache>> &data_caches)
+        : config_(config), data_caches_(data_caches)
+    {
+        page_bits_ = static_cast<size_t>(__builtin_ctzll(config_.page_size));
+        index_bits_ = static_cast<size_t>(__builtin_ctzll(config_.page_size / kPteSize));
+
+        // TLB 以虚拟页号为地址、块大小为 1，因此组索引与标签直接取自虚拟页号
+        tlbs_.resize(data_caches_.size());
+        for (size_t core = 0; core < data_caches_.size(); ++core)
+        {
+            for (const TlbLevelConfig &level : config_.tlb_levels)
+            {
+                tlbs_[core].push_back(std::make_unique<LRUCache>(CacheConfig(level.entries, 1, level.associativity), static_cast<int>(core)));
+            }
+        }
+    }
+
+    uint64_t VirtualMemory::translate(size_t core_id, uint64_t address, bool is_write)
+    {
+        ++now_;
+        stats_.translations++;
+        uint64_t vpn = address >> page_bits_;
+
+        // 逐级查找 TLB，缺失的级在读取时即装入该页
+        bool hit = false;
+        for (auto &tlb : tlbs_[core_id])
+        {
+            if (tlb->read(vpn))
+            {
+                hit = true;
+                break;
+            }
+        }
+        if (!hit)
+        {
+            walk(core_id, vpn);
+        }
+
+        PageTableEntry &pte = page_table_[vpn];
+        if (!pte.present)
+        {
+            pageFault(vpn, pte);
+        }
+
+        // 硬件在访问时置引用位，写入时置脏位
+        Frame &frame = frames_[pte.frame];
+        frame.referenced = true;
+        frame.last_use = now_;
+        if (is_write)
+        {
+            frame.dirty = true;
+        }
+        if (config_.page_replacement == PageReplacement::LRU)
+        {
+            lru_list_.splice(lru_list_.begin(), lru_list_, lru_position_[pte.frame]);
+        }
+
+        return (pte.frame << page_bits_) | (address & (config_.page_size - 1));
+    }
+
+    void VirtualMemory::walk(size_t core_id, uint64_t vpn)
+    {
+        stats_.page_walks++;
+        size_t levels = config_.page_table_levels;
+        for (size_t level = 0; level < levels; ++level)
+        {
+            // 同一级中虚拟页号的高位前缀相同的页共用一个页表页
+            size_t shift = index_bits_ * (levels - 1 - level);
+            uint64_t key = ((vpn >> (shift + index_bits_)) << 4) | level;
+            auto node = page_table_nodes_.find(key);
+            if (node == page_table_nodes_.end())
+            {
+                node = page_table_nodes_.emplace(key, page_table_nodes_.size()).first;
+            }
+
+            uint64_t index = (vpn >> shift) & ((uint64_t(1) << index_bits_) - 1);
+            uint64_t pte_address = kPageTableBase + (node->second << page_bits_) + index * kPteSize;
+            stats_.pte_accesses++;
+            if (data_caches_[core_id]->read(pte_address))
+            {
+                stats_.pte_cache_hits++;
+            }
+        }
+    }
+
+    void VirtualMemory::pageFault(uint64_t vpn, PageTableEntry &pte)
+    {
+        stats_.page_faults++;
+        if (pte.swapped)
+        {
+            stats_.major_faults++;
+        }
+
+        size_t frame;
+        if (config_.physical_frames == 0 || frames_.size() < config_.physical_frames)
+        {
+            // 仍有空闲页框
+            frame = frames_.size();
+            frames_.emplace_back();
+            if (config_.page_replacement == PageReplacement::LRU)
+            {
+                lru_list_.push_front(frame);
+                lru_position_.push_back(lru_list_.begin());
+            }
+        }
+        else
+        {
+            frame = selectVictimFrame();
+            evictFrame(frame);
+        }
+
+        Frame &entry = frames_[frame];
+        entry = Frame();
+        entry.vpn = vpn;
+        entry.used = true;
+        entry.last_use = now_;
+
+        pte.frame = frame;
+        pte.present = true;
+        ++resident_pages_;
+    }
+
+    size_t VirtualMemory::selectVictimFrame()
+    {
+        switch (config_.page_replacement)
+        {
+        case PageReplacement::WSClock:
+            return selectWSClockVictim();
+        case PageReplacement::LRU:
+            return lru_list_.back();
+        case PageReplacement::Clock:
+        default:
+            return selectClockVictim();
+        }
+    }
+
+    size_t VirtualMemory::selectClockVictim()
+    {
+        // 表针扫过的已引用页获得第二次机会
+        while (true)
+        {
+            size_t frame = clock_hand_;
+            clock_hand_ = (clock_hand_ + 1) % frames_.size();
+            if (!frames_[frame].referenced)
+            {
+                return frame;
+            }
+            frames_[frame].referenced = false;
+        }
+    }
+
+    size_t VirtualMemory::selectWSClockVictim()
+    {
+        size_t n = frames_.size();
+        size_t oldest = n;
+
+        // 第一圈中超出窗口的脏页被安排写回，第二圈即可作为干净页置换
+        for (size_t step = 0; step < 2 * n; ++step)
+        {
+            size_t index = clock_hand_;
+            clock_hand_ = (clock_hand_ + 1) % n;
+            Frame &frame = frames_[index];
+
+            if (frame.referenced)
+            {
+                frame.referenced = false;
+                frame.last_use = now_;
+                continue;
+            }
+            if (now_ - frame.last_use > config_.wsclock_window)
+            {
+                if (!frame.dirty)
+                {
+                    return index;
+                }
+                stats_.swap_outs++;
+                frame.dirty = false;
+                continue;
+            }
+            if (oldest == n || frame.last_use < frames_[oldest].last_use)
+            {
+                oldest = index;
+            }
+        }
+
+        // 所有页都在工作集内：置换最久未使用的页
+        return oldest == n ? clock_hand_ : oldest;
+    }
+
+    void VirtualMemory::evictFrame(size_t frame)
+    {
+        Frame &victim = frames_[frame];
+        auto pte = page_table_.find(victim.vpn);
+        if (pte != page_table_.end())
+        {
+            pte->second.present = false;
+            pte->second.swapped = true;
+        }
+
+        stats_.page_evictions++;
+        if (victim.dirty)
+        {
+            stats_.swap_outs++;
+        }
+
+        // TLB 击落：作废所有核心中该页的转换
+        for (auto &core_tlbs : tlbs_)
+        {
+            for (auto &tlb : core_tlbs)
+            {
+                if (tlb->invalidate(victim.vpn))
+                {
+                    stats_.tlb_shootdowns++;
+                }
+            }
+        }
+
+        // 页框将装入其他页，作废数据缓存中属于该页框的块（脏块写回）
+        uint64_t base = static_cast<uint64_t>(frame) << page_bits_;
+        for (const auto &cache : data_caches_)
+        {
+            size_t block_size = cache->getConfig().block_size;
+            for (uint64_t offset = 0; offset < config_.page_size; offset += block_size)
+            {
+                cache->invalidate(base + offset);
+            }
+        }
+
+        --resident_pages_;
+    }
+
+    void VirtualMemory::resetStats()
+    {
+        stats_ = VirtualMemoryStats();
+        for (auto &core_tlbs : tlbs_)
+        {
+            for (auto &tlb : core_tlbs)
+            {
+                tlb->resetStats();
+            }
+        }
+    }
+
+    std::string VirtualMemory::getReplacementName(PageReplacement replacement)
+    {
+        switch (replacement)
+        {
+        case PageReplacement::Clock:
+            return "Clock";
+        case PageReplacement::WSClock:
+            return "WSClock";
+        case PageReplacement::LRU:
+            return "LRU";
+        default:
+            return "未知置换算法";
+        }
+    }
+
+} // namespace cache_sim
@@ -0,0 +1,325 @@
+#include "workload.h"
+
+namespace cache_sim
+{
+    constexpr size_t WorkloadStream::kBatchSize;
+    constexpr uint64_t WorkloadStream::kWriteScale;
+    constexpr size_t WorkloadStream::kWordSize;
+
+    bool isSharingPattern(AccessPattern pattern)
+    {
+        return pattern == AccessPattern::ProducerConsumer || pattern == AccessPattern::Migratory ||
+               pattern == AccessPattern::ReadMostly || pattern == AccessPattern::LockContention;
+    }
+
+    bool isKeyValuePattern(AccessPattern pattern)
+    {
+        return pattern == AccessPattern::Zipfian || pattern == AccessPattern::ScrambledZipfian ||
+               pattern == AccessPattern::Hotspot || pattern == AccessPattern::Latest;
+    }
+
+    double defaultWriteRatio(AccessPattern pattern)
+    {
+        // 读多写少的共享表只偶尔更新，其余模式与全局默认值相同
+        return pattern == AccessPattern::ReadMostly ? 0.02 : 0.25;
+    }
+
+    WorkloadStream::WorkloadStream(const CoreWorkload &workload, size_t block_size, size_t core_id, size_t num_cores, uint64_t seed)
+        : workload_(workload), block_size_(block_size), index_(0), rng_(seed, core_id),
+          addresses_(kBatchSize), writes_(kBatchSize), cursor_(kBatchSize)
+    {
+        double ratio = std::min(std::max(workload_.write_ratio, 0.0), 1.0);
+        write_step_ = static_cast<uint64_t>(std::llround(ratio * static_cast<double>(kWriteScale)));
+        // 预置额度，使写比例非零时第一次访问即为写
+        write_error_ = kWriteScale - write_step_;
+
+        // 共享模式：相邻的 sharers 个核心组成一组，每组使用独立的一段数据
+        group_size_ = workload_.sharers == 0 ? std::max<size_t>(num_cores, 1) : workload_.sharers;
+        rank_ = core_id % group_size_;
+        group_base_ = workload_.address_base;
+        if (isSharingPattern(workload_.pattern))
+        {
+            group_base_ += (core_id / group_size_) * workload_.address_range;
+        }
+        words_ = std::max<size_t>(workload_.address_range / kWordSize, 1);
+
+        // 键值模式：对象按块对齐，地址区间内能容纳的对象数即键数
+        object_blocks_ = std::max<size_t>((std::max(workload_.object_size, block_size_) + block_size_ - 1) / block_size_, 1);
+        object_size_ = object_blocks_ * block_size_;
+        num_keys_ = std::max<uint64_t>(workload_.address_range / object_size_, 1);
+        object_block_ = object_blocks_;
+        object_base_ = 0;
+        object_write_ = false;
+        latest_key_ = num_keys_ - 1;
+        if (isKeyValuePattern(workload_.pattern))
+        {
+            zipf_ = ZipfSampler(num_keys_, workload_.zipf_theta);
+        }
+    }
+
+    void WorkloadStream::refill()
+    {
+        fill(addresses_.data(), writes_.data(), kBatchSize);
+        cursor_ = 0;
+    }
+
+    void WorkloadStream::fill(uint64_t *addresses, uint8_t *writes, size_t count)
+    {
+        switch (workload_.pattern)
+        {
+        case AccessPattern::Random:
+        case AccessPattern::ReadMostly:
+            fillRandom(addresses, count);
+            fillWriteRatio(writes, count);
+            break;
+        case AccessPattern::Sequential:
+            fillSequential(addresses, count);
+            fillWriteRatio(writes, count);
+            break;
+        case AccessPattern::Localized:
+            fillLocalized(addresses, count);
+            fillWriteRatio(writes, count);
+            break;
+        case AccessPattern::ProducerConsumer:
+            fillProducerConsumer(addresses, writes, count);
+            break;
+        case AccessPattern::Migratory:
+            fillMigratory(addresses, writes, count);
+            break;
+        case AccessPattern::LockContention:
+            fillLockContention(addresses, writes, count);
+            break;
+        case AccessPattern::Zipfian:
+        case AccessPattern::ScrambledZipfian:
+        case AccessPattern::Hotspot:
+        case AccessPattern::Latest:
+            fillKeyValue(addresses, writes, count);
+            break;
+        default:
+            std::fill(addresses, addresses + count, 0);
+            std::fill(writes, writes + count, 0);
+            break;
+        }
+
+        uint64_t base = isSharingPattern(workload_.pattern) ? group_base_ : workload_.address_base;
+        for (size_t i = 0; i < count; ++i)
+        {
+            addresses[i] += base;
+        }
+        index_ += count;
+    }
+
+    void WorkloadStream::fillWriteRatio(uint8_t *writes, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            writes[i] = nextWrite();
+        }
+    }
+
+    void WorkloadStream::fillRandom(uint64_t *addresses, size_t count)
+    {
+        rng_.fillBounded(addresses, count, workload_.address_range);
+    }
+
+    void WorkloadStream::fillSequential(uint64_t *addresses, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            addresses[i] = ((index_ + i) * block_size_) % workload_.address_range;
+        }
+    }
+
+    void WorkloadStream::fillLocalized(uint64_t *addresses, size_t count)
+    {
+        // 模拟局部性：90% 的访问在当前工作集附近，10% 随机访问
+        // 先批量生成随机数，再以无分支的选择组合出地址
+        const uint64_t kLocalThreshold = static_cast<uint64_t>(0.9 * 4294967296.0);
+        scratch_.resize(count);
+        rng_.fill(scratch_.data(), count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64_t r = scratch_[i];
+            bool local = (r & 0xFFFFFFFFULL) < kLocalThreshold;
+            uint64_t base = ((index_ + i) / workload_.working_set_period) * workload_.working_set_size;
+            // 低 32 位决定是否局部访问，按比例缩放（主要取决于高位）得到偏移
+            uint64_t local_offset = Xoshiro256::scale(r, workload_.working_set_size);
+            uint64_t random_offset = Xoshiro256::scale(r, workload_.address_range);
+            addresses[i] = local ? (base + local_offset) % workload_.address_range : random_offset;
+        }
+    }
+
+    void WorkloadStream::fillProducerConsumer(uint64_t *addresses, uint8_t *writes, size_t count)
+    {
+        // 环形队列以字为单位：生产者第 k 次访问写入第 k 个字，
+        // 消费者滞后一整块读取，读到的正是生产者刚写满的块
+        size_t lag = block_size_ / kWordSize;
+        bool producer = rank_ == 0;
+        uint64_t start = index_ + (producer ? 0 : words_ - lag % words_);
+        for (size_t i = 0; i < count; ++i)
+        {
+            addresses[i] = ((start + i) % words_) * kWordSize;
+            writes[i] = producer;
+        }
+    }
+
+    void WorkloadStream::fillMigratory(uint64_t *addresses, uint8_t *writes, size_t count)
+    {
+        // 每个对象占一块，核心每次在一个对象上连续进行 kBurst 次读-改-写，
+        // 第 s 轮组内第 r 个核心访问对象 (s + r)，因此对象在组内核心间依次迁移
+        const size_t kBurst = 4;
+        size_t words_per_object = std::max<size_t>(block_size_ / kWordSize, 1);
+        size_t objects = std::max<size_t>(workload_.address_range / block_size_, 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t k = index_ + i;
+            size_t step = k / (2 * kBurst);
+            size_t object = (step + rank_) % objects;
+            size_t word = (k / 2) % kBurst % words_per_object;
+            addresses[i] = object * block_size_ + word * kWordSize;
+            writes[i] = k & 1; // 先读后写
+        }
+    }
+
+    void WorkloadStream::fillLockContention(uint64_t *addresses, uint8_t *writes, size_t count)
+    {
+        // 每个组的第一块为锁，其后为受保护的数据。每轮：
+        // kSpin 次读锁（测试）、1 次写锁（获取）、kCritical 次读写临界区数据、1 次写锁（释放）
+        const size_t kSpin = 4;
+        const size_t kCritical = 4;
+        const size_t kCycle = kSpin + 1 + kCritical + 1;
+        size_t data_words = std::max<size_t>((workload_.address_range - std::min(workload_.address_range, block_size_)) / kWordSize, 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t k = index_ + i;
+            size_t cycle = k / kCycle;
+            size_t phase = k % kCycle;
+            bool in_critical = phase > kSpin && phase <= kSpin + kCritical;
+            size_t data_word = (cycle * kCritical + phase - kSpin - 1) % data_words;
+            addresses[i] = in_critical ? block_size_ + data_word * kWordSize : 0;
+            writes[i] = phase >= kSpin && (!in_critical || (phase & 1));
+        }
+    }
+
+    uint64_t WorkloadStream::nextKey(bool is_write)
+    {
+        switch (workload_.pattern)
+        {
+        case AccessPattern::Zipfian:
+            return zipf_.sample(rng_) - 1;
+        case AccessPattern::ScrambledZipfian:
+            return fnvHash64(zipf_.sample(rng_)) % num_keys_;
+        case AccessPattern::Hotspot:
+        {
+            uint64_t hot_keys = std::min<uint64_t>(
+                std::max<uint64_t>(static_cast<uint64_t>(workload_.hot_fraction * num_keys_), 1), num_keys_);
+            if (rng_.nextDouble() < workload_.hot_access || hot_keys == num_keys_)
+            {
+                return rng_.bounded(hot_keys);
+            }
+            return hot_keys + rng_.bounded(num_keys_ - hot_keys);
+        }
+        case AccessPattern::Latest:
+        {
+            // 键空间视为环形，写入追加的新键覆盖最旧的键
+            if (is_write)
+            {
+                latest_key_ = (latest_key_ + 1) % num_keys_;
+                return latest_key_;
+            }
+            uint64_t age = zipf_.sample(rng_) - 1;
+            return (latest_key_ + num_keys_ - age) % num_keys_;
+        }
+        default:
+            return 0;
+        }
+    }
+
+    void WorkloadStream::fillKeyValue(uint64_t *addresses, uint8_t *writes, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            // 当前对象的各块访问完后再选下一个键，同一对象的所有块读写一致
+            if (object_block_ == object_blocks_)
+            {
+                object_write_ = nextWrite();
+                object_base_ = nextKey(object_write_) * object_size_;
+                object_block_ = 0;
+            }
+            addresses[i] = object_base_ + object_block_ * block_size_;
+            writes[i] = object_write_;
+            ++object_block_;
+        }
+    }
+
+    StreamScheduler::StreamScheduler(const std::vector<unsigned> &weights, StreamInterleave mode)
+        : mode_(mode), weights_(weights.begin(), weights.end()), current_(weights.size(), 0), retired_(weights.size(), false),
+          active_(weights.size()), total_weight_(0), next_core_(0)
+    {
+        for (int64_t weight : weights_)
+        {
+            total_weight_ += weight;
+        }
+        if (mode_ == StreamInterleave::Weighted && total_weight_ <= 0)
+        {
+            std::cerr << "[Warning] 访问流权重之和为 0，改用轮转交织。" << std::endl;
+            mode_ = StreamInterleave::RoundRobin;
+        }
+    }
+
+    size_t StreamScheduler::next()
+    {
+        if (active_ == 0)
+        {
+            return 0;
+        }
+
+        if (mode_ == StreamInterleave::RoundRobin)
+        {
+            while (retired_[next_core_])
+            {
+                next_core_ = (next_core_ + 1) % weights_.size();
+            }
+            size_t core = next_core_;
+            next_core_ = (next_core_ + 1) % weights_.size();
+            return core;
+        }
+
+        // 平滑加权轮转：每轮各核心累加自身权重，选出当前权重最大者并减去总权重，
+        // 使权重为 w 的核心在每 total 次访问中恰好出现 w 次且尽量均匀分布
+        size_t best = weights_.size();
+        for (size_t i = 0; i < weights_.size(); ++i)
+        {
+            if (retired_[i])
+            {
+                continue;
+            }
+            current_[i] += weights_[i];
+            if (best == weights_.size() || current_[i] > current_[best])
+            {
+                best = i;
+            }
+        }
+        current_[best] -= total_weight_;
+        return best;
+    }
+
+    void StreamScheduler::retire(size_t core)
+    {
+        if (core >= retired_.size() || retired_[core])
+        {
+            return;
+        }
+        retired_[core] = true;
+        --active_;
+        total_weight_ -= weights_[core];
+        // 重新开始平滑加权轮转，使剩余核心仍按权重比例交织
+        std::fill(current_.begin(), current_.end(), 0);
+        if (mode_ == StreamInterleave::Weighted && active_ > 0 && total_weight_ <= 0)
+        {
+            // 剩余核心的权重均为 0（如通过库接口构造的配置）
+            mode_ = StreamInterleave::RoundRobin;
+        }
+    }
+
+} // namespace cache_sim
@@ -0,0 +1,69 @@
+#include "write_buffer.h"
+
+namespace cache_sim
+{
+    WriteBuffer::WriteBuffer(size_t num_entries, size_t block_size)
+        : num_entries_(std::max<size_t>(num_entries, 1)), block_size_(block_size)
+    {
+    }
+
+    WriteBufferDrain WriteBuffer::add(uint64_t block_address, size_t offset, size_t size, bool &coalesced)
+    {
+        WriteBufferDrain drained;
+
+        // 查找同一块的条目进行合并
+        auto it = std::find_if(entries_.begin(), entries_.end(),
+                               [block_address](const Entry &entry)
+                               { return entry.block_address == block_address; });
+        coalesced = it != entries_.end();
+
+        if (!coalesced)
+        {
+            if (entries_.size() >= num_entries_)
+            {
+                drained = drainOldest();
+            }
+            entries_.push_back(Entry{block_address, std::vector<uint64_t>((block_size_ + 63) / 64, 0)});
+            it = entries_.end() - 1;
+        }
+
+        size_t end = std::min(offset + size, block_size_);
+        for (size_t byte = offset; byte < end; ++byte)
+        {
+            it->byte_mask[byte / 64] |= uint64_t(1) << (byte % 64);
+        }
+        return drained;
+    }
+
+    WriteBufferDrain WriteBuffer::flush()
+    {
+        WriteBufferDrain drained;
+        while (!entries_.empty())
+        {
+            WriteBufferDrain one = drainOldest();
+            drained.writes += one.writes;
+            drained.bytes += one.bytes;
+            drained.blocks.push_back(one.blocks.front());
+        }
+        return drained;
+    }
+
+    WriteBufferDrain WriteBuffer::drainOldest()
+    {
+        WriteBufferDrain drained;
+        if (entries_.empty())
+        {
+            return drained;
+        }
+
+        for (uint64_t word : entries_.front().byte_mask)
+        {
+            drained.bytes += __builtin_popcountll(word);
+        }
+        drained.writes = 1;
+        drained.blocks.push_back(entries_.front().block_address);
+        entries_.pop_front();
+        return drained;
+    }
+
+} // namespace cache_sim
@@ -0,0 +1,68 @@
+#include "zipf.h"
+
+namespace cache_sim
+{
+    ZipfSampler::ZipfSampler(uint64_t n, double theta)
+        : n_(std::max<uint64_t>(n, 1)), theta_(std::max(theta, 0.0))
+    {
+        h_integral_x1_ = hIntegral(1.5) - 1.0;
+        h_integral_n_ = hIntegral(static_cast<double>(n_) + 0.5);
+        s_ = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+    }
+
+    double ZipfSampler::h(double x) const
+    {
+        return std::exp(-theta_ * std::log(x));
+    }
+
+    double ZipfSampler::hIntegral(double x) const
+    {
+        double log_x = std::log(x);
+        return helper2((1.0 - theta_) * log_x) * log_x;
+    }
+
+    double ZipfSampler::hIntegralInverse(double x) const
+    {
+        double t = x * (1.0 - theta_);
+        if (t < -1.0)
+        {
+            // 数值误差可能使 t 略小于 -1
+            t = -1.0;
+        }
+        return std::exp(helper1(t) * x);
+    }
+
+    double ZipfSampler::helper1(double x)
+    {
+        if (std::abs(x) > 1e-8)
+        {
+            return std::log1p(x) / x;
+        }
+        return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+
+    double ZipfSampler::helper2(double x)
+    {
+        if (std::abs(x) > 1e-8)
+        {
+            return std::expm1(x) / x;
+        }
+        return 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+
+    uint64_t fnvHash64(uint64_t value)
+    {
+        const uint64_t kOffsetBasis = 0xCBF29CE484222325ULL;
+        const uint64_t kPrime = 1099511628211ULL;
+
+        uint64_t hash = kOffsetBasis;
+        for (int i = 0; i < 8; ++i)
+        {
+            hash ^= value & 0xFF;
+            hash *= kPrime;
+            value >>= 8;
+        }
+        return hash;
+    }
+
+} // namespace cache_sim
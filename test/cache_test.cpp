@@ -2,6 +2,17 @@
 #include "lru_cache.h"
 #include "lfu_cache.h"
 #include "bus.h"
+#include "reuse_distance.h"
+#include "interval_stats.h"
+#include "sharing_detector.h"
+#include "workload.h"
+#include "zipf.h"
+#include "random.h"
+#include "trace.h"
+#include "virtual_memory.h"
+#include "page_cache.h"
+#include "cache_simulator.h"
+#include "cachesim.h"
 
 using namespace cache_sim;
 
@@ -26,6 +37,74 @@ TEST(BaseCache, ParseAddress)
     EXPECT_EQ(block_offset, 8); // 测试 Block Offset
 }
 
+// 各组索引函数下由组索引与标签还原地址测试
+TEST(BaseCache, IndexFunctionsReconstructAddress)
+{
+    const IndexFunction functions[] = {IndexFunction::Modulo, IndexFunction::XorFold,
+                                       IndexFunction::PrimeModulo, IndexFunction::Skewed};
+    for (IndexFunction function : functions)
+    {
+        CacheConfig config(1024, 16, 4, function);
+        LRUCache cache(config);
+
+        uint64_t address = 0x12345678;
+        for (int i = 0; i < 1000; ++i)
+        {
+            address = address * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint64_t block_address = address & ~uint64_t(15);
+            for (size_t way = 0; way < config.associativity; ++way)
+            {
+                size_t set_index = cache.getSetIndex(address, way);
+                ASSERT_LT(set_index, cache.getNumIndexedSets());
+                EXPECT_EQ(cache.reconstructAddress(set_index, cache.getTag(address), way), block_address);
+            }
+        }
+    }
+
+    // 16 组时素数取模只使用前 13 组
+    LRUCache prime_cache(CacheConfig(1024, 16, 4, IndexFunction::PrimeModulo));
+    EXPECT_EQ(prime_cache.getNumIndexedSets(), 13u);
+    EXPECT_EQ(prime_cache.getSetIndex(13 * 16), 0u);
+}
+
+// 异或折叠索引消除 2 的幂步长冲突测试
+TEST(BaseCache, XorFoldAvoidsPowerOfTwoStride)
+{
+    // 16 组、2 路；步长 256 字节的地址在取模索引下全部映射到组 0
+    CacheConfig modulo_config(512, 16, 2, IndexFunction::Modulo);
+    CacheConfig xor_config(512, 16, 2, IndexFunction::XorFold);
+    LRUCache modulo_cache(modulo_config);
+    LRUCache xor_cache(xor_config);
+
+    for (int round = 0; round < 2; ++round)
+    {
+        for (uint64_t i = 0; i < 8; ++i)
+        {
+            modulo_cache.read(i * 0x100);
+            xor_cache.read(i * 0x100);
+        }
+    }
+
+    EXPECT_EQ(modulo_cache.getStats().hits, 0);
+    EXPECT_EQ(xor_cache.getStats().hits, 8);
+}
+
+// 斜相联缓存读写测试
+TEST(BaseCache, SkewedAssociative)
+{
+    CacheConfig config(512, 16, 2, IndexFunction::Skewed);
+    LRUCache cache(config);
+
+    uint64_t A = 0x0000;
+    uint64_t B = 0x0100;
+
+    EXPECT_FALSE(cache.read(A));
+    EXPECT_FALSE(cache.write(B, 0x1));
+    EXPECT_TRUE(cache.read(A));
+    EXPECT_TRUE(cache.read(B));
+    EXPECT_NE(cache.findLine(A), cache.findLine(B));
+}
+
 // LRU 缓存读写基本功能测试
 TEST(LRUCache, ReadWrite_Basic)
 {
@@ -168,6 +247,281 @@ TEST(CacheStats, ConflictRate)
     EXPECT_DOUBLE_EQ(stats.conflictRate(), 1.0 / 3.0);
 }
 
+// 驱逐与写回统计测试
+TEST(CacheStats, EvictionsAndWritebacks)
+{
+    CacheConfig config(512, 16, 2);
+    LRUCache cache(config);
+
+    // 都映射到同一组（index = 0）
+    uint32_t A = 0x0000;
+    uint32_t B = 0x0100;
+    uint32_t C = 0x0200;
+
+    cache.write(A, 0x1); // 未命中，A 为脏行
+    cache.read(B);       // 未命中，组已满：A,B
+    cache.read(C);       // 驱逐脏行 A -> 写回
+    cache.read(A);       // 驱逐干净行 B
+
+    const auto &stats = cache.getStats();
+    EXPECT_EQ(stats.evictions, 2);
+    EXPECT_EQ(stats.writebacks, 1);
+    EXPECT_EQ(stats.bus_transactions, 0); // 未连接总线
+}
+
+// 复用距离基本计算测试
+TEST(ReuseDistance, Basic)
+{
+    ReuseDistanceProfiler profiler(16);
+
+    uint64_t A = 0x000;
+    uint64_t B = 0x010;
+    uint64_t C = 0x020;
+
+    EXPECT_EQ(profiler.access(A), ReuseDistanceProfiler::kColdDistance);
+    EXPECT_EQ(profiler.access(B), ReuseDistanceProfiler::kColdDistance);
+    EXPECT_EQ(profiler.access(A + 4), 1u); // 同一块，中间访问了 B
+    EXPECT_EQ(profiler.access(C), ReuseDistanceProfiler::kColdDistance);
+    EXPECT_EQ(profiler.access(B), 2u);     // 中间访问了 A, C
+    EXPECT_EQ(profiler.access(B), 0u);     // 连续访问
+    EXPECT_EQ(profiler.access(A), 2u);     // 中间访问了 C, B（B 只计一次）
+
+    const ReuseHistogram &hist = profiler.getHistogram();
+    EXPECT_EQ(hist.total, 7u);
+    EXPECT_EQ(hist.cold, 3u);
+    ASSERT_EQ(hist.bins.size(), 3u);
+    EXPECT_EQ(hist.bins[0], 1u); // 距离 0
+    EXPECT_EQ(hist.bins[1], 1u); // 距离 1
+    EXPECT_EQ(hist.bins[2], 2u); // 距离 [2, 3]
+}
+
+// 时间槽压缩与跟踪上限测试
+TEST(ReuseDistance, CompactionAndBound)
+{
+    const size_t num_blocks = 300;
+    ReuseDistanceProfiler profiler(64, 512);
+
+    // 循环访问 300 个块，多次触发压缩后距离仍应为 299
+    for (int round = 0; round < 20; ++round)
+    {
+        for (size_t b = 0; b < num_blocks; ++b)
+        {
+            uint64_t distance = profiler.access(b * 64);
+            if (round > 0)
+            {
+                EXPECT_EQ(distance, num_blocks - 1);
+            }
+        }
+    }
+    EXPECT_EQ(profiler.trackedBlocks(), num_blocks);
+
+    // 访问大量不同的块后，跟踪的块数不超过上限的两倍
+    ReuseDistanceProfiler bounded(64, 4096);
+    for (uint64_t b = 0; b < 100000; ++b)
+    {
+        bounded.access(b * 64);
+    }
+    EXPECT_LE(bounded.trackedBlocks(), 8192u);
+}
+
+// 区间统计输出测试
+TEST(IntervalStats, CsvDeltas)
+{
+    CacheConfig config;
+    config.cache_size = 1024;
+    config.block_size = 16;
+    config.associativity = 4;
+
+    std::vector<std::unique_ptr<Cache>> caches;
+    caches.push_back(std::make_unique<LRUCache>(config));
+
+    std::ostringstream oss;
+    IntervalRecorder recorder(oss, IntervalFormat::Csv, caches.size());
+
+    caches[0]->read(0x1000); // 未命中
+    caches[0]->read(0x1000); // 命中
+    recorder.record(2, caches);
+
+    caches[0]->read(0x1000); // 命中
+    recorder.record(3, caches);
+
+    std::istringstream iss(oss.str());
+    std::string header, first, second;
+    std::getline(iss, header);
+    std::getline(iss, first);
+    std::getline(iss, second);
+
+    EXPECT_EQ(first, "0,0,2,0,2,0,1,1,0,0,0,50.00");
+    EXPECT_EQ(second, "1,2,3,0,1,0,1,0,0,0,0,100.00");
+}
+
+// 组间偏斜度摘要测试
+TEST(SetStats, SkewSummary)
+{
+    SkewSummary uniform = computeSkew(std::vector<uint64_t>{5, 5, 5, 5});
+    EXPECT_EQ(uniform.max, 5);
+    EXPECT_DOUBLE_EQ(uniform.max_mean_ratio, 1.0);
+    EXPECT_NEAR(uniform.gini, 0.0, 1e-12);
+
+    // 所有访问集中在一个组
+    SkewSummary skewed = computeSkew(std::vector<uint64_t>{0, 0, 0, 8});
+    EXPECT_DOUBLE_EQ(skewed.mean, 2.0);
+    EXPECT_DOUBLE_EQ(skewed.max_mean_ratio, 4.0);
+    EXPECT_NEAR(skewed.gini, 0.75, 1e-12);
+}
+
+#ifdef CACHE_SIM_SET_STATS
+// 按组计数测试
+TEST(SetStats, PerSetCounters)
+{
+    CacheConfig config(512, 16, 2);
+    LRUCache cache(config);
+
+    cache.read(0x0000); // 组 0 未命中
+    cache.read(0x0100); // 组 0 未命中
+    cache.read(0x0200); // 组 0 未命中并驱逐
+    cache.read(0x0200); // 组 0 命中
+    cache.read(0x0010); // 组 1 未命中
+
+    const auto &sets = cache.getSetStats();
+    EXPECT_EQ(sets[0].accesses, 4);
+    EXPECT_EQ(sets[0].misses, 3);
+    EXPECT_EQ(sets[0].evictions, 1);
+    EXPECT_EQ(sets[1].accesses, 1);
+    EXPECT_EQ(sets[2].accesses, 0);
+}
+#endif
+
+// 受害者缓存吸收冲突缺失测试
+TEST(VictimCache, AbsorbsConflictMisses)
+{
+    CacheConfig config(512, 16, 2);
+    config.victim_cache_entries = 2;
+    LRUCache cache(config);
+
+    // 都映射到同一组（index = 0），3 个块在 2 路组中轮流访问
+    uint32_t A = 0x0000;
+    uint32_t B = 0x0100;
+    uint32_t C = 0x0200;
+
+    cache.write(A, 0x1); // 未命中
+    cache.read(B);       // 未命中
+    cache.read(C);       // 未命中，A 进入受害者缓存（脏数据不写回）
+    EXPECT_EQ(cache.getStats().writebacks, 0);
+
+    EXPECT_FALSE(cache.read(A)); // L1 缺失，受害者缓存命中并与 B 交换
+    ASSERT_NE(cache.findLine(A), nullptr);
+    EXPECT_EQ(cache.findLine(A)->state, MESIState::Modified);
+    EXPECT_TRUE(cache.findLine(A)->dirty);
+
+    EXPECT_FALSE(cache.read(B)); // 再次命中受害者缓存
+
+    const auto &stats = cache.getStats();
+    EXPECT_EQ(stats.misses, 5);
+    EXPECT_EQ(stats.victim_hits, 2);
+    EXPECT_EQ(stats.victim_swaps, 2);
+    EXPECT_EQ(stats.victim_absorbed_conflicts, 2);
+    EXPECT_EQ(stats.writebacks, 0);
+}
+
+// 受害者缓存参与总线嗅探测试
+TEST(VictimCache, Coherence)
+{
+    CacheConfig config(512, 16, 2);
+    config.victim_cache_entries = 2;
+
+    Bus bus;
+    LRUCache cache1(config, 0, &bus);
+    LRUCache cache2(config, 1, &bus);
+    bus.attach(&cache1);
+    bus.attach(&cache2);
+
+    uint32_t A = 0x0000;
+    cache1.write(A, 0x1);
+    cache1.read(0x0100);
+    cache1.read(0x0200); // A 以 Modified 状态进入 cache1 的受害者缓存
+
+    // cache2 写 A 时 cache1 受害者缓存中的副本应被写回并失效
+    cache2.write(A, 0x2);
+    EXPECT_EQ(cache1.getStats().writebacks, 1);
+    EXPECT_FALSE(cache1.read(A));
+    EXPECT_EQ(cache1.getStats().victim_hits, 0);
+}
+
+// 缺失缓存测试
+TEST(VictimCache, MissCache)
+{
+    CacheConfig config(512, 16, 1);
+    config.victim_cache_entries = 4;
+    config.victim_cache_mode = VictimCacheMode::Miss;
+    LRUCache cache(config);
+
+    // 直接映射下 A、B 互相冲突
+    uint32_t A = 0x0000;
+    uint32_t B = 0x0200;
+
+    cache.read(A);
+    cache.read(B);               // 驱逐 A，缺失缓存仍保留 A 的副本
+    EXPECT_FALSE(cache.read(A)); // 从缺失缓存装回
+    EXPECT_FALSE(cache.read(B));
+
+    const auto &stats = cache.getStats();
+    EXPECT_EQ(stats.victim_hits, 2);
+    EXPECT_EQ(stats.victim_absorbed_conflicts, 2);
+    EXPECT_EQ(stats.victim_swaps, 0);
+}
+
+// 写直达与合并写缓冲测试
+TEST(WritePolicy, WriteThroughWithBuffer)
+{
+    CacheConfig config(512, 16, 2);
+    config.write_policy = WritePolicy::WriteThrough;
+    config.write_buffer_entries = 2;
+    LRUCache cache(config);
+
+    cache.write(0x0000, 0x1); // 未命中，分配后写直达
+    cache.write(0x0001, 0x2); // 命中，与同一块的写入合并
+    cache.write(0x0001, 0x3); // 命中，同一字节再次合并
+    cache.write(0x0010, 0x4); // 另一块
+    EXPECT_FALSE(cache.findLine(0x0000)->dirty);
+    EXPECT_EQ(cache.findLine(0x0000)->state, MESIState::Exclusive);
+    EXPECT_EQ(cache.getStats().memory_writes, 0);
+
+    cache.write(0x0020, 0x5); // 写缓冲已满，排空最早的一项（2 字节）
+    EXPECT_EQ(cache.getStats().memory_writes, 1);
+    EXPECT_EQ(cache.getStats().memory_write_bytes, 2);
+
+    cache.flushWriteBuffer();
+    const auto &stats = cache.getStats();
+    EXPECT_EQ(stats.memory_writes, 3);
+    EXPECT_EQ(stats.memory_write_bytes, 4);
+    EXPECT_EQ(stats.write_buffer_coalesced, 2);
+    EXPECT_EQ(stats.writebacks, 0);
+}
+
+// 写回与写不分配测试
+TEST(WritePolicy, WriteBackNoAllocate)
+{
+    CacheConfig config(512, 16, 2);
+    config.write_allocate = false;
+    LRUCache cache(config);
+
+    EXPECT_FALSE(cache.write(0x0000, 0x1)); // 写缺失不分配，直接写往主存
+    EXPECT_EQ(cache.findLine(0x0000), nullptr);
+    EXPECT_EQ(cache.getStats().memory_write_bytes, 1);
+
+    cache.read(0x0000);
+    EXPECT_TRUE(cache.write(0x0000, 0x2)); // 写命中只修改缓存行
+    cache.read(0x0100);
+    cache.read(0x0200); // 驱逐脏行，写回整个块
+
+    const auto &stats = cache.getStats();
+    EXPECT_EQ(stats.dirty_evictions, 1);
+    EXPECT_EQ(stats.writebacks, 1);
+    EXPECT_EQ(stats.memory_writes, 2);
+    EXPECT_EQ(stats.memory_write_bytes, 1 + 16);
+}
+
 // MESI 协议一致性测试
 TEST(MESI, Coherence)
 {
@@ -211,3 +565,1255 @@ TEST(MESI, Coherence)
     EXPECT_EQ(line2->state, MESIState::Shared);
     EXPECT_EQ(line1->state, MESIState::Shared);
 }
+
+// MESI 总线流量统计测试
+TEST(MESI, BusTraffic)
+{
+    CacheConfig config;
+    config.cache_size = 1024;
+    config.block_size = 16;
+    config.associativity = 4;
+
+    Bus bus;
+    LRUCache cache1(config, 0, &bus);
+    LRUCache cache2(config, 1, &bus);
+    bus.attach(&cache1);
+    bus.attach(&cache2);
+
+    uint64_t addr = 0x1000;
+    cache1.write(addr, 0x11); // BusRdX，主存供数
+    cache2.read(addr);        // BusRd，Cache1 写回并供数
+    cache1.write(addr, 0x22); // BusUpgr，Cache2 失效
+
+    const BusStats &stats = bus.getStats();
+    EXPECT_EQ(stats.bus_rdx, 1);
+    EXPECT_EQ(stats.bus_rd, 1);
+    EXPECT_EQ(stats.bus_upgr, 1);
+    EXPECT_EQ(stats.flushes, 1);
+    EXPECT_EQ(stats.cache_to_cache, 1);
+    EXPECT_EQ(stats.memory_reads, 1);
+    EXPECT_EQ(stats.invalidations, 1);
+    EXPECT_EQ(stats.transactions(), 3);
+}
+
+// MOESI: Modified 行被读取时转为 Owned，不写回主存
+TEST(MOESI, OwnedSharing)
+{
+    CacheConfig config;
+    config.cache_size = 1024;
+    config.block_size = 16;
+    config.associativity = 4;
+    config.coherence_protocol = CoherenceProtocol::MOESI;
+
+    Bus bus;
+    LRUCache cache1(config, 0, &bus);
+    LRUCache cache2(config, 1, &bus);
+    LRUCache cache3(config, 2, &bus);
+    bus.attach(&cache1);
+    bus.attach(&cache2);
+    bus.attach(&cache3);
+
+    uint64_t addr = 0x1000;
+    cache1.write(addr, 0x11);
+    cache2.read(addr);
+
+    CacheLine *line1 = cache1.findLine(addr);
+    CacheLine *line2 = cache2.findLine(addr);
+    ASSERT_NE(line1, nullptr);
+    ASSERT_NE(line2, nullptr);
+    EXPECT_EQ(line1->state, MESIState::Owned);
+    EXPECT_TRUE(line1->dirty);
+    EXPECT_EQ(line2->state, MESIState::Shared);
+    EXPECT_EQ(bus.getStats().flushes, 0);
+    EXPECT_EQ(bus.getStats().cache_to_cache, 1);
+    EXPECT_EQ(cache1.getStats().writebacks, 0);
+
+    // Owned 行再次写入需要 BusUpgr 作废其他副本
+    cache1.write(addr, 0x22);
+    EXPECT_EQ(line1->state, MESIState::Modified);
+    EXPECT_FALSE(line2->valid);
+    EXPECT_EQ(bus.getStats().bus_upgr, 1);
+
+    // 第三个核心写缺失 Owned 块：脏数据经缓存间传输交给请求者，不写回主存
+    cache2.read(addr);
+    EXPECT_EQ(line1->state, MESIState::Owned);
+    uint64_t transfers = bus.getStats().cache_to_cache;
+    uint64_t rdx = bus.getStats().bus_rdx;
+    EXPECT_FALSE(cache3.write(addr, 0x33));
+    EXPECT_EQ(bus.getStats().bus_rdx, rdx + 1);
+    CacheLine *line3 = cache3.findLine(addr);
+    ASSERT_NE(line3, nullptr);
+    EXPECT_EQ(line3->state, MESIState::Modified);
+    EXPECT_TRUE(line3->dirty);
+    EXPECT_EQ(cache1.findLine(addr), nullptr);
+    EXPECT_EQ(cache2.findLine(addr), nullptr);
+    EXPECT_EQ(bus.getStats().cache_to_cache, transfers + 1);
+    EXPECT_EQ(cache1.getStats().writebacks, 0);
+    EXPECT_EQ(bus.getStats().flushes, 0);
+}
+
+// MESIF: 最近的请求者成为 Forward，由其负责供数
+TEST(MESIF, ForwardMigration)
+{
+    CacheConfig config;
+    config.cache_size = 1024;
+    config.block_size = 16;
+    config.associativity = 4;
+    config.coherence_protocol = CoherenceProtocol::MESIF;
+
+    Bus bus;
+    LRUCache cache1(config, 0, &bus);
+    LRUCache cache2(config, 1, &bus);
+    LRUCache cache3(config, 2, &bus);
+    bus.attach(&cache1);
+    bus.attach(&cache2);
+    bus.attach(&cache3);
+
+    uint64_t addr = 0x1000;
+    cache1.read(addr);
+    cache2.read(addr);
+    CacheLine *line1 = cache1.findLine(addr);
+    CacheLine *line2 = cache2.findLine(addr);
+    ASSERT_NE(line1, nullptr);
+    ASSERT_NE(line2, nullptr);
+    EXPECT_EQ(line1->state, MESIState::Shared);
+    EXPECT_EQ(line2->state, MESIState::Forward);
+
+    cache3.read(addr);
+    CacheLine *line3 = cache3.findLine(addr);
+    ASSERT_NE(line3, nullptr);
+    EXPECT_EQ(line2->state, MESIState::Shared);
+    EXPECT_EQ(line3->state, MESIState::Forward);
+
+    // 三次读取中后两次由缓存供数
+    EXPECT_EQ(bus.getStats().cache_to_cache, 2);
+    EXPECT_EQ(bus.getStats().memory_reads, 1);
+}
+
+// 真共享 / 伪共享检测测试
+TEST(SharingDetector, TrueAndFalseSharing)
+{
+    CacheConfig config;
+    config.cache_size = 1024;
+    config.block_size = 64;
+    config.associativity = 4;
+
+    Bus bus;
+    LRUCache cache0(config, 0, &bus);
+    LRUCache cache1(config, 1, &bus);
+    bus.attach(&cache0);
+    bus.attach(&cache1);
+
+    SharingDetector detector(config.block_size, 2);
+    bus.setSharingDetector(&detector);
+
+    auto access = [&](size_t core, uint64_t address, bool is_write)
+    {
+        detector.access(core, address, 1, is_write);
+        Cache &cache = core == 0 ? static_cast<Cache &>(cache0) : static_cast<Cache &>(cache1);
+        if (is_write)
+        {
+            cache.write(address, 0xAB);
+        }
+        else
+        {
+            cache.read(address);
+        }
+    };
+
+    // 伪共享：两个核心写同一块中的不同字节
+    access(0, 0x1000, true);
+    access(1, 0x1008, true); // 作废核心 0 的副本
+    access(0, 0x1000, true); // 核心 0 的一致性缺失，核心 1 只写过 0x1008
+    EXPECT_EQ(detector.falseSharingMisses(), 1);
+    EXPECT_EQ(detector.trueSharingMisses(), 0);
+
+    // 真共享：核心 1 读取核心 0 刚写入的字节
+    access(1, 0x1000, false);
+    EXPECT_EQ(detector.trueSharingMisses(), 1);
+
+    // 写入的数据保存在块内偏移处
+    CacheLine *line = cache0.findLine(0x1000);
+    ASSERT_NE(line, nullptr);
+    EXPECT_EQ(line->data[0], 0xAB);
+
+    std::vector<BlockSharingReport> top = detector.topBlocks(5);
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].block_address, 0x1000u);
+    EXPECT_EQ(top[0].cores, 2u);
+    EXPECT_EQ(top[0].written_bytes, 2u);
+    EXPECT_FALSE(top[0].overlapping_writes);
+}
+
+// 每核心访问流：写比例确定性分布、地址区间与顺序步长
+TEST(Workload, StreamWriteRatioAndRange)
+{
+    CoreWorkload workload;
+    workload.pattern = AccessPattern::Sequential;
+    workload.address_base = 0x100000;
+    workload.address_range = 4 * 64;
+    workload.write_ratio = 0.25;
+
+    WorkloadStream stream(workload, 64, 0, 1, 1);
+    size_t writes = 0;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        uint64_t address;
+        bool is_write;
+        stream.next(address, is_write);
+        EXPECT_EQ(address, 0x100000 + (i % 4) * 64);
+        EXPECT_EQ(is_write, i % 4 == 0);
+        writes += is_write;
+    }
+    EXPECT_EQ(writes, 2u);
+
+    // 非整除比例在长期内也精确
+    workload.write_ratio = 0.3;
+    WorkloadStream ratio_stream(workload, 64, 0, 1, 1);
+    writes = 0;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        uint64_t address;
+        bool is_write;
+        ratio_stream.next(address, is_write);
+        writes += is_write;
+    }
+    EXPECT_EQ(writes, 300u);
+}
+
+// 访问流交织：轮转与平滑加权轮转
+TEST(Workload, SchedulerInterleave)
+{
+    StreamScheduler round_robin({1, 5, 1}, StreamInterleave::RoundRobin);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(round_robin.next(), i % 3);
+    }
+
+    StreamScheduler weighted({1, 3}, StreamInterleave::Weighted);
+    std::vector<size_t> counts(2, 0);
+    std::vector<size_t> order;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        size_t core = weighted.next();
+        counts[core]++;
+        order.push_back(core);
+    }
+    EXPECT_EQ(counts[0], 2u);
+    EXPECT_EQ(counts[1], 6u);
+    // 低权重核心不会连续出现
+    for (size_t i = 1; i < order.size(); ++i)
+    {
+        EXPECT_FALSE(order[i] == 0 && order[i - 1] == 0);
+    }
+}
+
+// 加权交织：trace 读完的核心退出调度，剩余访问全部交给其他核心
+TEST(Workload, WeightedScheduleRetiresExhaustedTrace)
+{
+    StreamScheduler scheduler({3, 1, 2}, StreamInterleave::Weighted);
+    scheduler.retire(0);
+    std::vector<size_t> counts(3, 0);
+    for (size_t i = 0; i < 30; ++i)
+    {
+        counts[scheduler.next()]++;
+    }
+    EXPECT_EQ(counts[0], 0u);
+    EXPECT_EQ(counts[1], 10u);
+    EXPECT_EQ(counts[2], 20u);
+
+    std::string path = "weighted_schedule_test.din";
+    {
+        std::ofstream trace(path);
+        for (int i = 0; i < 10; ++i)
+        {
+            trace << "0 " << std::hex << 0x1000 + i * 64 << "\n";
+        }
+    }
+
+    // 核心 0 的 trace 只有 10 次访问；核心 1 的权重为 0 时也须在 trace 读完后接替
+    for (unsigned weight : {1u, 0u})
+    {
+        SimulatorConfig config(100, 65536, AccessPattern::Random, ReplacementPolicy::LRU, 2);
+        config.trace_files.push_back(path);
+        config.interleave = StreamInterleave::Weighted;
+        config.core_workloads.assign(2, config.defaultWorkload());
+        config.core_workloads[0].weight = 3;
+        config.core_workloads[1].weight = weight;
+
+        CacheSimulator simulator(config);
+        simulator.run();
+        const CacheStats &trace_core = simulator.getCoreStats(0);
+        const CacheStats &generated = simulator.getCoreStats(1);
+        EXPECT_EQ(trace_core.reads + trace_core.writes, 10u);
+        EXPECT_EQ(generated.reads + generated.writes, 90u);
+    }
+    std::remove(path.c_str());
+}
+
+// 共享负载：生产者/消费者与自旋锁竞争
+TEST(Workload, SharingPatterns)
+{
+    CoreWorkload workload;
+    workload.pattern = AccessPattern::ProducerConsumer;
+    workload.address_base = 0x10000;
+    workload.address_range = 4096;
+    workload.sharers = 2;
+
+    // 核心 0、1 为一组，核心 2 属于下一组
+    WorkloadStream producer(workload, 64, 0, 4, 1);
+    WorkloadStream consumer(workload, 64, 1, 4, 1);
+    WorkloadStream other_group(workload, 64, 2, 4, 1);
+
+    std::vector<uint64_t> produced;
+    for (size_t i = 0; i < 16; ++i)
+    {
+        uint64_t address;
+        bool is_write;
+        producer.next(address, is_write);
+        EXPECT_TRUE(is_write);
+        produced.push_back(address);
+
+        consumer.next(address, is_write);
+        EXPECT_FALSE(is_write);
+        // 消费者滞后一块（8 个字）
+        if (i >= 8)
+        {
+            EXPECT_EQ(address, produced[i - 8]);
+        }
+
+        other_group.next(address, is_write);
+        EXPECT_GE(address, 0x10000u + 4096);
+    }
+    EXPECT_EQ(produced[0], 0x10000u);
+    EXPECT_EQ(produced[1], 0x10008u);
+
+    // 锁竞争：前 4 次读锁块，第 5 次写锁块获取锁
+    workload.pattern = AccessPattern::LockContention;
+    WorkloadStream lock(workload, 64, 1, 4, 1);
+    for (size_t i = 0; i < 10; ++i)
+    {
+        uint64_t address;
+        bool is_write;
+        lock.next(address, is_write);
+        bool lock_access = i < 5 || i == 9;
+        EXPECT_EQ(address == 0x10000u, lock_access);
+        EXPECT_EQ(is_write, i >= 4 && (lock_access || (i & 1)));
+    }
+}
+
+// 读多写少共享表：未指定写比例时只有约 2% 的访问为写，组内核心共享同一段数据
+TEST(Workload, ReadMostlyRareWrites)
+{
+    EXPECT_DOUBLE_EQ(defaultWriteRatio(AccessPattern::Random), 0.25);
+
+    CoreWorkload workload;
+    workload.pattern = AccessPattern::ReadMostly;
+    workload.address_range = 4096;
+    workload.write_ratio = defaultWriteRatio(workload.pattern);
+
+    const size_t accesses = 50000;
+    for (size_t core = 0; core < 2; ++core)
+    {
+        WorkloadStream stream(workload, 64, core, 2, 7);
+        size_t writes = 0;
+        for (size_t i = 0; i < accesses; ++i)
+        {
+            uint64_t address;
+            bool is_write;
+            stream.next(address, is_write);
+            writes += is_write ? 1 : 0;
+            ASSERT_LT(address, 4096u);
+        }
+        double fraction = static_cast<double>(writes) / accesses;
+        EXPECT_GT(fraction, 0.0);
+        EXPECT_NEAR(fraction, 0.02, 0.002);
+    }
+}
+
+// Zipf 采样：频率与理论概率一致，大键空间下同样可用
+TEST(Zipf, RejectionInversionSampler)
+{
+    const uint64_t n = 100;
+    const double theta = 0.99;
+    ZipfSampler sampler(n, theta);
+    Xoshiro256 rng(42);
+
+    std::vector<uint64_t> counts(n + 1, 0);
+    const size_t draws = 200000;
+    for (size_t i = 0; i < draws; ++i)
+    {
+        uint64_t k = sampler.sample(rng);
+        ASSERT_GE(k, 1u);
+        ASSERT_LE(k, n);
+        counts[k]++;
+    }
+
+    double norm = 0.0;
+    for (uint64_t k = 1; k <= n; ++k)
+    {
+        norm += 1.0 / std::pow(static_cast<double>(k), theta);
+    }
+    for (uint64_t k : {1, 2, 10})
+    {
+        double expected = draws / std::pow(static_cast<double>(k), theta) / norm;
+        EXPECT_NEAR(static_cast<double>(counts[k]), expected, expected * 0.05);
+    }
+
+    ZipfSampler huge(1000000000ULL, theta);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        uint64_t k = huge.sample(rng);
+        ASSERT_GE(k, 1u);
+        ASSERT_LE(k, 1000000000ULL);
+    }
+}
+
+// 键值模式：对象跨多块时依次访问每一块，读写一致
+TEST(Workload, KeyValueObjects)
+{
+    CoreWorkload workload;
+    workload.pattern = AccessPattern::Hotspot;
+    workload.address_range = 1 << 20;
+    workload.object_size = 200; // 向上取整为 4 块
+    workload.hot_fraction = 0.01;
+    workload.hot_access = 1.0;
+    workload.write_ratio = 0.5;
+
+    WorkloadStream stream(workload, 64, 0, 1, 7);
+    uint64_t hot_limit = static_cast<uint64_t>(0.01 * ((1 << 20) / 256)) * 256;
+    for (size_t object = 0; object < 100; ++object)
+    {
+        uint64_t first;
+        bool first_write;
+        stream.next(first, first_write);
+        EXPECT_EQ(first % 256, 0u);
+        EXPECT_LT(first, hot_limit);
+        for (size_t block = 1; block < 4; ++block)
+        {
+            uint64_t address;
+            bool is_write;
+            stream.next(address, is_write);
+            EXPECT_EQ(address, first + block * 64);
+            EXPECT_EQ(is_write, first_write);
+        }
+    }
+}
+
+// 随机数生成器：批量填充与逐个取数序列一致，不同流互不相同
+TEST(Random, BulkMatchesScalar)
+{
+    Xoshiro256 scalar(123, 1);
+    Xoshiro256 bulk(123, 1);
+
+    std::vector<uint64_t> expected(37);
+    for (auto &value : expected)
+    {
+        value = scalar();
+    }
+
+    // 先取一个再批量取，验证跨越内部缓冲边界时序列不变
+    std::vector<uint64_t> actual(37);
+    actual[0] = bulk();
+    bulk.fill(actual.data() + 1, actual.size() - 1);
+    EXPECT_EQ(actual, expected);
+
+    Xoshiro256 other_stream(123, 2);
+    EXPECT_NE(other_stream(), expected[0]);
+
+    std::vector<uint64_t> bounded(1000);
+    Xoshiro256(7).fillBounded(bounded.data(), bounded.size(), 10);
+    for (uint64_t value : bounded)
+    {
+        EXPECT_LT(value, 10u);
+    }
+}
+
+// 相同种子的两次模拟结果完全相同
+TEST(Random, SeededSimulationIsReproducible)
+{
+    SimulatorConfig config(20000, 1 << 20, AccessPattern::Localized, ReplacementPolicy::LRU, 2);
+    config.seed = 2024;
+
+    CacheSimulator first(config);
+    CacheSimulator second(config);
+    first.run();
+    second.run();
+
+    CacheStats a = first.getAverageStats();
+    CacheStats b = second.getAverageStats();
+    EXPECT_EQ(a.hits, b.hits);
+    EXPECT_EQ(a.misses, b.misses);
+    EXPECT_EQ(a.evictions, b.evictions);
+    EXPECT_EQ(first.getBusStats().invalidations, second.getBusStats().invalidations);
+}
+
+// 文本 trace 解析：din 只保留读写，Lackey 的 M 拆为读 + 写
+TEST(Trace, TextFormats)
+{
+    std::istringstream din("0 1000\n2 4000\n1 0x2040\n\n0 zz\n");
+    DinTraceReader din_reader(din);
+    TraceRecord record;
+    ASSERT_TRUE(din_reader.next(record));
+    EXPECT_EQ(record.address, 0x1000u);
+    EXPECT_FALSE(record.is_write);
+    ASSERT_TRUE(din_reader.next(record));
+    EXPECT_EQ(record.address, 0x2040u);
+    EXPECT_TRUE(record.is_write);
+    EXPECT_FALSE(din_reader.next(record));
+
+    std::istringstream lackey("==1== Lackey\nI  0400d7d4,8\n S 7ff000398,8\n L 04222cac,8\n M 0421d7f8,4\n");
+    LackeyTraceReader lackey_reader(lackey);
+    std::vector<TraceRecord> records;
+    while (lackey_reader.next(record))
+    {
+        records.push_back(record);
+    }
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].address, 0x7ff000398u);
+    EXPECT_TRUE(records[0].is_write);
+    EXPECT_FALSE(records[1].is_write);
+    EXPECT_EQ(records[2].address, 0x421d7f8u);
+    EXPECT_FALSE(records[2].is_write);
+    EXPECT_EQ(records[3].address, 0x421d7f8u);
+    EXPECT_TRUE(records[3].is_write);
+}
+
+// 压缩格式往返：多线程解码按原顺序交付，并可从任意块开始读取
+TEST(Trace, NativeRoundTrip)
+{
+    EXPECT_EQ(zigzagDecode(zigzagEncode(-5)), -5);
+    EXPECT_EQ(zigzagEncode(-1), 1u);
+
+    std::string path = "native_round_trip_test.cst";
+    std::vector<TraceRecord> expected;
+    Xoshiro256 rng(99);
+    uint64_t address = 0x7f0000000000ULL;
+    for (int i = 0; i < 1000; ++i)
+    {
+        address += rng.bounded(2) ? 64 : -static_cast<int64_t>(rng.bounded(1 << 20));
+        expected.push_back(TraceRecord{address, rng.bounded(4) == 0});
+    }
+
+    {
+        NativeTraceWriter writer(path, 7);
+        ASSERT_TRUE(writer.ok());
+        for (const auto &r : expected)
+        {
+            ASSERT_TRUE(writer.add(r));
+        }
+        EXPECT_FALSE(writer.add(TraceRecord{uint64_t(1) << 63, false}));
+        ASSERT_TRUE(writer.close());
+    }
+
+    std::unique_ptr<TraceReader> reader = openTrace(path, TraceFormat::Auto, 3);
+    ASSERT_NE(reader, nullptr);
+    TraceRecord record;
+    size_t count = 0;
+    while (reader->next(record))
+    {
+        ASSERT_LT(count, expected.size());
+        EXPECT_EQ(record.address, expected[count].address);
+        EXPECT_EQ(record.is_write, expected[count].is_write);
+        ++count;
+    }
+    EXPECT_EQ(count, expected.size());
+
+    NativeTraceReader seek(path, 2, 10);
+    ASSERT_TRUE(seek.ok());
+    EXPECT_EQ(seek.numChunks(), (expected.size() + 6) / 7);
+    EXPECT_EQ(seek.totalRecords(), expected.size());
+    ASSERT_TRUE(seek.next(record));
+    EXPECT_EQ(record.address, expected[70].address);
+
+    std::remove(path.c_str());
+}
+
+// trace 无法打开时模拟器报告失败，不以生成的访问流代替（否则运行到 trace 结束的模拟永不结束）
+TEST(Trace, MissingTraceIsFatal)
+{
+    SimulatorConfig config(std::numeric_limits<size_t>::max());
+    config.trace_files.push_back("does_not_exist_test.din");
+    CacheSimulator simulator(config);
+    EXPECT_FALSE(simulator.ok());
+    simulator.run();
+    EXPECT_EQ(simulator.getCoreStats(0).reads + simulator.getCoreStats(0).writes, 0u);
+}
+
+// 损坏的块索引：块数使长度检查溢出，或数据块越过块索引，都应拒绝而不是分配巨大的缓冲
+TEST(Trace, CorruptIndexRejected)
+{
+    std::string path = "corrupt_index_test.cst";
+    {
+        NativeTraceWriter writer(path, 4);
+        ASSERT_TRUE(writer.ok());
+        for (uint64_t i = 0; i < 20; ++i)
+        {
+            ASSERT_TRUE(writer.add(TraceRecord{i * 64, false}));
+        }
+        ASSERT_TRUE(writer.close());
+    }
+    std::string original;
+    {
+        std::ifstream in(path, std::ios::binary);
+        original.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    ASSERT_GT(original.size(), 24u);
+    const size_t trailer = original.size() - 24;
+
+    auto patch = [&](size_t offset, uint64_t value)
+    {
+        std::string bytes = original;
+        for (size_t b = 0; b < 8; ++b)
+        {
+            bytes[offset + b] = static_cast<char>(value >> (8 * b));
+        }
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << bytes;
+    };
+    uint64_t num_chunks = 0;
+    for (size_t b = 0; b < 8; ++b)
+    {
+        num_chunks |= static_cast<uint64_t>(static_cast<uint8_t>(original[trailer + 8 + b])) << (8 * b);
+    }
+    uint64_t index_offset = 0;
+    for (size_t b = 0; b < 8; ++b)
+    {
+        index_offset |= static_cast<uint64_t>(static_cast<uint8_t>(original[trailer + b])) << (8 * b);
+    }
+    EXPECT_EQ(num_chunks, 5u);
+
+    // 块数加 2^60 后乘以 16 溢出为原值
+    patch(trailer + 8, num_chunks + (uint64_t(1) << 60));
+    EXPECT_FALSE(NativeTraceReader(path, 1).ok());
+
+    // 第一个数据块越过块索引
+    patch(index_offset, index_offset);
+    EXPECT_FALSE(NativeTraceReader(path, 1).ok());
+
+    // 第一个数据块位于头部之内
+    patch(index_offset, 0);
+    EXPECT_FALSE(NativeTraceReader(path, 1).ok());
+
+    patch(trailer, index_offset);
+    EXPECT_TRUE(NativeTraceReader(path, 1).ok());
+    std::remove(path.c_str());
+}
+
+// 组采样：未采样组的访问被跳过，外推命中率接近完整模拟
+TEST(SetSampling, EstimateMatchesFullSimulation)
+{
+    SimulatorConfig config(200000, 1 << 22, AccessPattern::Localized, ReplacementPolicy::LRU, 1);
+    config.cache_config = CacheConfig(262144, 64, 8);
+    config.seed = 7;
+
+    CacheSimulator full(config);
+    full.run();
+    double full_hit_rate = full.getAverageStats().hitRate();
+
+    for (SetSampling mode : {SetSampling::Stride, SetSampling::Hashed})
+    {
+        config.cache_config.set_sampling = mode;
+        config.cache_config.sampling_ratio = 8;
+        CacheSimulator sampled(config);
+        sampled.run();
+
+        CacheStats stats = sampled.getAverageStats();
+        EXPECT_GT(stats.unsampled, 0u);
+        EXPECT_EQ(stats.reads + stats.writes + stats.unsampled, config.num_accesses);
+
+        SamplingEstimate estimate = sampled.getSamplingEstimate();
+        EXPECT_EQ(estimate.total_sets, 512u);
+        EXPECT_LT(estimate.sampled_sets, estimate.total_sets);
+        EXPECT_EQ(estimate.sampled_accesses, stats.reads + stats.writes);
+        EXPECT_GT(estimate.miss_rate_ci, 0.0);
+        EXPECT_NEAR(1.0 - estimate.miss_rate, full_hit_rate, 0.01);
+    }
+
+    // 全部组都被采样时没有抽样误差
+    std::vector<SetStats> sets(4);
+    for (size_t i = 0; i < sets.size(); ++i)
+    {
+        sets[i].accesses = 100;
+        sets[i].misses = 10 * i;
+    }
+    SamplingEstimate all = estimateFromSample(sets, 4, 400);
+    EXPECT_DOUBLE_EQ(all.miss_rate, 0.15);
+    EXPECT_DOUBLE_EQ(all.miss_rate_ci, 0.0);
+    EXPECT_GT(estimateFromSample(sets, 64, 6400).miss_rate_ci, 0.0);
+}
+
+// 预热访问不计入统计
+TEST(Checkpoint, WarmupExcludedFromStats)
+{
+    SimulatorConfig config(20000, 1 << 16, AccessPattern::Localized, ReplacementPolicy::LRU, 1);
+    config.seed = 3;
+    CacheSimulator cold(config);
+    cold.run();
+
+    config.warmup_accesses = 20000;
+    CacheSimulator warm(config);
+    warm.run();
+
+    CacheStats stats = warm.getAverageStats();
+    EXPECT_EQ(stats.reads + stats.writes, config.num_accesses);
+    EXPECT_GT(stats.hitRate(), cold.getAverageStats().hitRate());
+}
+
+// 恢复后的缓存与原缓存对后续访问的行为完全相同
+TEST(Checkpoint, SaveLoadRoundTrip)
+{
+    CacheConfig config(4096, 64, 4);
+    config.victim_cache_entries = 4;
+    std::vector<std::unique_ptr<Cache>> originals;
+    std::vector<std::unique_ptr<Cache>> restored;
+    originals.push_back(std::make_unique<LRUCache>(config));
+    originals.push_back(std::make_unique<LFUCache>(config));
+    restored.push_back(std::make_unique<LRUCache>(config));
+    restored.push_back(std::make_unique<LFUCache>(config));
+
+    for (size_t c = 0; c < originals.size(); ++c)
+    {
+        Xoshiro256 rng(11);
+        for (int i = 0; i < 5000; ++i)
+        {
+            uint64_t address = rng.bounded(16384);
+            if (rng.bounded(4) == 0)
+            {
+                originals[c]->write(address, static_cast<uint8_t>(i));
+            }
+            else
+            {
+                originals[c]->read(address);
+            }
+        }
+
+        std::stringstream state;
+        ASSERT_TRUE(originals[c]->saveState(state));
+        ASSERT_TRUE(restored[c]->loadState(state));
+        EXPECT_EQ(restored[c]->getStats().hits + restored[c]->getStats().misses, 0u);
+        originals[c]->resetStats();
+
+        // 相同的后续访问得到相同的命中、驱逐与最终状态
+        for (int i = 0; i < 5000; ++i)
+        {
+            uint64_t address = rng.bounded(16384);
+            bool is_write = rng.bounded(4) == 0;
+            for (Cache *cache : {originals[c].get(), restored[c].get()})
+            {
+                if (is_write)
+                {
+                    cache->write(address, static_cast<uint8_t>(i));
+                }
+                else
+                {
+                    cache->read(address);
+                }
+            }
+        }
+        EXPECT_EQ(originals[c]->getStats().hits, restored[c]->getStats().hits);
+        EXPECT_EQ(originals[c]->getStats().evictions, restored[c]->getStats().evictions);
+        EXPECT_EQ(originals[c]->getStats().victim_hits, restored[c]->getStats().victim_hits);
+
+        std::stringstream a, b;
+        originals[c]->saveState(a);
+        restored[c]->saveState(b);
+        EXPECT_EQ(a.str(), b.str());
+    }
+
+    // 几何参数不一致时拒绝恢复
+    std::stringstream state;
+    originals[0]->saveState(state);
+    LRUCache other(CacheConfig(8192, 64, 4));
+    EXPECT_FALSE(other.loadState(state));
+}
+
+// 虚拟内存：TLB 缺失触发页表遍历，页框不足时置换并击落 TLB
+TEST(VirtualMemory, TranslationFaultsAndReplacement)
+{
+    std::vector<std::unique_ptr<Cache>> caches;
+    caches.push_back(std::make_unique<LRUCache>(CacheConfig(32768, 64, 4)));
+
+    VirtualMemoryConfig config;
+    config.tlb_levels = {{16, 16}};
+    config.physical_frames = 8;
+    config.page_replacement = PageReplacement::LRU;
+    VirtualMemory vm(config, caches);
+
+    // 同一页内的访问只在首次缺页，物理地址保留页内偏移
+    uint64_t first = vm.translate(0, 0x10010, false);
+    EXPECT_EQ(vm.translate(0, 0x10020, true), first + 0x10);
+    EXPECT_EQ(first % 4096, 0x10u);
+    EXPECT_EQ(vm.getStats().page_faults, 1u);
+    EXPECT_EQ(vm.getStats().page_walks, 1u);
+    EXPECT_EQ(vm.getStats().pte_accesses, config.page_table_levels);
+    EXPECT_EQ(vm.getTlbStats(0, 0).hits, 1u);
+
+    // 循环访问 9 个页：LRU 下每次都缺页，被置换页的 TLB 条目被击落
+    vm.resetStats();
+    for (int round = 0; round < 3; ++round)
+    {
+        for (uint64_t page = 0; page < 9; ++page)
+        {
+            vm.translate(0, 0x100000 + page * 4096, true);
+        }
+    }
+    EXPECT_EQ(vm.getStats().page_faults, 27u);
+    EXPECT_EQ(vm.getStats().major_faults, 18u);
+    EXPECT_EQ(vm.getStats().page_evictions, 27u - 7u);
+    EXPECT_EQ(vm.getStats().swap_outs, vm.getStats().page_evictions);
+    EXPECT_EQ(vm.getStats().tlb_shootdowns, vm.getStats().page_evictions);
+    EXPECT_EQ(vm.residentPages(), 8u);
+    EXPECT_EQ(vm.getStats().pte_accesses, vm.getStats().page_walks * config.page_table_levels);
+}
+
+// 作废块时写回脏数据
+TEST(BaseCache, InvalidateWritesBackDirtyBlock)
+{
+    LRUCache cache(CacheConfig(1024, 64, 2));
+    cache.write(0x100, 1);
+    EXPECT_TRUE(cache.invalidate(0x13F));
+    EXPECT_EQ(cache.getStats().writebacks, 1u);
+    EXPECT_EQ(cache.findLine(0x100), nullptr);
+    EXPECT_FALSE(cache.invalidate(0x100));
+}
+
+// 页缓存：顺序读由预读提前装入，随机读不预读，定期回写写出过期脏页
+TEST(PageCache, SequentialReadaheadAndWriteback)
+{
+    PageCacheConfig config;
+    config.max_readahead = 32;
+    config.flush_interval = 10;
+    config.dirty_expire = 20;
+    PageCache page_cache(CacheConfig(1 << 20, 4096, 16), ReplacementPolicy::LRU, config);
+
+    // 顺序读 200 页：只有第一页缺失，其余由逐步增大的预读窗口装入
+    for (uint64_t page = 0; page < 200; ++page)
+    {
+        EXPECT_TRUE(page_cache.access({0, page * 4096, 4096, false}));
+    }
+    EXPECT_EQ(page_cache.getCacheStats().misses, 1u);
+    EXPECT_GT(page_cache.getStats().readahead_windows, 1u);
+    EXPECT_EQ(page_cache.getStats().readahead_hits, 199u);
+    EXPECT_GT(page_cache.getStats().readaheadEfficiency(), 0.75);
+
+    // 跨步随机读不触发预读
+    page_cache.resetStats();
+    for (uint64_t i = 1; i <= 20; ++i)
+    {
+        page_cache.access({1, i * 5 * 4096, 100, false});
+    }
+    EXPECT_EQ(page_cache.getCacheStats().misses, 20u);
+    EXPECT_EQ(page_cache.getStats().readahead_windows, 0u);
+    EXPECT_EQ(page_cache.getStats().disk_reads, 20u);
+
+    // 写入 5 个整页后，定期回写在过期后写出全部脏页
+    page_cache.resetStats();
+    for (uint64_t page = 0; page < 5; ++page)
+    {
+        page_cache.access({2, page * 4096, 4096, true});
+    }
+    EXPECT_EQ(page_cache.dirtyPages(), 5u);
+    EXPECT_EQ(page_cache.getStats().partial_writes, 0u);
+    for (int i = 0; i < 30; ++i)
+    {
+        page_cache.access({0, 0, 4096, false});
+    }
+    EXPECT_EQ(page_cache.getStats().flushed_pages, 5u);
+    EXPECT_EQ(page_cache.getCacheStats().writebacks, 5u);
+    EXPECT_EQ(page_cache.dirtyPages(), 0u);
+
+    EXPECT_FALSE(page_cache.access({PageCache::kMaxFileId, 0, 1, false}));
+}
+
+// 页缓存：长时间运行时预读与脏页记录只跟踪驻留页，关闭定期回写时不积累回写队列
+TEST(PageCache, BookkeepingBoundedByCapacity)
+{
+    PageCacheConfig config;
+    config.max_readahead = 32;
+    config.flush_interval = 0;
+    CacheConfig cache_config(64 * 4096, 4096, 4);
+    PageCache page_cache(cache_config, ReplacementPolicy::LRU, config);
+    size_t capacity = cache_config.cache_size / cache_config.block_size;
+
+    // 交替写入不重复的页并顺序读取多个大文件，页数远超缓存容量
+    for (uint64_t i = 0; i < 20000; ++i)
+    {
+        page_cache.access({1, i * 4096, 4096, true});
+        page_cache.access({2 + i % 3, (i / 3) * 4096, 4096, false});
+        EXPECT_LE(page_cache.dirtyPages(), capacity);
+    }
+    EXPECT_GT(page_cache.getStats().readahead_pages, capacity);
+    EXPECT_GT(page_cache.getCacheStats().writebacks, capacity);
+    EXPECT_LE(page_cache.trackedEntries(), 3 * capacity);
+}
+
+// 多进程调度：各进程地址空间独立，保留时统计进程间驱逐，全部刷新时换入后缺失率上升
+TEST(Processes, ContextSwitchRefillAndInterference)
+{
+    SimulatorConfig config(40000, 32768, AccessPattern::Localized, ReplacementPolicy::LRU, 1, 10000, 8192);
+    config.cache_config = CacheConfig(16384, 64, 4);
+    config.processes_per_core = 2;
+    config.time_slice = 2000;
+    config.refill_window = 200;
+    config.seed = 3;
+
+    CacheSimulator keep(config);
+    keep.run();
+    const std::vector<ProcessStats> &kept = keep.getProcessStats();
+    ASSERT_EQ(kept.size(), 2u);
+    EXPECT_EQ(keep.getContextSwitches(), 19u);
+    EXPECT_EQ(kept[0].accesses + kept[1].accesses, 40000u);
+    EXPECT_EQ(kept[0].slices + kept[1].slices, 20u);
+    EXPECT_EQ(kept[0].foreign_evictions, keep.getEvictedByOthers(1));
+    EXPECT_EQ(kept[1].foreign_evictions, keep.getEvictedByOthers(0));
+    EXPECT_GT(kept[0].foreign_evictions, 0u);
+
+    config.switch_flush = SwitchFlush::Full;
+    CacheSimulator flush(config);
+    flush.run();
+    const std::vector<ProcessStats> &flushed = flush.getProcessStats();
+    EXPECT_EQ(flushed[0].foreign_evictions + flushed[1].foreign_evictions, 0u);
+    EXPECT_GT(flushed[0].flushed_blocks, 0u);
+    EXPECT_GT(flushed[0].refillCost(), 0.0);
+    EXPECT_GT(flushed[0].misses, kept[0].misses);
+}
+
+// 路划分：静态掩码限制各 CLOS 的占用，UCP 把更多的路分给效用更高的进程
+TEST(Partitioning, WayMasksAndUtilityBasedRepartitioning)
+{
+    SimulatorConfig config(200000, 1 << 20, AccessPattern::Localized, ReplacementPolicy::LRU, 1, 1 << 30, 65536);
+    config.cache_config = CacheConfig(131072, 64, 8);
+    config.processes_per_core = 2;
+    config.time_slice = 1000;
+    config.seed = 1;
+    config.process_workloads.assign(2, config.defaultWorkload());
+    config.process_workloads[1].pattern = AccessPattern::Sequential;
+    config.process_workloads[1].address_range = 1 << 24;
+
+    // 流式进程被限制在 2 路中，不再驱逐另一个进程的行
+    config.way_masks = {0xfc, 0x3};
+    CacheSimulator partitioned(config);
+    partitioned.run();
+    std::vector<PartitionStats> partitions = partitioned.getPartitionStats();
+    ASSERT_EQ(partitions.size(), 2u);
+    EXPECT_EQ(partitions[1].occupancy, 2u * 256u);
+    EXPECT_EQ(partitioned.getEvictedByOthers(0), 0u);
+
+    SimulatorConfig unpartitioned = config;
+    unpartitioned.way_masks.clear();
+    CacheSimulator shared(unpartitioned);
+    shared.run();
+    EXPECT_GT(partitions[0].hits, shared.getProcessStats()[0].accesses - shared.getProcessStats()[0].misses);
+
+    // UCP：流式进程没有复用，前瞻算法只给它保留一路
+    config.way_masks.clear();
+    config.ucp_interval = 20000;
+    CacheSimulator ucp(config);
+    ucp.run();
+    partitions = ucp.getPartitionStats();
+    EXPECT_GT(ucp.getRepartitions(), 0u);
+    EXPECT_EQ(partitions[0].way_mask, 0x7fu);
+    EXPECT_EQ(partitions[1].way_mask, 0x80u);
+
+    // 前瞻算法与连续掩码
+    EXPECT_TRUE(isContiguousMask(0x3c));
+    EXPECT_FALSE(isContiguousMask(0x5));
+    EXPECT_EQ(contiguousWayMasks({3, 1}), (std::vector<uint64_t>{0x7, 0x8}));
+}
+
+// DRAM：行命中、空 bank 与行冲突的延迟，FR-FCFS 优先行命中，缓存缺失与写回都送往内存控制器
+TEST(Dram, RowBufferTimingAndFrFcfs)
+{
+    DramConfig dram;
+    MemoryController memory(dram, 64);
+
+    // 行映射：bank 位于地址的 [13, 16) 位，行从第 16 位开始
+    memory.read(0);
+    memory.drain();
+    EXPECT_EQ(memory.getStats().row_empty, 1u);
+    EXPECT_EQ(memory.getStats().read_latency_cycles, 22u + 22u + 4u);
+
+    memory.advance(1000);
+    memory.read(64);
+    memory.drain();
+    EXPECT_EQ(memory.getStats().row_hits, 1u);
+    EXPECT_EQ(memory.getStats().read_latency_cycles, 48u + 22u + 4u);
+
+    memory.advance(1000);
+    memory.read(1 << 16);
+    memory.drain();
+    EXPECT_EQ(memory.getStats().row_conflicts, 1u);
+    EXPECT_EQ(memory.getStats().read_latency_cycles, 74u + 22u + 22u + 22u + 4u);
+
+    // bank 忙时先后到达的冲突请求与命中请求：先服务命中，再预充电打开另一行
+    memory.advance(1000);
+    memory.read((1 << 16) + 192);
+    memory.read(0);
+    memory.read((1 << 16) + 128);
+    memory.drain();
+    EXPECT_EQ(memory.getStats().row_hits, 3u);
+    EXPECT_EQ(memory.getStats().row_conflicts, 2u);
+
+    SimulatorConfig config(20000, 1 << 22, AccessPattern::Sequential, ReplacementPolicy::LRU, 2, 10000, 65536);
+    config.cache_config = CacheConfig(16384, 64, 4);
+    config.seed = 5;
+    config.dram = true;
+    CacheSimulator simulator(config);
+    simulator.run();
+    const MemoryController *controller = simulator.getMemoryController();
+    ASSERT_NE(controller, nullptr);
+    EXPECT_EQ(controller->getStats().reads, simulator.getBusStats().memory_reads);
+    EXPECT_EQ(controller->getStats().writes, simulator.getAverageStats().memory_writes * 2);
+    EXPECT_GT(controller->getStats().rowHitRate(), 0.5);
+    EXPECT_GT(controller->bandwidth(), 0.0);
+    EXPECT_LE(controller->bandwidth(), controller->peakBandwidth());
+}
+
+// 多插槽：跨插槽的读由远程缓存提供，写经互连作废远程副本，内存访问按主节点区分本地与远程
+TEST(Numa, RemoteHitsInvalidationsAndHomeNodes)
+{
+    NumaConfig numa;
+    numa.sockets = 2;
+    Interconnect interconnect(numa, 64);
+    Bus bus0, bus1;
+    interconnect.attach(&bus0);
+    interconnect.attach(&bus1);
+    CacheConfig config(4096, 64, 4);
+    LRUCache cache0(config, 0, &bus0);
+    LRUCache cache1(config, 1, &bus1);
+    bus0.attach(&cache0);
+    bus1.attach(&cache1);
+
+    // 0x1000 所在的页按页交织归属插槽 1
+    EXPECT_EQ(interconnect.homeOf(0x1000, 0), 1u);
+    cache0.write(0x1000, 1);
+    EXPECT_FALSE(cache1.read(0x1000));
+    cache0.write(0x1000, 2);
+    EXPECT_FALSE(cache1.read(0x1000));
+    cache1.read(0x2000);
+
+    const std::vector<NumaSocketStats> &stats = interconnect.getStats();
+    EXPECT_EQ(stats[0].remote_memory, 1u);
+    EXPECT_EQ(stats[0].remote_invalidations, 1u);
+    EXPECT_EQ(stats[1].remote_cache_hits, 2u);
+    EXPECT_EQ(stats[1].remote_memory, 1u);
+    EXPECT_EQ(stats[1].local_memory, 0u);
+    EXPECT_DOUBLE_EQ(interconnect.averageMissLatency(1), (2.0 * 120 + 150) / 3);
+
+    // 整个模拟器：每次缺失恰好归入一种数据来源
+    SimulatorConfig sim_config(50000, 1 << 18, AccessPattern::Random, ReplacementPolicy::LRU, 4, 10000, 65536);
+    sim_config.cache_config = CacheConfig(16384, 64, 4);
+    sim_config.seed = 2;
+    sim_config.numa_config.sockets = 2;
+    sim_config.numa_config.interleave = NumaInterleave::FirstTouch;
+    CacheSimulator simulator(sim_config);
+    simulator.run();
+    ASSERT_NE(simulator.getInterconnect(), nullptr);
+    uint64_t sources = 0;
+    for (const NumaSocketStats &socket : simulator.getInterconnect()->getStats())
+    {
+        sources += socket.local_transfers + socket.remote_cache_hits + socket.local_memory + socket.remote_memory;
+    }
+    BusStats bus = simulator.getBusStats();
+    EXPECT_EQ(sources, bus.memory_reads + bus.cache_to_cache);
+    EXPECT_GT(simulator.getInterconnect()->getStats()[1].remote_cache_hits, 0u);
+}
+
+// 压缩缓存：BDI 与 FPC 编码大小、SSE2 与标量实现一致，可压缩的数据使一组容纳多于路数的块
+TEST(Compression, EncodingsAndEffectiveCapacity)
+{
+    uint8_t block[64] = {};
+    EXPECT_EQ(bdiCompress(block, 64).encoding, BdiEncoding::Zeros);
+    EXPECT_EQ(fpcCompress(block, 64).bytes, 2u);
+
+    // 同一区域内的指针：8 字节基址 + 2 字节差值，夹杂的小整数以零为基址
+    for (size_t i = 0; i < 8; ++i)
+    {
+        uint64_t value = i == 3 ? 5 : 0x00007f1234560000ULL + i * 1000;
+        std::memcpy(block + i * 8, &value, 8);
+    }
+    EXPECT_EQ(bdiCompress(block, 64).encoding, BdiEncoding::Base8Delta2);
+    EXPECT_EQ(bdiCompress(block, 64).bytes, 24u);
+
+    // 4 字节小整数（含负数）
+    for (size_t i = 0; i < 16; ++i)
+    {
+        int32_t value = static_cast<int32_t>(i) * 7 - 50;
+        std::memcpy(block + i * 4, &value, 4);
+    }
+    EXPECT_EQ(bdiCompress(block, 64).encoding, BdiEncoding::Base4Delta1);
+    EXPECT_LT(fpcCompress(block, 64).bytes, 32u);
+
+    Xoshiro256 rng(9);
+    for (int trial = 0; trial < 1000; ++trial)
+    {
+        for (size_t i = 0; i < 64; i += 8)
+        {
+            uint64_t value = 0x1000 + rng.bounded(trial % 2 ? 1 << 20 : 200);
+            std::memcpy(block + i, &value, 8);
+        }
+        block[rng.bounded(64)] ^= static_cast<uint8_t>(rng());
+        CompressedSize simd = bdiCompress(block, 64);
+        CompressedSize scalar = bdiCompressScalar(block, 64);
+        ASSERT_EQ(simd.bytes, scalar.bytes);
+        ASSERT_EQ(simd.encoding, scalar.encoding);
+    }
+
+    // 全零数据：一组 2 路数据空间、8 个标签，循环访问 4 个块只有首次缺失
+    CacheConfig config(128, 64, 2);
+    CompressionConfig compression;
+    compression.tag_factor = 4;
+    MemoryImage zeros(64, ValueModel::Zero, 0);
+    CompressedCache cache(config, compression, &zeros);
+    for (int round = 0; round < 3; ++round)
+    {
+        for (uint64_t block_address = 0; block_address < 4; ++block_address)
+        {
+            cache.access(block_address * 64, false);
+        }
+    }
+    EXPECT_EQ(cache.getStats().misses, 4u);
+    EXPECT_EQ(cache.effectiveCapacity(), 4u * 64);
+    EXPECT_EQ(cache.physicalCapacity(), 128u);
+    EXPECT_DOUBLE_EQ(cache.compressionRatio(), 8.0);
+
+    // 写入随机值使块变大，为腾出空间驱逐同组的其他块
+    zeros.write(0, 0x0123456789abcdefULL);
+    zeros.write(8, 0xfedcba9876543210ULL);
+    EXPECT_TRUE(cache.access(0, true));
+    EXPECT_EQ(cache.residentBlocks(), 4u);
+    zeros.write(64, 0x0123456789abcdefULL);
+    zeros.write(72, 0xfedcba9876543210ULL);
+    EXPECT_TRUE(cache.access(64, true));
+    EXPECT_EQ(cache.getStats().size_changes, 2u);
+    EXPECT_EQ(cache.getStats().growth_evictions, 2u);
+    EXPECT_EQ(cache.residentBlocks(), 2u);
+    MemoryImage random(64, ValueModel::Random, 0);
+    CompressedCache incompressible(config, compression, &random);
+    for (uint64_t block_address = 0; block_address < 4; ++block_address)
+    {
+        incompressible.access(block_address * 64, false);
+    }
+    EXPECT_EQ(incompressible.residentBlocks(), 2u);
+    EXPECT_DOUBLE_EQ(incompressible.compressionRatio(), 1.0);
+
+    // 整个模拟器：压缩缓存的命中率不低于同几何的未压缩缓存
+    SimulatorConfig sim_config(50000, 1 << 16, AccessPattern::Localized, ReplacementPolicy::LRU, 1, 10000, 65536);
+    sim_config.cache_config = CacheConfig(8192, 64, 4);
+    sim_config.compression = true;
+    sim_config.compression_config.value_model = ValueModel::Pointer;
+    CacheSimulator simulator(sim_config);
+    simulator.run();
+    ASSERT_EQ(simulator.getCompressedCaches().size(), 1u);
+    const CompressedCache &compressed = *simulator.getCompressedCaches()[0];
+    EXPECT_GE(compressed.getStats().hitRate(), simulator.getAverageStats().hitRate());
+    EXPECT_GT(compressed.effectiveCapacity(), compressed.physicalCapacity());
+}
+
+// 分扇区缓存：标签命中但扇区无效计为扇区缺失，只取回所访问的扇区，驱逐时只写回脏扇区
+TEST(Sectors, SectorMissesAndPartialWriteback)
+{
+    CacheConfig config(1024, 256, 2);
+    config.sector_size = 64;
+    LRUCache cache(config);
+    EXPECT_EQ(cache.getSectorsPerBlock(), 4u);
+
+    EXPECT_FALSE(cache.read(0));
+    EXPECT_TRUE(cache.read(8));
+    EXPECT_FALSE(cache.read(64));
+    EXPECT_TRUE(cache.read(100));
+    EXPECT_FALSE(cache.write(128, 1));
+    EXPECT_TRUE(cache.write(130, 2));
+
+    const CacheStats &stats = cache.getStats();
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.sector_misses, 2u);
+    EXPECT_EQ(stats.bytes_fetched, 3u * 64);
+    EXPECT_DOUBLE_EQ(stats.sectorMissRate(), 2.0 / 6);
+    EXPECT_DOUBLE_EQ(stats.tagMissRate(), 1.0 / 6);
+
+    // 组 0 的另外两个块驱逐块 0，只写回脏扇区
+    cache.read(512);
+    cache.read(1024);
+    EXPECT_EQ(stats.writebacks, 1u);
+    EXPECT_EQ(stats.memory_write_bytes, 64u);
+    EXPECT_FALSE(cache.read(0));
+
+    // 不分扇区时整块取回与写回
+    LRUCache whole(CacheConfig(1024, 256, 2));
+    whole.write(0, 1);
+    EXPECT_TRUE(whole.read(64));
+    whole.read(512);
+    whole.read(1024);
+    EXPECT_EQ(whole.getStats().bytes_fetched, 3u * 256);
+    EXPECT_EQ(whole.getStats().memory_write_bytes, 256u);
+    EXPECT_EQ(whole.getStats().sector_misses, 0u);
+}
+
+// C 接口：批量访问直接读取调用者的数组，统计与 C++ 类一致，无效参数返回 NULL / -1 而不抛出异常
+TEST(CApi, BatchAccessAndStats)
+{
+    EXPECT_EQ(cachesim_abi_version(), CACHESIM_ABI_VERSION);
+
+    cachesim_config config;
+    cachesim_config_init(&config);
+    config.block_size = 48;
+    EXPECT_EQ(cachesim_cache_create(&config), nullptr);
+    EXPECT_STRNE(cachesim_last_error(), "");
+
+    cachesim_config_init(&config);
+    config.cache_size = 1024;
+    config.block_size = 64;
+    config.associativity = 2;
+    cachesim_cache *cache = cachesim_cache_create(&config);
+    ASSERT_NE(cache, nullptr);
+
+    const uint64_t addresses[] = {0, 8, 64, 0, 512, 1024, 0};
+    const uint8_t writes[] = {0, 1, 0, 0, 0, 0, 0};
+    uint8_t hits[7];
+    EXPECT_EQ(cachesim_cache_access_batch(cache, addresses, writes, 7, hits), 2u);
+    const uint8_t expected[] = {0, 1, 0, 1, 0, 0, 0};
+    for (size_t i = 0; i < 7; ++i)
+    {
+        EXPECT_EQ(hits[i], expected[i]) << "访问 " << i;
+    }
+
+    cachesim_stats stats;
+    cachesim_cache_get_stats(cache, &stats);
+    EXPECT_EQ(stats.reads, 6u);
+    EXPECT_EQ(stats.writes, 1u);
+    EXPECT_EQ(stats.misses, 5u);
+    EXPECT_EQ(stats.writebacks, 1u);
+    cachesim_cache_reset_stats(cache);
+    EXPECT_EQ(cachesim_cache_access(cache, 1024, 0), 1);
+    cachesim_cache_get_stats(cache, &stats);
+    EXPECT_EQ(stats.hits, 1u);
+    cachesim_cache_destroy(cache);
+
+    // 两个核心：核心 1 写核心 0 读过的块，作废核心 0 的副本
+    config.num_cores = 2;
+    cachesim_simulator *simulator = cachesim_simulator_create(&config);
+    ASSERT_NE(simulator, nullptr);
+    const uint64_t shared[] = {0, 0, 0};
+    const uint32_t cores[] = {0, 1, 0};
+    const uint8_t shared_writes[] = {0, 1, 0};
+    EXPECT_EQ(cachesim_simulator_access_batch(simulator, shared, cores, shared_writes, 3), 0);
+    const uint32_t bad_cores[] = {0, 2};
+    EXPECT_EQ(cachesim_simulator_access_batch(simulator, shared, bad_cores, nullptr, 2), -1);
+
+    cachesim_bus_stats bus;
+    cachesim_simulator_get_bus_stats(simulator, &bus);
+    EXPECT_EQ(bus.invalidations, 1u);
+    EXPECT_EQ(bus.cache_to_cache, 1u);
+    EXPECT_EQ(cachesim_simulator_get_core_stats(simulator, 0, &stats), 0);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(cachesim_simulator_get_core_stats(simulator, 2, &stats), -1);
+
+    // 生成的访问流补足 num_accesses 次
+    cachesim_simulator_reset_stats(simulator);
+    cachesim_simulator_run(simulator);
+    cachesim_simulator_get_total_stats(simulator, &stats);
+    EXPECT_EQ(stats.reads + stats.writes, config.num_accesses - 3);
+    cachesim_simulator_destroy(simulator);
+}